@@ -1,4 +1,11 @@
 check_function_exists(mkstemp HAVE_MKSTEMP)
+find_package(Threads)
+# CachedCoordFunction, AlbertaGrid's parallel mesh traversal and the
+# asynchronous VTKSequenceWriter use std::thread in installed headers,
+# so every user of dune-grid has to link the thread library.
+if(CMAKE_THREAD_LIBS_INIT)
+  dune_register_package_flags(LIBRARIES "${CMAKE_THREAD_LIBS_INIT}")
+endif(CMAKE_THREAD_LIBS_INIT)
 
 include(GridType)
 
@@ -555,7 +555,10 @@ namespace Dune
     // unset up2Dat status, if leafbegin is called then this status is updated
     leafMarkerVector_.clear();
 
+    // ALBERTA counts the leaf entities, so only level sizes need iteration
     sizeCache_.reset();
+    for( int codim = 0; codim <= dimension; ++codim )
+      sizeCache_.setLeafSize( codim, mesh_.size( codim ) );
 
     // update index sets (if they exist)
     if( leafIndexSet_ != 0 )
@@ -171,6 +171,9 @@ namespace Dune
       static Stack &stack ();
 
       InstancePtr instance_;
+
+      // shared by all threads, never reference counted
+      static Instance null_;
     };
 
 
@@ -203,11 +206,17 @@ namespace Dune
     // ElementInfo::Stack
     // ------------------
 
+    /* free list of instances
+     *
+     * Each thread owns its own stack, so that several threads may traverse
+     * disjoint parts of the mesh concurrently. An instance may be released
+     * on a different thread than the one it was allocated on; it is then
+     * reused by the releasing thread.
+     */
     template< int dim >
     class ElementInfo< dim >::Stack
     {
       InstancePtr top_;
-      Instance null_;
 
     public:
       Stack ();
@@ -215,7 +224,6 @@ namespace Dune
 
       InstancePtr allocate ();
       void release ( InstancePtr &p );
-      InstancePtr null ();
     };
 
 
@@ -319,7 +327,6 @@ namespace Dune
     {
       instance_ = stack().allocate();
       instance_->parent() = null();
-      ++(instance_->parent()->refCount);
 
       addReference();
 
@@ -340,7 +347,6 @@ namespace Dune
     {
       instance_ = stack().allocate();
       instance_->parent() = null();
-      ++(instance_->parent()->refCount);
 
       addReference();
 
@@ -752,7 +758,6 @@ namespace Dune
     {
       InstancePtr instance = stack().allocate();
       instance->parent() = null();
-      ++(instance->parent()->refCount);
 
       instance->elInfo.mesh = mesh;
       instance->elInfo.macro_el = NULL;
@@ -772,7 +777,6 @@ namespace Dune
     {
       InstancePtr instance = stack().allocate();
       instance->parent() = null();
-      ++(instance->parent()->refCount);
 
       instance->elInfo = elInfo;
       return ElementInfo< dim >( instance );
@@ -814,7 +818,8 @@ namespace Dune
     template< int dim >
     inline void ElementInfo< dim >::addReference () const
     {
-      ++(instance_->refCount);
+      if( instance_ != null() )
+        ++(instance_->refCount);
     }
 
 
@@ -824,8 +829,8 @@ namespace Dune
       // short-circuit for rvalues that have been drained as argument to a move operation
       if ( !instance_ )
         return;
-      // this loop breaks when instance becomes null()
-      for( InstancePtr instance = instance_; --(instance->refCount) == 0; )
+      // this loop breaks at the first instance still referenced or at null()
+      for( InstancePtr instance = instance_; (instance != null()) && (--(instance->refCount) == 0); )
       {
         const InstancePtr parent = instance->parent();
         stack().release( instance );
@@ -838,7 +843,7 @@ namespace Dune
     inline typename ElementInfo< dim >::InstancePtr
     ElementInfo< dim >::null ()
     {
-      return stack().null();
+      return &null_;
     }
 
 
@@ -846,11 +851,16 @@ namespace Dune
     inline typename ElementInfo< dim >::Stack &
     ElementInfo< dim >::stack ()
     {
-      static Stack s;
+      static thread_local Stack s;
       return s;
     }
 
 
+    // zero initialization yields el == NULL
+    template< int dim >
+    typename ElementInfo< dim >::Instance ElementInfo< dim >::null_;
+
+
 
     // Implementation of ElementInfo::Stack
     // ------------------------------------
@@ -858,11 +868,7 @@ namespace Dune
     template< int dim >
     inline ElementInfo< dim >::Stack::Stack ()
       : top_( 0 )
-    {
-      null_.elInfo.el = NULL;
-      null_.refCount = 1;
-      null_.parent() = 0;
-    }
+    {}
 
 
     template< int dim >
@@ -899,14 +905,6 @@ namespace Dune
       top_ = p;
     }
 
-
-    template< int dim >
-    inline typename ElementInfo< dim >::InstancePtr
-    ElementInfo< dim >::Stack::null ()
-    {
-      return &null_;
-    }
-
   } // namespace Alberta
 
 } // namespace Dune
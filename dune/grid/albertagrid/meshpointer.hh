@@ -8,8 +8,12 @@
  *  \brief  provides a wrapper for ALBERTA's mesh structure
  */
 
+#include <algorithm>
+#include <exception>
 #include <limits>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <dune/grid/albertagrid/misc.hh>
 #include <dune/grid/albertagrid/elementinfo.hh>
@@ -121,11 +125,88 @@ namespace Dune
       void leafTraverse ( Functor &functor,
                           typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
 
+      // traverse the macro elements on functors.size() threads
+      // params:  functors  - one functor per thread, called concurrently
+      //          fillFlags - fill flags for the element infos
+      //
+      // notes: - the macro elements are split into contiguous ranges holding
+      //          the same number of macro elements; functors[ i ] visits the
+      //          i-th range
+      //        - the functors must not modify the mesh
+      template< class Functor >
+      void parallelHierarchicTraverse ( std::vector< Functor > &functors,
+                                        typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      template< class Functor >
+      void parallelLeafTraverse ( std::vector< Functor > &functors,
+                                  typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      // traverse the macro element ranges of a partition on functors.size() threads
+      // params:  functors  - one functor per range, called concurrently
+      //          partition - functors.size()+1 range bounds, e.g., obtained
+      //                      from partition( functors.size(), leafOnly )
+      //          fillFlags - fill flags for the element infos
+      template< class Functor >
+      void parallelHierarchicTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                                        typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      template< class Functor >
+      void parallelLeafTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                                  typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      // traverse on numThreads default constructed functors and merge them
+      // into functor by calling reduce( functor, part ) in the order of the
+      // macro elements
+      //
+      // notes: - for a fixed number of threads the result is deterministic
+      template< class Functor, class Reduction >
+      void parallelHierarchicTraverse ( Functor &functor, unsigned int numThreads, Reduction reduce,
+                                        typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      template< class Functor, class Reduction >
+      void parallelLeafTraverse ( Functor &functor, unsigned int numThreads, Reduction reduce,
+                                  typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      // same as above, using one thread per range of partition
+      template< class Functor, class Reduction >
+      void parallelHierarchicTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                                        typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      template< class Functor, class Reduction >
+      void parallelLeafTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                                  typename FillFlags::Flags fillFlags = FillFlags::standard ) const;
+
+      // split the macro elements into numParts contiguous ranges holding the
+      // same number of macro elements; range i is [ result[ i ], result[ i+1 ] )
+      std::vector< int > partition ( std::size_t numParts ) const;
+
+      // split the macro elements into numParts contiguous ranges of similar
+      // weight, counting the leaf elements or all elements below each macro
+      // element; range i is [ result[ i ], result[ i+1 ] )
+      //
+      // notes: - this walks all element trees; compute the partition once
+      //          after each refine or coarsen and pass it to the traversals
+      std::vector< int > partition ( std::size_t numParts, bool leafOnly ) const;
+
       bool coarsen ( typename FillFlags::Flags fillFlags = FillFlags::nothing );
 
       bool refine ( typename FillFlags::Flags fillFlags = FillFlags::nothing );
 
     private:
+      template< bool leafOnly, class Functor >
+      void parallelTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                              typename FillFlags::Flags fillFlags ) const;
+
+      template< bool leafOnly, class Functor, class Reduction >
+      void parallelTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                              typename FillFlags::Flags fillFlags ) const;
+
+      template< bool leafOnly, class Functor >
+      void traverseRange ( Functor &functor, int begin, int end,
+                           typename FillFlags::Flags fillFlags ) const;
+
+      static long countElements ( const Element *element, bool leafOnly );
+
       static ALBERTA NODE_PROJECTION *
       initNodeProjection ( Mesh *mesh, ALBERTA MACRO_EL *macroElement, int n );
       template< class ProjectionProvider >
@@ -392,6 +473,224 @@ namespace Dune
     }
 
 
+    template< int dim >
+    template< class Functor >
+    inline void MeshPointer< dim >
+    ::parallelHierarchicTraverse ( std::vector< Functor > &functors,
+                                   typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< false >( functors, partition( functors.size() ), fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor >
+    inline void MeshPointer< dim >
+    ::parallelLeafTraverse ( std::vector< Functor > &functors,
+                             typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< true >( functors, partition( functors.size() ), fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor >
+    inline void MeshPointer< dim >
+    ::parallelHierarchicTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                                   typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< false >( functors, partition, fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor >
+    inline void MeshPointer< dim >
+    ::parallelLeafTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                             typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< true >( functors, partition, fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor, class Reduction >
+    inline void MeshPointer< dim >
+    ::parallelHierarchicTraverse ( Functor &functor, unsigned int numThreads, Reduction reduce,
+                                   typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< false >( functor, partition( std::max( numThreads, 1u ) ), reduce, fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor, class Reduction >
+    inline void MeshPointer< dim >
+    ::parallelLeafTraverse ( Functor &functor, unsigned int numThreads, Reduction reduce,
+                             typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< true >( functor, partition( std::max( numThreads, 1u ) ), reduce, fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor, class Reduction >
+    inline void MeshPointer< dim >
+    ::parallelHierarchicTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                                   typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< false >( functor, partition, reduce, fillFlags );
+    }
+
+
+    template< int dim >
+    template< class Functor, class Reduction >
+    inline void MeshPointer< dim >
+    ::parallelLeafTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                             typename FillFlags::Flags fillFlags ) const
+    {
+      parallelTraverse< true >( functor, partition, reduce, fillFlags );
+    }
+
+
+    template< int dim >
+    inline std::vector< int >
+    MeshPointer< dim >::partition ( std::size_t numParts ) const
+    {
+      const long numMacro = numMacroElements();
+      std::vector< int > bounds( numParts+1 );
+      for( std::size_t part = 0; part <= numParts; ++part )
+        bounds[ part ] = int( (numMacro * long( part )) / long( numParts ) );
+      return bounds;
+    }
+
+
+    template< int dim >
+    inline std::vector< int >
+    MeshPointer< dim >::partition ( std::size_t numParts, bool leafOnly ) const
+    {
+      const int numMacro = numMacroElements();
+      std::vector< long > weight( numMacro );
+      long total = 0;
+      for( int i = 0; i < numMacro; ++i )
+      {
+        weight[ i ] = countElements( mesh_->macro_els[ i ].el, leafOnly );
+        total += weight[ i ];
+      }
+
+      // range k starts at the first macro element after k/numParts of the weight
+      std::vector< int > bounds( numParts+1, numMacro );
+      bounds[ 0 ] = 0;
+      std::size_t part = 1;
+      long sum = 0;
+      for( int i = 0; i < numMacro; ++i )
+      {
+        for( ; (part < numParts) && (double( sum ) * numParts >= double( part ) * total); ++part )
+          bounds[ part ] = i;
+        sum += weight[ i ];
+      }
+      return bounds;
+    }
+
+
+    template< int dim >
+    template< bool leafOnly, class Functor >
+    inline void MeshPointer< dim >
+    ::parallelTraverse ( std::vector< Functor > &functors, const std::vector< int > &partition,
+                         typename FillFlags::Flags fillFlags ) const
+    {
+      const std::size_t numParts = functors.size();
+      if( numParts == 0 )
+        return;
+      if( partition.size() != numParts+1 )
+        DUNE_THROW( AlbertaError, "Partition has " << partition.size() << " range bounds for " << numParts << " functors." );
+
+      std::vector< std::exception_ptr > errors( numParts );
+      const auto traverse = [ this, &functors, &partition, &errors, fillFlags ] ( std::size_t i ) {
+          try
+          {
+            traverseRange< leafOnly >( functors[ i ], partition[ i ], partition[ i+1 ], fillFlags );
+          }
+          catch( ... )
+          {
+            errors[ i ] = std::current_exception();
+          }
+        };
+
+      // threads that were started have to be joined, even if starting another one fails
+      std::vector< std::thread > threads;
+      threads.reserve( numParts-1 );
+      try
+      {
+        for( std::size_t i = 1; i < numParts; ++i )
+          threads.push_back( std::thread( traverse, i ) );
+      }
+      catch( ... )
+      {
+        for( std::size_t i = 0; i < threads.size(); ++i )
+          threads[ i ].join();
+        throw;
+      }
+
+      // the calling thread traverses the first range
+      traverse( 0 );
+
+      for( std::size_t i = 0; i < threads.size(); ++i )
+        threads[ i ].join();
+      for( std::size_t i = 0; i < numParts; ++i )
+      {
+        if( errors[ i ] )
+          std::rethrow_exception( errors[ i ] );
+      }
+    }
+
+
+    template< int dim >
+    template< bool leafOnly, class Functor, class Reduction >
+    inline void MeshPointer< dim >
+    ::parallelTraverse ( Functor &functor, const std::vector< int > &partition, Reduction reduce,
+                         typename FillFlags::Flags fillFlags ) const
+    {
+      // a partition needs at least two range bounds
+      if( partition.size() < 2 )
+        DUNE_THROW( AlbertaError, "Partition has " << partition.size() << " range bounds, at least 2 are required." );
+
+      // each range starts from a default constructed functor, so that the
+      // state of functor is counted only once
+      std::vector< Functor > functors( partition.size() - 1 );
+      parallelTraverse< leafOnly >( functors, partition, fillFlags );
+      for( std::size_t i = 0; i < functors.size(); ++i )
+        reduce( functor, functors[ i ] );
+    }
+
+
+    template< int dim >
+    template< bool leafOnly, class Functor >
+    inline void MeshPointer< dim >
+    ::traverseRange ( Functor &functor, int begin, int end,
+                      typename FillFlags::Flags fillFlags ) const
+    {
+      for( int i = begin; i < end; ++i )
+      {
+        const MacroElement &macroElement = static_cast< const MacroElement & >( mesh_->macro_els[ i ] );
+        const ElementInfo info( *this, macroElement, fillFlags );
+        if( leafOnly )
+          info.leafTraverse( functor );
+        else
+          info.hierarchicTraverse( functor );
+      }
+    }
+
+
+    template< int dim >
+    inline long MeshPointer< dim >::countElements ( const Element *element, bool leafOnly )
+    {
+      if( element->child[ 0 ] == NULL )
+        return 1;
+      return (leafOnly ? 0 : 1) + countElements( element->child[ 0 ], leafOnly ) + countElements( element->child[ 1 ], leafOnly );
+    }
+
+
     template< int dim >
     inline bool MeshPointer< dim >::coarsen ( typename FillFlags::Flags fillFlags )
     {
@@ -17,6 +17,7 @@
 #include <dune/grid/alugrid/common/declaration.hh>
 #include <dune/grid/alugrid/common/defaultindexsets.hh>
 #include <dune/grid/common/sizecache.hh>
+#include <dune/grid/common/commprofiler.hh>
 #include <dune/grid/common/defaultgridview.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
@@ -849,6 +849,9 @@ namespace Dune
 #if ALU2DGRID_PARALLEL
     if( comm_.size() > 1 )
     {
+      // all codimensions are handled in one step, only the total time is profiled
+      CommProfileScope profile( "ALU2dGrid", iftype, -1 );
+      profile.phase( CommProfileData::exchangePhase );
       rankManager_.communicate(data,iftype,dir,level);
     }
 #endif
@@ -865,6 +868,9 @@ namespace Dune
     // only communicate, if number of processes is larger than 1
     if( comm_.size() > 1 )
     {
+      // all codimensions are handled in one step, only the total time is profiled
+      CommProfileScope profile( "ALU2dGrid", iftype, -1 );
+      profile.phase( CommProfileData::exchangePhase );
       rankManager_.communicate(data,iftype,dir);
     }
 #endif
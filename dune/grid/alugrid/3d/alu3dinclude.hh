@@ -25,6 +25,7 @@
 // all methods and classes of the ALUGrid are defined in the namespace
 #define ALU3DSPACE ALUGridSpace ::
 
+#include <dune/common/timer.hh>
 #include <dune/common/parallel/mpicollectivecommunication.hh>
 
 #include <dune/grid/alugrid/common/checkparallel.hh>
@@ -325,28 +326,78 @@ namespace Dune
 
   //! contains list of vertices of one level
   //! needed for VertexLevelIterator
+  //!
+  //! During adaptation the list can be updated incrementally from the
+  //! refinement callbacks instead of being rebuilt on the next access.
   template< class Comm >
   struct ALU3dGridLeafVertexList
   {
     // level vertex iterator list
     typedef typename ALU3dBasicImplTraits< Comm >::VertexType VertexType;
+    typedef typename ALU3dBasicImplTraits< Comm >::HElementType HElementType;
     typedef std::pair< VertexType *, int > ItemType;
     typedef std::vector< ItemType > VertexListType;
     typedef typename VertexListType::iterator IteratorType;
 
+    //! counters for the maintenance of the list
+    struct Statistics
+    {
+      Statistics ()
+        : rebuilds( 0 ), rebuildTime( 0 ), updates( 0 ),
+          refinedElements( 0 ), insertedVertices( 0 )
+      {}
+
+      //! number of full rebuilds
+      unsigned long rebuilds;
+      //! accumulated time spent in full rebuilds (in seconds)
+      double rebuildTime;
+      //! number of adaptation cycles handled incrementally
+      unsigned long updates;
+      //! number of refined elements processed incrementally
+      unsigned long refinedElements;
+      //! number of vertices inserted incrementally
+      unsigned long insertedVertices;
+    };
+
     ALU3dGridLeafVertexList ()
-      : up2Date_( false )
+      : up2Date_( false ), tracking_( false )
     {}
 
     size_t size () const { return vertexList_.size(); }
 
     bool up2Date () const { return up2Date_;  }
-    void unsetUp2Date ()  { up2Date_ = false; }
+    void unsetUp2Date ()  { up2Date_ = false; tracking_ = false; }
 
     // make grid walkthrough and calc global size
     template <class GridType>
     void setupVxList (const GridType & grid);
 
+    //! start tracking an adaptation cycle, if the list is up to date
+    void beginAdapt ( bool incremental )
+    {
+      tracking_ = (up2Date_ && incremental);
+    }
+
+    //! insert the vertices of the children of a refined element
+    template< ALU3dGridElementType elType >
+    void postRefinement ( HElementType &father );
+
+    //! coarsening removes vertices, so the list is rebuilt on next access
+    void preCoarsening () { tracking_ = false; }
+
+    //! end adaptation cycle, keeps the list only if all changes were tracked
+    void finishAdapt ()
+    {
+      if( tracking_ )
+        ++statistics_.updates;
+      else
+        up2Date_ = false;
+      tracking_ = false;
+    }
+
+    //! return the counters for the maintenance of the list
+    const Statistics &statistics () const { return statistics_; }
+
     IteratorType begin () { return vertexList_.begin(); }
     IteratorType end   () { return vertexList_.end(); }
 
@@ -365,7 +416,42 @@ namespace Dune
     }
   private:
     bool up2Date_;
+    bool tracking_;
     VertexListType vertexList_;
+    Statistics statistics_;
+  };
+
+
+
+  //! contains list of interior leaf elements
+  //! needed for the interior partition LeafIterator
+  template< class Comm >
+  struct ALU3dGridLeafElementList
+  {
+    // leaf element iterator list
+    typedef typename ALU3dBasicImplTraits< Comm >::HElementType HElementType;
+    typedef std::vector< HElementType * > ElementListType;
+    typedef typename ElementListType::const_iterator IteratorType;
+
+    ALU3dGridLeafElementList ()
+      : up2Date_( false )
+    {}
+
+    size_t size () const { return elementList_.size(); }
+
+    bool up2Date () const { return up2Date_;  }
+    void unsetUp2Date ()  { up2Date_ = false; }
+
+    // make grid walkthrough and collect interior leaf elements
+    template <class GridType>
+    void setupElementList (const GridType & grid);
+
+    IteratorType begin () const { return elementList_.begin(); }
+    IteratorType end   () const { return elementList_.end(); }
+
+  private:
+    bool up2Date_;
+    ElementListType elementList_;
   };
 
 
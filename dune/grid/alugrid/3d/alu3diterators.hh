@@ -289,6 +289,48 @@ namespace ALUGridSpace
     }
   };
 
+  // the interior leaf element iterator runs over the leaf element list
+  // cached by the grid; it is not derived from IteratorWrapperInterface, so
+  // all calls are statically dispatched and begin() does not allocate
+  template< class Comm >
+  class ALU3dGridLeafIteratorWrapper< 0, Dune::Interior_Partition, Comm >
+  {
+    typedef typename IteratorElType< 0, Comm >::ElType ElType;
+    typedef typename IteratorElType< 0, Comm >::HBndSegType HBndSegType;
+    typedef Dune::ALU3dGridLeafElementList< Comm > ElementListType;
+    typedef typename ElementListType::IteratorType IteratorType;
+
+  public:
+    typedef typename IteratorElType< 0, Comm >::val_t val_t;
+
+  private:
+    IteratorType begin_, end_, it_;
+    int size_;
+    mutable val_t elem_;
+
+  public:
+    // constructor creating Iterator
+    template< class GridImp >
+    ALU3dGridLeafIteratorWrapper ( const GridImp &grid, int level, const int links )
+      : begin_( grid.getLeafElementList().begin() ),
+        end_( grid.getLeafElementList().end() ),
+        it_( begin_ ),
+        size_( grid.getLeafElementList().size() ),
+        elem_( (ElType *) 0, (HBndSegType *) 0 )
+    {}
+
+    int size  ()    { return size_; }
+    void next ()    { ++it_; }
+    void first()    { it_ = begin_; }
+    int done () const { return (it_ == end_); }
+    val_t & item () const
+    {
+      assert( ! done () );
+      elem_.first = *it_;
+      return elem_;
+    }
+  };
+
   template< class ElType, PartitionIteratorType pitype, class Comm >
   struct LeafStopRule
   {
@@ -628,6 +628,8 @@ namespace ALUGridSpace
     //! restrict data for elements
     int preCoarsening ( HElementType & father )
     {
+      grid_.leafVertexListPreCoarsening( father );
+
       realFather_.setElement( father );
       rp_.preCoarsening( reFather_ );
 
@@ -639,6 +641,8 @@ namespace ALUGridSpace
     //! prolong data for elements
     int postRefinement ( HElementType & father )
     {
+      grid_.leafVertexListPostRefinement( father );
+
       realFather_.setElement( father );
       rp_.postRefinement( reFather_ );
 
@@ -701,6 +705,58 @@ namespace ALUGridSpace
     }
   };
 
+  // this class keeps the leaf vertex list of the grid up to date during
+  // adaptation without data handle and forwards the callbacks to the
+  // global id set, if one exists
+  template< class GridType >
+  class AdaptRestrictProlongLeafVertexList
+    : public AdaptRestrictProlongType
+  {
+    GridType & grid_;
+    AdaptRestrictProlongType *next_;
+
+    typedef typename GridType::MPICommunicatorType Comm;
+
+    typedef Dune::ALU3dImplTraits< GridType::elementType, Comm > ImplTraits;
+    typedef typename ImplTraits::HElementType HElementType;
+    typedef typename ImplTraits::HBndSegType HBndSegType;
+
+  public:
+    //! Constructor
+    AdaptRestrictProlongLeafVertexList ( GridType &grid, AdaptRestrictProlongType *next )
+      : grid_( grid ),
+        next_( next )
+    {}
+
+    virtual ~AdaptRestrictProlongLeafVertexList () {}
+
+    //! coarsening invalidates the leaf vertex list
+    int preCoarsening ( HElementType & father )
+    {
+      grid_.leafVertexListPreCoarsening( father );
+      return (next_ ? next_->preCoarsening( father ) : 0);
+    }
+
+    //! insert vertices of the new children
+    int postRefinement ( HElementType & father )
+    {
+      grid_.leafVertexListPostRefinement( father );
+      return (next_ ? next_->postRefinement( father ) : 0);
+    }
+
+    //! restrict data for ghost elements
+    int preCoarsening ( HBndSegType & ghost )
+    {
+      return (next_ ? next_->preCoarsening( ghost ) : 0);
+    }
+
+    //! prolong data for ghost elements
+    int postRefinement ( HBndSegType & ghost )
+    {
+      return (next_ ? next_->postRefinement( ghost ) : 0);
+    }
+  };
+
   // this class is for counting the tree depth of the
   // element when unpacking data from load balance
   template <class GridType , class DataHandleType>
@@ -19,6 +19,7 @@
 #include <dune/grid/alugrid/common/defaultindexsets.hh>
 #include <dune/grid/common/sizecache.hh>
 #include <dune/grid/alugrid/common/intersectioniteratorwrapper.hh>
+#include <dune/grid/common/commprofiler.hh>
 #include <dune/grid/common/datahandleif.hh>
 #include <dune/grid/common/defaultgridview.hh>
 
@@ -563,6 +564,7 @@ namespace Dune
   protected:
     typedef ALU3dGridVertexList< Comm > VertexListType;
     typedef ALU3dGridLeafVertexList< Comm > LeafVertexListType;
+    typedef ALU3dGridLeafElementList< Comm > LeafElementListType;
 
     //! Constructor which reads an ALU3dGrid Macro Triang file
     //! or given GridFile
@@ -921,6 +923,30 @@ namespace Dune
       return leafVertexList_;
     }
 
+    //! counters for the maintenance of the leaf vertex list
+    const typename LeafVertexListType::Statistics &leafVertexListStatistics () const
+    {
+      return leafVertexList_.statistics();
+    }
+
+    // update leaf vertex list, for internal use in adaptation callbacks only
+    void leafVertexListPostRefinement ( typename ALU3dImplTraits< elType, Comm >::HElementType &father ) const
+    {
+      leafVertexList_.template postRefinement< elType >( father );
+    }
+
+    // update leaf vertex list, for internal use in adaptation callbacks only
+    void leafVertexListPreCoarsening ( typename ALU3dImplTraits< elType, Comm >::HElementType &father ) const
+    {
+      leafVertexList_.preCoarsening();
+    }
+
+    const LeafElementListType & getLeafElementList() const
+    {
+      if( !leafElementList_.up2Date() ) leafElementList_.setupElementList(*this);
+      return leafElementList_;
+    }
+
     int getLevelOfLeafVertex ( const typename ALU3dImplTraits< elType, Comm >::VertexType &vertex ) const
     {
       assert( leafVertexList_.up2Date() );
@@ -1077,6 +1103,8 @@ namespace Dune
 
     mutable LeafVertexListType leafVertexList_;
 
+    mutable LeafElementListType leafElementList_;
+
     // the type of our size cache
     typedef SizeCache<MyType> SizeCacheType;
     SizeCacheType * sizeCache_;
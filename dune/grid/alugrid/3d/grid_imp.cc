@@ -103,6 +103,8 @@ namespace Dune
   void ALU3dGridLeafVertexList< Comm >::
   setupVxList(const GridType & grid)
   {
+    Dune::Timer timer;
+
     // iterates over grid elements of given level and adds all vertices to
     // given list
     enum { codim = 3 };
@@ -179,6 +181,80 @@ namespace Dune
     // make sure that the found number of vertices equals to stored ones
     //assert( count == (int)vxList.size() );
     up2Date_ = true;
+    tracking_ = false;
+
+    ++statistics_.rebuilds;
+    statistics_.rebuildTime += timer.elapsed();
+  }
+
+
+  template< class Comm >
+  template< ALU3dGridElementType elType >
+  alu_inline
+  void ALU3dGridLeafVertexList< Comm >::
+  postRefinement ( HElementType &father )
+  {
+    if( !tracking_ ) return;
+
+    typedef ALU3dImplTraits< elType, Comm > ImplTraits;
+    typedef typename ImplTraits::IMPLElementType IMPLElementType;
+
+    enum { nVx = ElementTopologyMapping < elType > :: numVertices };
+
+    ++statistics_.refinedElements;
+
+    // the corners of the father stay in the list, only the level of
+    // vertices shared with the children changes (max level, see above)
+    for( HElementType *son = father.down(); son; son = son->next() )
+    {
+      IMPLElementType &elem = static_cast< IMPLElementType & >( *son );
+      const int level = elem.level();
+
+      for( int i = 0; i < nVx; ++i )
+      {
+        VertexType *vx = elem.myvertex( i );
+        assert( vx );
+
+        // insert only interior and border vertices
+        if( vx->isGhost() ) continue;
+
+        const size_t idx = vx->getIndex();
+        if( idx >= vertexList_.size() )
+          vertexList_.resize( idx+1, ItemType( (VertexType *)0, -1 ) );
+
+        ItemType &vxpair = vertexList_[ idx ];
+        if( vxpair.first == 0 )
+        {
+          vxpair.first  = vx;
+          vxpair.second = level;
+          ++statistics_.insertedVertices;
+        }
+        else if( vxpair.second < level )
+          vxpair.second = level;
+      }
+    }
+  }
+
+
+
+  template< class Comm >
+  template< class GridType >
+  alu_inline
+  void ALU3dGridLeafElementList< Comm >::
+  setupElementList(const GridType & grid)
+  {
+    // ALU's leaf iterator visits all non-ghost leaf elements, which
+    // form the interior partition
+    typedef ALU3DSPACE LeafIterator< HElementType > IteratorType;
+
+    elementList_.clear();
+    elementList_.reserve( grid.size( 0 ) );
+
+    IteratorType it( grid.myGrid() );
+    for( it->first(); !it->done(); it->next() )
+      elementList_.push_back( &it->item() );
+
+    up2Date_ = true;
   }
 
 
@@ -368,7 +444,9 @@ namespace Dune
 
     // unset up2date before recalculating the index sets,
     // becasue they will use this feature
-    leafVertexList_.unsetUp2Date();
+    // the leaf vertex list survives if all changes were tracked
+    leafVertexList_.finishAdapt();
+    leafElementList_.unsetUp2Date();
     for(size_t i=0; i<MAXL; ++i)
     {
       vertexList_[i].unsetUp2Date();
@@ -485,6 +563,17 @@ namespace Dune
       int newElements = std::max( actChunk , defaultChunk );
 
       globalIdSet_->setChunkSize( newElements );
+    }
+
+    // in serial runs the leaf vertex list is updated during adaptation
+    leafVertexList_.beginAdapt( comm().size() == 1 );
+    if( leafVertexList_.up2Date() && (comm().size() == 1) )
+    {
+      ALU3DSPACE AdaptRestrictProlongLeafVertexList< MyType > rp( *this, globalIdSet_ );
+      ref = myGrid().duneAdapt( rp ); // adapt grid
+    }
+    else if(globalIdSet_)
+    {
       ref = myGrid().duneAdapt(*globalIdSet_); // adapt grid
     }
     else
@@ -506,6 +595,8 @@ namespace Dune
       // notify that postAdapt must be called
       lockPostAdapt_ = true;
     }
+    else
+      leafVertexList_.finishAdapt();
     return ref;
   }
 
@@ -353,6 +353,9 @@ namespace Dune
     // true if at least one element was marked for coarsening
     bool mightCoarse = preAdapt();
 
+    // in serial runs the leaf vertex list is updated during adaptation
+    leafVertexList_.beginAdapt( comm().size() == 1 );
+
     bool refined = false ;
     if(globalIdSet_)
     {
@@ -387,6 +390,8 @@ namespace Dune
       // no need to call postAdapt here, because markers
       // are cleand during refinement callback
     }
+    else
+      leafVertexList_.finishAdapt();
 
     return refined;
   }
@@ -606,6 +611,11 @@ namespace Dune
                       GatherScatterType &faceData, GatherScatterType &elementData,
                       InterfaceType iftype, CommunicationDirection dir )
     {
+      // ALUGrid gathers, transfers and scatters all codimensions in one
+      // step inside the library, so only the total time can be profiled
+      CommProfileScope profile( "ALU3dGrid", iftype, -1 );
+      profile.phase( CommProfileData::exchangePhase );
+
       // check interface types
       if( (iftype == Overlap_OverlapFront_Interface) || (iftype == Overlap_All_Interface) )
       {
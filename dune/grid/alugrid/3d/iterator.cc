@@ -30,7 +30,7 @@ namespace Dune {
       , iter_ (0)
   {
     const GridImp& grid = factory.grid();
-    iter_  = new IteratorType ( grid, level_, grid.nlinks() );
+    iter_  = new (&iterStorage_) IteratorType ( grid, level_, grid.nlinks() );
     assert( iter_ );
     this->firstItem( grid, *this, level_);
   }
@@ -70,7 +70,7 @@ namespace Dune {
     this->done();
     if(iter_)
     {
-      delete iter_;
+      iter_->~IteratorType();
       iter_ = 0;
     }
   }
@@ -84,7 +84,7 @@ namespace Dune {
     level_ = org.level_;
     if( org.iter_ )
     {
-      iter_ = new IteratorType ( *(org.iter_) );
+      iter_ = new (&iterStorage_) IteratorType ( *(org.iter_) );
       assert( iter_ );
       if(!(iter_->done()))
       {
@@ -158,7 +158,7 @@ namespace Dune {
   {
     const GridImp& grid = factory.grid();
     // create interior iterator
-    iter_ = new IteratorType ( grid , level , grid.nlinks() );
+    iter_ = new (&iterStorage_) IteratorType ( grid , level , grid.nlinks() );
     assert( iter_ );
     // -1 to identify as leaf iterator
     this->firstItem(grid,*this,-1);
@@ -189,7 +189,7 @@ namespace Dune {
     this->done();
     if(iter_)
     {
-      delete iter_;
+      iter_->~IteratorType();
       iter_ = 0;
     }
   }
@@ -214,7 +214,7 @@ namespace Dune {
     if( org.iter_ )
     {
       assert( !org.iter_->done() );
-      iter_ = new IteratorType ( *(org.iter_) );
+      iter_ = new (&iterStorage_) IteratorType ( *(org.iter_) );
       assert( iter_ );
 
       if( !(iter_->done() ))
@@ -5,6 +5,8 @@
 #define DUNE_ALU3DGRIDITERATOR_HH
 
 // System includes
+#include <new>
+#include <type_traits>
 
 // Dune includes
 #include <dune/grid/common/grid.hh>
@@ -441,11 +443,12 @@ namespace Dune {
     template <class GridImp, class IteratorImp>
     void firstItem(const GridImp & grid, IteratorImp & it, int level )
     {
+      // qualified calls avoid the virtual dispatch of the wrapper interface
       InternalIteratorType & iter = it.internalIterator();
-      iter.first();
-      if( ! iter.done() )
+      iter.InternalIteratorType::first();
+      if( ! iter.InternalIteratorType::done() )
       {
-        assert( iter.size() > 0 );
+        assert( iter.InternalIteratorType::size() > 0 );
         setItem(grid,it,iter,level);
       }
       else
@@ -459,7 +462,7 @@ namespace Dune {
     void setItem (const GridImp & grid, IteratorImp & it, InternalIteratorType & iter, int level)
     {
       enum { codim = IteratorImp :: codimension };
-      val_t & item = iter.item();
+      val_t & item = iter.InternalIteratorType::item();
       assert( item.first || item.second );
       if( item.first )
       {
@@ -477,9 +480,9 @@ namespace Dune {
       // if iter_ is zero, then end iterator
       InternalIteratorType & iter = it.internalIterator();
 
-      iter.next();
+      iter.InternalIteratorType::next();
 
-      if(iter.done())
+      if(iter.InternalIteratorType::done())
       {
         it.removeIter();
         return ;
@@ -558,9 +561,12 @@ namespace Dune {
     // actual level
     int level_;
 
-    // the internal iterator
+    // the internal iterator (points to iterStorage_ or is null)
     IteratorType * iter_ ;
 
+    // storage for the internal iterator, so begin iterators do not allocate
+    typename std::aligned_storage< sizeof( IteratorType ), std::alignment_of< IteratorType >::value >::type iterStorage_;
+
     // deletes iter_
     void removeIter ();
 
@@ -628,9 +634,12 @@ namespace Dune {
     ThisType & operator = (const ThisType & org);
 
   private:
-    // the internal iterator
+    // the internal iterator (points to iterStorage_ or is null)
     IteratorType * iter_;
 
+    // storage for the internal iterator, so begin iterators do not allocate
+    typename std::aligned_storage< sizeof( IteratorType ), std::alignment_of< IteratorType >::value >::type iterStorage_;
+
     // max level for iteration
     int walkLevel_ ;
 
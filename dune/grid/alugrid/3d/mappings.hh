@@ -4,6 +4,7 @@
 #define DUNE_ALU3DGRIDMAPPINGS_HH
 
 // System includes
+#include <algorithm>
 #include <limits>
 #include <cmath>
 
@@ -71,6 +72,35 @@ namespace Dune {
                     coord_t&) const ;
     void world2map (const coord_t&, coord_t&) ;
 
+    /** \name Batched evaluation
+     *
+     *  The following methods evaluate the mapping for n points at once. The
+     *  points are passed in SoA layout, i.e., the i-th point is
+     *  (x[i], y[i], z[i]). The loops over the points are free of branches
+     *  and of dependencies between points, so the compiler can vectorize
+     *  them. For affine mappings the constant Jacobian is computed once
+     *  when the mapping is built.
+     *  \{
+     */
+
+    //! map n local points to world coordinates
+    void map2world (const int n, const alu3d_ctype *x, const alu3d_ctype *y, const alu3d_ctype *z,
+                    alu3d_ctype *wx, alu3d_ctype *wy, alu3d_ctype *wz) const ;
+
+    /** \brief evaluate the inverse transposed Jacobians in n local points
+     *
+     *  The entry (r,c) of the i-th matrix is stored in jit[ (3*r+c)*n + i ].
+     *  If det is not null, the determinants are stored in det[ i ].
+     */
+    void jacobianInverseTransposed (const int n, const alu3d_ctype *x, const alu3d_ctype *y, const alu3d_ctype *z,
+                                    alu3d_ctype *jit, alu3d_ctype *det = 0) const ;
+
+    //! map n world points to local coordinates
+    void world2map (const int n, const alu3d_ctype *wx, const alu3d_ctype *wy, const alu3d_ctype *wz,
+                    alu3d_ctype *x, alu3d_ctype *y, alu3d_ctype *z) const ;
+
+    /** \} */
+
     template <class vector_t>
     void buildMapping(const vector_t&, const vector_t&,
                       const vector_t&, const vector_t&,
@@ -120,6 +150,13 @@ namespace Dune {
     void negativeNormal(const coord2_t&, coord3_t&) const ;
     void negativeNormal(const alu3d_ctype, const alu3d_ctype, coord3_t&) const;
 
+    /** \brief calculate the normals in n local points (SoA layout)
+     *
+     *  The i-th point is (x[i], y[i]); its normal is (nx[i], ny[i], nz[i]).
+     */
+    void normal(const int n, const alu3d_ctype *x, const alu3d_ctype *y,
+                alu3d_ctype *nx, alu3d_ctype *ny, alu3d_ctype *nz) const;
+
   public:
     // builds _b and _n, called from the constructors
     // public because also used in faceutility
@@ -208,6 +245,13 @@ namespace Dune {
     void map2world(const coord2_t&, coord3_t&) const ;
     void map2world(const alu3d_ctype ,const alu3d_ctype , coord3_t&) const ;
 
+    // maps n local points to global coordinates (SoA layout)
+    void map2world(const int n, const alu3d_ctype *x, const alu3d_ctype *y,
+                   alu3d_ctype *wx, alu3d_ctype *wy, alu3d_ctype *wz) const ;
+
+    // calculates the integration elements in n local points
+    void det(const int n, const alu3d_ctype *x, const alu3d_ctype *y, alu3d_ctype *det) const ;
+
   private:
     void map2worldnormal(const alu3d_ctype, const alu3d_ctype, const alu3d_ctype , coord3_t&) const;
     void map2worldlinear(const alu3d_ctype, const alu3d_ctype, const alu3d_ctype ) const;
@@ -69,6 +69,14 @@ namespace Dune {
     // initialize flags
     calcedDet_ = calcedLinear_ = calcedInv_ = false;
 
+    // the Jacobian of an affine mapping is constant, so compute it once
+    if( affine_ )
+    {
+      linear( 0.0, 0.0, 0.0 );
+      if( Df.determinant() > 0 )
+        inverse( coord_t( 0.0 ) );
+    }
+
     return ;
   }
 
@@ -78,9 +86,15 @@ namespace Dune {
     for (int i = 0 ; i < 8 ; ++i)
       for (int j = 0 ; j < 3 ; ++j)
         a [i][j] = map.a [i][j] ;
+    // copy cached Jacobian (only valid for affine mappings)
+    Df = map.Df;
+    Dfi = map.Dfi;
+    DetDf = map.DetDf;
     // copy flags
     affine_ = map.affine_;
-    calcedDet_ = calcedLinear_ = calcedInv_ = false;
+    calcedDet_ = map.calcedDet_;
+    calcedLinear_ = map.calcedLinear_;
+    calcedInv_ = map.calcedInv_;
     return ;
   }
 
@@ -250,6 +264,120 @@ namespace Dune {
     return ;
   }
 
+  alu_inline void TrilinearMapping ::
+  map2world (const int n, const alu3d_ctype *x, const alu3d_ctype *y, const alu3d_ctype *z,
+             alu3d_ctype *wx, alu3d_ctype *wy, alu3d_ctype *wz) const
+  {
+    if( affine_ )
+    {
+      for( int i = 0; i < n; ++i )
+      {
+        wx[ i ] = a [0][0] + a [1][0] * x[ i ] + a [2][0] * y[ i ] + a [3][0] * z[ i ] ;
+        wy[ i ] = a [0][1] + a [1][1] * x[ i ] + a [2][1] * y[ i ] + a [3][1] * z[ i ] ;
+        wz[ i ] = a [0][2] + a [1][2] * x[ i ] + a [2][2] * y[ i ] + a [3][2] * z[ i ] ;
+      }
+      return ;
+    }
+
+    for( int i = 0; i < n; ++i )
+    {
+      const alu3d_ctype yz  = y[ i ] * z[ i ] ;
+      const alu3d_ctype xz  = x[ i ] * z[ i ] ;
+      const alu3d_ctype xy  = x[ i ] * y[ i ] ;
+      const alu3d_ctype xyz = x[ i ] * yz ;
+      wx[ i ] = a [0][0] + a [1][0] * x[ i ] + a [2][0] * y[ i ] + a [3][0] * z[ i ] + a [4][0] * xy + a [5][0] * yz + a [6][0] * xz + a [7][0] * xyz ;
+      wy[ i ] = a [0][1] + a [1][1] * x[ i ] + a [2][1] * y[ i ] + a [3][1] * z[ i ] + a [4][1] * xy + a [5][1] * yz + a [6][1] * xz + a [7][1] * xyz ;
+      wz[ i ] = a [0][2] + a [1][2] * x[ i ] + a [2][2] * y[ i ] + a [3][2] * z[ i ] + a [4][2] * xy + a [5][2] * yz + a [6][2] * xz + a [7][2] * xyz ;
+    }
+  }
+
+  alu_inline void TrilinearMapping ::
+  jacobianInverseTransposed (const int n, const alu3d_ctype *x, const alu3d_ctype *y, const alu3d_ctype *z,
+                             alu3d_ctype *jit, alu3d_ctype *det) const
+  {
+    // constant Jacobian, computed in buildMapping
+    if( calcedInv_ )
+    {
+      for( int r = 0; r < 3; ++r )
+        for( int c = 0; c < 3; ++c )
+          std::fill( jit + (3*r+c)*n, jit + (3*r+c+1)*n, Dfi[ r ][ c ] );
+      if( det )
+        std::fill( det, det + n, DetDf );
+      return ;
+    }
+
+    for( int i = 0; i < n; ++i )
+    {
+      const alu3d_ctype yz = y[ i ] * z[ i ] ;
+      const alu3d_ctype xz = x[ i ] * z[ i ] ;
+      const alu3d_ctype xy = x[ i ] * y[ i ] ;
+
+      // derivatives with respect to x, y and z (as in linear)
+      const alu3d_ctype d00 = a[1][0] + y[ i ] * a[4][0] + z[ i ] * a[6][0] + yz * a[7][0] ;
+      const alu3d_ctype d01 = a[1][1] + y[ i ] * a[4][1] + z[ i ] * a[6][1] + yz * a[7][1] ;
+      const alu3d_ctype d02 = a[1][2] + y[ i ] * a[4][2] + z[ i ] * a[6][2] + yz * a[7][2] ;
+      const alu3d_ctype d10 = a[2][0] + x[ i ] * a[4][0] + z[ i ] * a[5][0] + xz * a[7][0] ;
+      const alu3d_ctype d11 = a[2][1] + x[ i ] * a[4][1] + z[ i ] * a[5][1] + xz * a[7][1] ;
+      const alu3d_ctype d12 = a[2][2] + x[ i ] * a[4][2] + z[ i ] * a[5][2] + xz * a[7][2] ;
+      const alu3d_ctype d20 = a[3][0] + y[ i ] * a[5][0] + x[ i ] * a[6][0] + xy * a[7][0] ;
+      const alu3d_ctype d21 = a[3][1] + y[ i ] * a[5][1] + x[ i ] * a[6][1] + xy * a[7][1] ;
+      const alu3d_ctype d22 = a[3][2] + y[ i ] * a[5][2] + x[ i ] * a[6][2] + xy * a[7][2] ;
+
+      // inverse transposed by Cramer's rule (as in inverse)
+      const alu3d_ctype c00 = d11 * d22 - d21 * d12 ;
+      const alu3d_ctype c10 = d20 * d12 - d10 * d22 ;
+      const alu3d_ctype c20 = d10 * d21 - d20 * d11 ;
+      const alu3d_ctype detDf = d00 * c00 + d01 * c10 + d02 * c20 ;
+      const alu3d_ctype val = 1.0 / detDf ;
+
+      jit[ 0*n + i ] = c00 * val ;
+      jit[ 3*n + i ] = c10 * val ;
+      jit[ 6*n + i ] = c20 * val ;
+      jit[ 1*n + i ] = ( d21 * d02 - d01 * d22 ) * val ;
+      jit[ 4*n + i ] = ( d00 * d22 - d20 * d02 ) * val ;
+      jit[ 7*n + i ] = ( d20 * d01 - d00 * d21 ) * val ;
+      jit[ 2*n + i ] = ( d01 * d12 - d11 * d02 ) * val ;
+      jit[ 5*n + i ] = ( d10 * d02 - d00 * d12 ) * val ;
+      jit[ 8*n + i ] = ( d00 * d11 - d10 * d01 ) * val ;
+      if( det )
+        det[ i ] = detDf ;
+    }
+  }
+
+  alu_inline void TrilinearMapping ::
+  world2map (const int n, const alu3d_ctype *wx, const alu3d_ctype *wy, const alu3d_ctype *wz,
+             alu3d_ctype *x, alu3d_ctype *y, alu3d_ctype *z) const
+  {
+    // an affine mapping is inverted directly by the constant Jacobian
+    if( calcedInv_ )
+    {
+      for( int i = 0; i < n; ++i )
+      {
+        const alu3d_ctype u0 = wx[ i ] - a [0][0] ;
+        const alu3d_ctype u1 = wy[ i ] - a [0][1] ;
+        const alu3d_ctype u2 = wz[ i ] - a [0][2] ;
+        x[ i ] = Dfi [0][0] * u0 + Dfi [1][0] * u1 + Dfi [2][0] * u2 ;
+        y[ i ] = Dfi [0][1] * u0 + Dfi [1][1] * u1 + Dfi [2][1] * u2 ;
+        z[ i ] = Dfi [0][2] * u0 + Dfi [1][2] * u1 + Dfi [2][2] * u2 ;
+      }
+      return ;
+    }
+
+    // Newton iteration on a local copy, so the cached state is not touched
+    TrilinearMapping mapping( *this );
+    coord_t wld, map ;
+    for( int i = 0; i < n; ++i )
+    {
+      wld[ 0 ] = wx[ i ];
+      wld[ 1 ] = wy[ i ];
+      wld[ 2 ] = wz[ i ];
+      mapping.world2map( wld, map );
+      x[ i ] = map[ 0 ];
+      y[ i ] = map[ 1 ];
+      z[ i ] = map[ 2 ];
+    }
+  }
+
   //- Bilinear surface mapping
   // Constructor for FieldVectors
   alu_inline SurfaceNormalCalculator :: SurfaceNormalCalculator()
@@ -346,6 +474,27 @@ namespace Dune {
     return ;
   }
 
+  alu_inline void SurfaceNormalCalculator ::
+  normal (const int n, const alu3d_ctype *x, const alu3d_ctype *y,
+          alu3d_ctype *nx, alu3d_ctype *ny, alu3d_ctype *nz) const
+  {
+    // for affine faces the normal is constant
+    if( _affine )
+    {
+      std::fill( nx, nx + n, -_n [0][0] );
+      std::fill( ny, ny + n, -_n [0][1] );
+      std::fill( nz, nz + n, -_n [0][2] );
+      return ;
+    }
+
+    for( int i = 0; i < n; ++i )
+    {
+      nx[ i ] = -(_n [0][0] + _n [1][0] * x[ i ] + _n [2][0] * y[ i ]);
+      ny[ i ] = -(_n [0][1] + _n [1][1] * x[ i ] + _n [2][1] * y[ i ]);
+      nz[ i ] = -(_n [0][2] + _n [1][2] * x[ i ] + _n [2][2] * y[ i ]);
+    }
+  }
+
   alu_inline void SurfaceNormalCalculator ::
   negativeNormal (const coord2_t& map, coord3_t& norm) const
   {
@@ -438,6 +587,39 @@ namespace Dune {
   }
 
 
+  alu_inline void BilinearSurfaceMapping ::
+  map2world (const int n, const alu3d_ctype *x, const alu3d_ctype *y,
+             alu3d_ctype *wx, alu3d_ctype *wy, alu3d_ctype *wz) const
+  {
+    for( int i = 0; i < n; ++i )
+    {
+      const alu3d_ctype xy = x[ i ] * y[ i ] ;
+      wx[ i ] = _b [0][0] + x[ i ] * _b [1][0] + y[ i ] * _b [2][0] + xy * _b [3][0] ;
+      wy[ i ] = _b [0][1] + x[ i ] * _b [1][1] + y[ i ] * _b [2][1] + xy * _b [3][1] ;
+      wz[ i ] = _b [0][2] + x[ i ] * _b [1][2] + y[ i ] * _b [2][2] + xy * _b [3][2] ;
+    }
+  }
+
+  alu_inline void BilinearSurfaceMapping ::
+  det (const int n, const alu3d_ctype *x, const alu3d_ctype *y, alu3d_ctype *det) const
+  {
+    // for affine faces the integration element is constant
+    if( _affine )
+    {
+      const alu3d_ctype d = std::sqrt( _n [0][0] * _n [0][0] + _n [0][1] * _n [0][1] + _n [0][2] * _n [0][2] );
+      std::fill( det, det + n, d );
+      return ;
+    }
+
+    for( int i = 0; i < n; ++i )
+    {
+      const alu3d_ctype n0 = _n [0][0] + _n [1][0] * x[ i ] + _n [2][0] * y[ i ];
+      const alu3d_ctype n1 = _n [0][1] + _n [1][1] * x[ i ] + _n [2][1] * y[ i ];
+      const alu3d_ctype n2 = _n [0][2] + _n [1][2] * x[ i ] + _n [2][2] * y[ i ];
+      det[ i ] = std::sqrt( n0 * n0 + n1 * n1 + n2 * n2 );
+    }
+  }
+
   alu_inline void BilinearSurfaceMapping ::
   map2worldnormal (const alu3d_ctype x,
                    const alu3d_ctype y,
@@ -5,11 +5,13 @@
 
 //- system headers
 #include <fstream>
+#include <sstream>
 
 //- Dune headers
 #include <dune/common/exceptions.hh>
 #include <dune/grid/common/backuprestore.hh>
 #include <dune/grid/alugrid/common/declaration.hh>
+#include <dune/grid/io/file/checkpointfile.hh>
 
 namespace Dune
 {
@@ -20,6 +22,7 @@ namespace Dune
   {
     // type of grid
     typedef ALUGrid< dim, dimworld, elType, refineType, Comm > Grid;
+    typedef typename Grid::CollectiveCommunication CollectiveCommunication;
 
     static std::string createFilename( const std::string &path, const std::string &fileprefix )
     {
@@ -81,6 +84,36 @@ namespace Dune
       grid->restore( stream );
       return grid;
     }
+
+    /** \brief write a binary backup of the grid into a checkpoint file
+     *
+     *  The macro and refinement data of each process is stored as one block
+     *  of the single checkpoint file. User data, e.g., PersistentContainers,
+     *  can be written after the grid.
+     */
+    static void backup ( const Grid &grid, CheckpointFileWriter< CollectiveCommunication > &writer )
+    {
+      std::ostringstream stream( std::ios_base::out | std::ios_base::binary );
+      grid.backup( stream );
+      writer.write( std::string( "ALUGrid" ) );
+      writer.write( stream.str() );
+    }
+
+    /** \brief restore a grid from a checkpoint file
+     *
+     *  \note The grid is restored on the default communicator, which must
+     *        have the same size as the one used for writing.
+     */
+    static Grid *restore ( CheckpointFileReader< CollectiveCommunication > &reader )
+    {
+      std::string tag, data;
+      reader.read( tag );
+      if( tag != "ALUGrid" )
+        DUNE_THROW( IOError, "Checkpoint file does not contain an ALUGrid." );
+      reader.read( data );
+      std::istringstream stream( data, std::ios_base::in | std::ios_base::binary );
+      return restore( stream );
+    }
   };
 
 } // namespace Dune
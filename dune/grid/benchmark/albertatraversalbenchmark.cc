@@ -0,0 +1,178 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+/** \file
+ *  \brief Measure the scaling of AlbertaGrid leaf traversal when the macro
+ *         elements are split into disjoint ranges traversed by several threads
+ *
+ *  The "equal" column splits the macro elements into ranges of equal length,
+ *  the "weighted" column uses MeshPointer::parallelLeafTraverse with the
+ *  partition returned by MeshPointer::partition, which balances the number
+ *  of leaf elements per thread.  The partition is computed once, outside
+ *  the timed loop, as it only changes when the mesh is adapted.
+ *
+ *  Usage: albertatraversalbenchmark [cells per direction] [refinements] [max threads] [repetitions]
+ *
+ *  The default refines a structured simplex grid of 16^dim cubes
+ *  3*dim times.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/albertagrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+
+// sum of the levels and types of all leaf elements
+template< class ElementInfo >
+struct Checksum
+{
+  Checksum () : value( 0 ) {}
+
+  void operator() ( const ElementInfo &info )
+  {
+    value += info.level() + info.type();
+  }
+
+  long value;
+};
+
+// traverse the leaves below the macro elements [begin, end)
+template< class MeshPointer >
+long traverseRange ( const MeshPointer &mesh, int begin, int end )
+{
+  typedef typename MeshPointer::MacroIterator MacroIterator;
+  typedef typename MacroIterator::ElementInfo ElementInfo;
+
+  Checksum< ElementInfo > checksum;
+  MacroIterator it = mesh.begin();
+  for( int i = 0; i < begin; ++i )
+    ++it;
+  for( int i = begin; i < end; ++i, ++it )
+    it.elementInfo().leafTraverse( checksum );
+  return checksum.value;
+}
+
+// time a leaf traversal split into equal macro element ranges, one per thread
+template< class MeshPointer >
+double traverse ( const MeshPointer &mesh, int numThreads, int repetitions, long &checksum )
+{
+  const int numMacro = mesh.numMacroElements();
+  std::vector< long > sums( numThreads, 0 );
+
+  Dune::Timer timer;
+  for( int r = 0; r < repetitions; ++r )
+  {
+    std::vector< std::thread > threads;
+    for( int t = 0; t < numThreads; ++t )
+    {
+      const int begin = (t * numMacro) / numThreads;
+      const int end = ((t+1) * numMacro) / numThreads;
+      long &sum = sums[ t ];
+      threads.push_back( std::thread( [ &mesh, begin, end, &sum ] { sum = traverseRange( mesh, begin, end ); } ) );
+    }
+    for( std::thread &thread : threads )
+      thread.join();
+  }
+  const double time = timer.elapsed() / repetitions;
+
+  for( int t = 0; t < numThreads; ++t )
+    checksum += sums[ t ];
+  return time;
+}
+
+// time MeshPointer::parallelLeafTraverse on a weighted partition
+template< class MeshPointer >
+double traverseWeighted ( const MeshPointer &mesh, int numThreads, int repetitions, long &checksum )
+{
+  typedef typename MeshPointer::MacroIterator::ElementInfo ElementInfo;
+
+  const std::vector< int > partition = mesh.partition( numThreads, true );
+  std::vector< Checksum< ElementInfo > > functors;
+  Dune::Timer timer;
+  for( int r = 0; r < repetitions; ++r )
+  {
+    functors.assign( numThreads, Checksum< ElementInfo >() );
+    mesh.parallelLeafTraverse( functors, partition );
+  }
+  const double time = timer.elapsed() / repetitions;
+
+  for( int t = 0; t < numThreads; ++t )
+    checksum += functors[ t ].value;
+  return time;
+}
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+
+  const int dim = ALBERTA_DIM;
+  typedef Dune::AlbertaGrid< dim, dim > Grid;
+  typedef Dune::Alberta::MeshPointer< dim > MeshPointer;
+
+  const int cells = (argc > 1 ? std::atoi( argv[ 1 ] ) : 16);
+  const int refinements = (argc > 2 ? std::atoi( argv[ 2 ] ) : 3*dim);
+  const int maxThreads = (argc > 3 ? std::atoi( argv[ 3 ] ) : std::max( 1u, std::thread::hardware_concurrency() ));
+  const int repetitions = (argc > 4 ? std::atoi( argv[ 4 ] ) : 10);
+
+  Dune::FieldVector< Grid::ctype, dim > lower( 0 ), upper( 1 );
+  Dune::array< unsigned int, dim > elements;
+  elements.fill( cells );
+
+  Dune::Timer timer;
+  Dune::shared_ptr< Grid > grid = Dune::StructuredGridFactory< Grid >::createSimplexGrid( lower, upper, elements );
+  grid->globalRefine( refinements );
+  const MeshPointer &mesh = grid->meshPointer();
+  const double setupTime = timer.elapsed();
+
+  // touch the whole mesh once before timing
+  long checksum = 0;
+  traverse( mesh, 1, 1, checksum );
+
+  std::vector< int > threadCounts;
+  for( int n = 1; n < maxThreads; n *= 2 )
+    threadCounts.push_back( n );
+  threadCounts.push_back( maxThreads );
+
+  std::vector< double > times, weightedTimes;
+  for( std::size_t i = 0; i < threadCounts.size(); ++i )
+  {
+    times.push_back( traverse( mesh, threadCounts[ i ], repetitions, checksum ) );
+    weightedTimes.push_back( traverseWeighted( mesh, threadCounts[ i ], repetitions, checksum ) );
+  }
+
+  if( mpiHelper.rank() == 0 )
+  {
+    const double size = grid->leafGridView().size( 0 );
+    std::cout << "grid setup:   " << setupTime << " s for " << size << " leaf elements in "
+              << mesh.numMacroElements() << " macro elements" << std::endl;
+    std::cout << std::setw( 8 ) << "" << std::setw( 32 ) << "equal" << std::setw( 32 ) << "weighted" << std::endl;
+    std::cout << std::setw( 8 ) << "threads"
+              << std::setw( 20 ) << "traversal [ns/elem]" << std::setw( 12 ) << "speedup"
+              << std::setw( 20 ) << "traversal [ns/elem]" << std::setw( 12 ) << "speedup" << std::endl;
+    for( std::size_t i = 0; i < threadCounts.size(); ++i )
+      std::cout << std::setw( 8 ) << threadCounts[ i ]
+                << std::setw( 20 ) << 1e9 * times[ i ] / size << std::setw( 12 ) << times[ 0 ] / times[ i ]
+                << std::setw( 20 ) << 1e9 * weightedTimes[ i ] / size << std::setw( 12 ) << times[ 0 ] / weightedTimes[ i ] << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+  }
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,105 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+/** \file
+ *  \brief Compare leaf element iteration through ALU's iterator wrappers
+ *         with the statically dispatched interior leaf element iterator
+ *
+ *  Usage: aluiteratorbenchmark [cells per direction] [repetitions]
+ *
+ *  The default builds a structured grid of 100^3 = 1M hexahedra.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/alugrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+
+// time a full traversal of the leaf elements of a partition
+template< Dune::PartitionIteratorType pitype, class GridView >
+double traverse ( const GridView &gridView, int repetitions, long &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::template Partition< pitype >::Iterator Iterator;
+
+  Dune::Timer timer;
+  for( int r = 0; r < repetitions; ++r )
+  {
+    const Iterator end = gridView.template end< 0, pitype >();
+    for( Iterator it = gridView.template begin< 0, pitype >(); it != end; ++it )
+      checksum += it->level();
+  }
+  return timer.elapsed() / repetitions;
+}
+
+// time the creation of begin iterators
+template< Dune::PartitionIteratorType pitype, class GridView >
+double begin ( const GridView &gridView, int count, long &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::template Partition< pitype >::Iterator Iterator;
+
+  Dune::Timer timer;
+  for( int i = 0; i < count; ++i )
+  {
+    Iterator it = gridView.template begin< 0, pitype >();
+    checksum += it->level();
+  }
+  return timer.elapsed() / count;
+}
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+
+  typedef Dune::ALUGrid< 3, 3, Dune::cube, Dune::nonconforming > Grid;
+  typedef Grid::LeafGridView GridView;
+
+  const int cells = (argc > 1 ? std::atoi( argv[ 1 ] ) : 100);
+  const int repetitions = (argc > 2 ? std::atoi( argv[ 2 ] ) : 10);
+
+  Dune::FieldVector< Grid::ctype, 3 > lower( 0 ), upper( 1 );
+  Dune::array< unsigned int, 3 > elements;
+  elements.fill( cells );
+
+  Dune::Timer timer;
+  Dune::shared_ptr< Grid > grid = Dune::StructuredGridFactory< Grid >::createCubeGrid( lower, upper, elements );
+  const GridView gridView = grid->leafGridView();
+  const double setupTime = timer.elapsed();
+
+  // build the cached leaf element list before timing
+  long checksum = 0;
+  traverse< Dune::Interior_Partition >( gridView, 1, checksum );
+
+  const double wrapperTraversal = traverse< Dune::InteriorBorder_Partition >( gridView, repetitions, checksum );
+  const double staticTraversal = traverse< Dune::Interior_Partition >( gridView, repetitions, checksum );
+  const double wrapperBegin = begin< Dune::InteriorBorder_Partition >( gridView, 100000, checksum );
+  const double staticBegin = begin< Dune::Interior_Partition >( gridView, 100000, checksum );
+
+  if( mpiHelper.rank() == 0 )
+  {
+    const double size = gridView.size( 0 );
+    std::cout << "grid setup:   " << setupTime << " s for " << gridView.size( 0 ) << " elements" << std::endl;
+    std::cout << std::setw( 12 ) << "" << std::setw( 20 ) << "traversal [ns/elem]" << std::setw( 16 ) << "begin() [ns]" << std::endl;
+    std::cout << std::setw( 12 ) << "wrapper" << std::setw( 20 ) << 1e9 * wrapperTraversal / size << std::setw( 16 ) << 1e9 * wrapperBegin << std::endl;
+    std::cout << std::setw( 12 ) << "static" << std::setw( 20 ) << 1e9 * staticTraversal / size << std::setw( 16 ) << 1e9 * staticBegin << std::endl;
+    std::cout << "speedup:      " << wrapperTraversal / staticTraversal << " (traversal), "
+              << wrapperBegin / staticBegin << " (begin)" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+  }
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
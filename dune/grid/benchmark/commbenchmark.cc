@@ -0,0 +1,235 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+/** \file
+ *  \brief Time the communicate method of YaspGrid for several overlap
+ *         widths and message sizes and write the results as JSON
+ *
+ *  Usage: commbenchmark [output file] [cells per direction] [repetitions]
+ *
+ *  Run it with several MPI processes.  For overlap widths 0, 1, 2 and 4 and
+ *  1, 8 and 64 doubles per entity, the benchmark communicates element and
+ *  vertex data over the All_All_Interface and reports the phase timings and
+ *  message statistics collected by the CommProfiler.  The build system
+ *  compiles this program with DUNE_GRID_COMM_PROFILING=1; without it only
+ *  the total times are available.
+ *
+ *  Output format:
+ *  \code
+ *  { "benchmark": "commbenchmark", "processes": 4, "repetitions": 10, "profiling": true,
+ *    "results": [
+ *      { "grid": "YaspGrid<2>", "overlap": 1, "codim": 0, "valuesPerEntity": 8,
+ *        "messagesSent": 4, "bytesSent": 33280, "seconds": 0.0009,
+ *        "size": 0.00001, "gather": 0.0002, "exchange": 0.0004, "scatter": 0.0002 },
+ *      ... ] }
+ *  \endcode
+ *
+ *  Messages and bytes are summed over all processes and given per
+ *  communication, times are the maximum over all processes per
+ *  communication.
+ */
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/common/commprofiler.hh>
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/yaspgrid.hh>
+
+
+// VectorDataHandle
+// ----------------
+
+// adds a fixed number of doubles per entity of a codimension
+template< class GridView >
+class VectorDataHandle
+  : public Dune::CommDataHandleIF< VectorDataHandle< GridView >, double >
+{
+public:
+  VectorDataHandle ( const GridView &gridView, int codim, int values )
+    : indexSet_( gridView.indexSet() ), codim_( codim ), values_( values ),
+      data_( gridView.size( codim )*values, 1.0 )
+  {}
+
+  bool contains ( int dim, int codim ) const { return (codim == codim_); }
+  bool fixedsize ( int dim, int codim ) const { return true; }
+
+  template< class Entity >
+  std::size_t size ( const Entity &entity ) const { return values_; }
+
+  template< class Buffer, class Entity >
+  void gather ( Buffer &buffer, const Entity &entity ) const
+  {
+    const std::size_t offset = indexSet_.index( entity )*values_;
+    for( int i = 0; i < values_; ++i )
+      buffer.write( data_[ offset + i ] );
+  }
+
+  template< class Buffer, class Entity >
+  void scatter ( Buffer &buffer, const Entity &entity, std::size_t n )
+  {
+    const std::size_t offset = indexSet_.index( entity )*values_;
+    for( std::size_t i = 0; i < n; ++i )
+    {
+      double value;
+      buffer.read( value );
+      data_[ offset + i ] += value;
+    }
+  }
+
+private:
+  const typename GridView::IndexSet &indexSet_;
+  int codim_, values_;
+  std::vector< double > data_;
+};
+
+
+// CommBenchmark
+// -------------
+
+class CommBenchmark
+{
+public:
+  CommBenchmark ( int processes, int repetitions )
+    : processes_( processes ), repetitions_( repetitions ), first_( true )
+  {}
+
+  // time the communication of values doubles per entity of codimension codim
+  template< class GridView >
+  void run ( const std::string &grid, const GridView &gridView, int overlap, int codim, int values )
+  {
+    typedef Dune::CommProfiler CommProfiler;
+    typedef Dune::CommProfileData CommProfileData;
+    const Dune::InterfaceType interface = Dune::All_All_Interface;
+
+    VectorDataHandle< GridView > handle( gridView, codim, values );
+
+    // build the communication lists outside the timed loop
+    gridView.communicate( handle, interface, Dune::ForwardCommunication );
+
+    CommProfiler::instance().clear();
+    Dune::Timer timer;
+    for( int r = 0; r < repetitions_; ++r )
+      gridView.communicate( handle, interface, Dune::ForwardCommunication );
+    const double seconds = timer.elapsed() / repetitions_;
+
+    const CommProfileData data = CommProfiler::instance().data( "YaspGrid", interface, codim );
+
+    std::vector< double > times( CommProfileData::numPhases+1 );
+    times[ 0 ] = seconds;
+    for( int p = 0; p < CommProfileData::numPhases; ++p )
+      times[ p+1 ] = data.time[ p ] / repetitions_;
+    gridView.comm().max( &times[ 0 ], times.size() );
+
+    std::vector< double > counts( 2 );
+    counts[ 0 ] = double( data.messagesSent ) / repetitions_;
+    counts[ 1 ] = double( data.bytesSent ) / repetitions_;
+    gridView.comm().sum( &counts[ 0 ], counts.size() );
+
+    out_ << (first_ ? "" : ",") << std::endl
+         << "    { \"grid\": \"" << grid << "\", \"overlap\": " << overlap
+         << ", \"codim\": " << codim << ", \"valuesPerEntity\": " << values
+         << ", \"messagesSent\": " << counts[ 0 ] << ", \"bytesSent\": " << counts[ 1 ]
+         << ", \"seconds\": " << times[ 0 ];
+    for( int p = 0; p < CommProfileData::numPhases; ++p )
+      out_ << ", \"" << CommProfileData::phaseName( p ) << "\": " << times[ p+1 ];
+    out_ << " }";
+    first_ = false;
+  }
+
+  void write ( std::ostream &out ) const
+  {
+    out << "{" << std::endl;
+    out << "  \"benchmark\": \"commbenchmark\"," << std::endl;
+    out << "  \"processes\": " << processes_ << "," << std::endl;
+    out << "  \"repetitions\": " << repetitions_ << "," << std::endl;
+    out << "  \"profiling\": " << (Dune::CommProfiler::enabled() ? "true" : "false") << "," << std::endl;
+    out << "  \"results\": [" << out_.str() << std::endl << "  ]" << std::endl << "}" << std::endl;
+  }
+
+private:
+  int processes_, repetitions_;
+  bool first_;
+  std::ostringstream out_;
+};
+
+
+// sweep overlap widths and message sizes for a YaspGrid of dimension dim
+template< int dim >
+void benchmarkYaspGrid ( CommBenchmark &benchmark, int cells )
+{
+  typedef Dune::YaspGrid< dim > Grid;
+  typedef typename Grid::LeafGridView GridView;
+
+  std::ostringstream name;
+  name << "YaspGrid<" << dim << ">";
+
+  Dune::FieldVector< double, dim > upper( 1.0 );
+  Dune::array< int, dim > elements;
+  std::fill( elements.begin(), elements.end(), cells );
+  const std::bitset< dim > periodic;
+
+  const int overlaps[] = { 0, 1, 2, 4 };
+  const int values[] = { 1, 8, 64 };
+  for( int o = 0; o < 4; ++o )
+  {
+    Grid grid( upper, elements, periodic, overlaps[ o ] );
+    const GridView gridView = grid.leafGridView();
+
+    for( int codim = 0; codim <= dim; codim += dim )
+      for( int v = 0; v < 3; ++v )
+        benchmark.run( name.str(), gridView, overlaps[ o ], codim, values[ v ] );
+  }
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+
+  const std::string output = (argc > 1 ? argv[ 1 ] : "-");
+  const int cells = (argc > 2 ? std::atoi( argv[ 2 ] ) : 256);
+  const int repetitions = (argc > 3 ? std::atoi( argv[ 3 ] ) : 10);
+
+  if( !Dune::CommProfiler::enabled() && (mpiHelper.rank() == 0) )
+    std::cerr << "Warning: compiled without DUNE_GRID_COMM_PROFILING, only total times are reported." << std::endl;
+
+  CommBenchmark benchmark( mpiHelper.size(), repetitions );
+  benchmarkYaspGrid< 2 >( benchmark, cells );
+  benchmarkYaspGrid< 3 >( benchmark, std::max( cells / 8, 1 ) );
+
+  if( mpiHelper.rank() == 0 )
+  {
+    if( output == "-" )
+      benchmark.write( std::cout );
+    else
+    {
+      std::ofstream file( output.c_str() );
+      if( !file )
+        DUNE_THROW( Dune::IOError, "Could not open " << output << " for writing" );
+      benchmark.write( file );
+    }
+  }
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
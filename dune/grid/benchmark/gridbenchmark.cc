@@ -0,0 +1,162 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+/** \file
+ *  \brief Time the grid interface operations of all available grid
+ *         implementations and write the results as JSON
+ *
+ *  Usage: gridbenchmark [output file] [cells per direction] [repetitions]
+ *
+ *  Without output file (or with "-") the JSON goes to standard output.
+ *  The 2d grids have the given number of cells per direction (default 256),
+ *  the 3d grids an eighth of it, the 1d grid its square.
+ *
+ *  See gridbenchmark.hh for the list of operations and the output format.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/shared_ptr.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/geometrygrid.hh>
+#include <dune/grid/geometrygrid/identity.hh>
+#include <dune/grid/identitygrid.hh>
+#include <dune/grid/onedgrid.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+
+#if HAVE_ALUGRID
+#include <dune/grid/alugrid.hh>
+#endif
+
+#if HAVE_UG
+#include <dune/grid/uggrid.hh>
+#endif
+
+#include "gridbenchmark.hh"
+
+template< int dim >
+Dune::YaspGrid< dim > *createYaspGrid ( int cells )
+{
+  Dune::FieldVector< double, dim > upper( 1.0 );
+  Dune::array< int, dim > elements;
+  std::fill( elements.begin(), elements.end(), cells );
+  return new Dune::YaspGrid< dim >( upper, elements );
+}
+
+template< class Grid >
+Dune::shared_ptr< Grid > createCubeGrid ( int cells )
+{
+  const int dim = Grid::dimension;
+  Dune::FieldVector< typename Grid::ctype, dim > lower( 0.0 ), upper( 1.0 );
+  Dune::array< unsigned int, dim > elements;
+  std::fill( elements.begin(), elements.end(), cells );
+  return Dune::StructuredGridFactory< Grid >::createCubeGrid( lower, upper, elements );
+}
+
+template< class Grid >
+Dune::shared_ptr< Grid > createSimplexGrid ( int cells )
+{
+  const int dim = Grid::dimension;
+  Dune::FieldVector< typename Grid::ctype, dim > lower( 0.0 ), upper( 1.0 );
+  Dune::array< unsigned int, dim > elements;
+  std::fill( elements.begin(), elements.end(), cells );
+  return Dune::StructuredGridFactory< Grid >::createSimplexGrid( lower, upper, elements );
+}
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+
+  const std::string output = (argc > 1 ? argv[ 1 ] : "-");
+  const int cells = (argc > 2 ? std::atoi( argv[ 2 ] ) : 256);
+  const int repetitions = (argc > 3 ? std::atoi( argv[ 3 ] ) : 5);
+  const int cells3d = std::max( cells / 8, 1 );
+
+  BenchmarkReport report( "gridbenchmark", mpiHelper.size(), repetitions );
+  double checksum = 0;
+
+  {
+    Dune::shared_ptr< Dune::YaspGrid< 2 > > grid( createYaspGrid< 2 >( cells ) );
+    checksum += benchmarkGrid( report, "YaspGrid<2>", *grid );
+  }
+
+  {
+    Dune::shared_ptr< Dune::YaspGrid< 3 > > grid( createYaspGrid< 3 >( cells3d ) );
+    checksum += benchmarkGrid( report, "YaspGrid<3>", *grid );
+  }
+
+  {
+    Dune::OneDGrid grid( cells*cells, 0.0, 1.0 );
+    checksum += benchmarkGrid( report, "OneDGrid", grid );
+  }
+
+  {
+    typedef Dune::YaspGrid< 2 > HostGrid;
+    typedef Dune::IdenticalCoordFunction< double, 2 > CoordFunction;
+    Dune::shared_ptr< HostGrid > hostGrid( createYaspGrid< 2 >( cells ) );
+    CoordFunction coordFunction;
+    Dune::GeometryGrid< HostGrid, CoordFunction > grid( *hostGrid, coordFunction );
+    checksum += benchmarkGrid( report, "GeometryGrid<YaspGrid<2>>", grid );
+  }
+
+  {
+    typedef Dune::YaspGrid< 2 > HostGrid;
+    Dune::shared_ptr< HostGrid > hostGrid( createYaspGrid< 2 >( cells ) );
+    Dune::IdentityGrid< HostGrid > grid( *hostGrid );
+    checksum += benchmarkGrid( report, "IdentityGrid<YaspGrid<2>>", grid );
+  }
+
+#if HAVE_ALUGRID
+  {
+    typedef Dune::ALUGrid< 2, 2, Dune::simplex, Dune::conforming > Grid;
+    Dune::shared_ptr< Grid > grid = createSimplexGrid< Grid >( cells );
+    checksum += benchmarkGrid( report, "ALUGrid<2,2,simplex,conforming>", *grid );
+  }
+
+  {
+    typedef Dune::ALUGrid< 3, 3, Dune::cube, Dune::nonconforming > Grid;
+    Dune::shared_ptr< Grid > grid = createCubeGrid< Grid >( cells3d );
+    checksum += benchmarkGrid( report, "ALUGrid<3,3,cube,nonconforming>", *grid );
+  }
+#endif // #if HAVE_ALUGRID
+
+#if HAVE_UG
+  {
+    typedef Dune::UGGrid< 2 > Grid;
+    Dune::shared_ptr< Grid > grid = createCubeGrid< Grid >( cells );
+    checksum += benchmarkGrid( report, "UGGrid<2>", *grid );
+  }
+#endif // #if HAVE_UG
+
+  if( mpiHelper.rank() == 0 )
+  {
+    if( output == "-" )
+      report.write( std::cout );
+    else
+    {
+      std::ofstream file( output.c_str() );
+      if( !file )
+        DUNE_THROW( Dune::IOError, "Could not open " << output << " for writing" );
+      report.write( file );
+    }
+    std::cerr << "(checksum " << checksum << ")" << std::endl;
+  }
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
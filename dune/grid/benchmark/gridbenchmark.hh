@@ -0,0 +1,359 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_BENCHMARK_GRIDBENCHMARK_HH
+#define DUNE_GRID_BENCHMARK_GRIDBENCHMARK_HH
+
+/** \file
+ *  \brief Timing of the basic grid interface operations for any grid
+ *
+ *  benchmarkGrid() times the same operations for every grid implementation
+ *  and stores the results in a BenchmarkReport, which writes them as JSON:
+ *
+ *  \code
+ *  { "benchmark": "gridbenchmark", "processes": 1, "repetitions": 5,
+ *    "results": [
+ *      { "grid": "YaspGrid<2>", "operation": "leafIteration", "codim": 0,
+ *        "count": 65536, "seconds": 0.0012, "nsPerItem": 18.3 },
+ *      ... ] }
+ *  \endcode
+ *
+ *  "count" is the number of items (entities, intersections, messages) an
+ *  operation handles, "seconds" the time of one repetition, taken as the
+ *  maximum over all processes.  "codim" is -1 for operations not bound to
+ *  a codimension.  Operations a grid does not support are left out.
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/forloop.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+
+#include <dune/geometry/referenceelements.hh>
+
+#include <dune/grid/common/capabilities.hh>
+#include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/mcmgmapper.hh>
+
+
+// BenchmarkReport
+// ---------------
+
+class BenchmarkReport
+{
+  struct Result
+  {
+    std::string grid, operation;
+    int codim;
+    long count;
+    double seconds;
+  };
+
+public:
+  BenchmarkReport ( const std::string &name, int processes, int repetitions )
+    : name_( name ), processes_( processes ), repetitions_( repetitions )
+  {}
+
+  int repetitions () const { return repetitions_; }
+
+  void add ( const std::string &grid, const std::string &operation, int codim, long count, double seconds )
+  {
+    Result result = { grid, operation, codim, count, seconds };
+    results_.push_back( result );
+  }
+
+  void write ( std::ostream &out ) const
+  {
+    out << "{" << std::endl;
+    out << "  \"benchmark\": " << quote( name_ ) << "," << std::endl;
+    out << "  \"processes\": " << processes_ << "," << std::endl;
+    out << "  \"repetitions\": " << repetitions_ << "," << std::endl;
+    out << "  \"results\": [";
+    for( std::size_t i = 0; i < results_.size(); ++i )
+    {
+      const Result &r = results_[ i ];
+      out << (i > 0 ? "," : "") << std::endl
+          << "    { \"grid\": " << quote( r.grid ) << ", \"operation\": " << quote( r.operation )
+          << ", \"codim\": " << r.codim << ", \"count\": " << r.count << ", \"seconds\": " << r.seconds
+          << ", \"nsPerItem\": " << (r.count > 0 ? 1e9 * r.seconds / r.count : 0.0) << " }";
+    }
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+  }
+
+private:
+  static std::string quote ( const std::string &s )
+  {
+    std::ostringstream out;
+    out << '"';
+    for( std::size_t i = 0; i < s.size(); ++i )
+    {
+      if( (s[ i ] == '"') || (s[ i ] == '\\') )
+        out << '\\';
+      out << s[ i ];
+    }
+    out << '"';
+    return out.str();
+  }
+
+  std::string name_;
+  int processes_, repetitions_;
+  std::vector< Result > results_;
+};
+
+
+// time a function object over the repetitions of the report and record it
+template< class GridView, class F >
+inline void recordTiming ( BenchmarkReport &report, const std::string &grid, const GridView &gridView,
+                           const std::string &operation, int codim, F f )
+{
+  long count = 0;
+  Dune::Timer timer;
+  for( int r = 0; r < report.repetitions(); ++r )
+    count = f();
+  const double seconds = gridView.comm().max( timer.elapsed() / report.repetitions() );
+  report.add( grid, operation, codim, count, seconds );
+}
+
+
+// IterationBenchmark
+// ------------------
+
+template< class GridView, int codim, bool hasEntity = Dune::Capabilities::hasEntity< typename GridView::Grid, codim >::v >
+struct IterationBenchmark
+{
+  static long apply ( const GridView &gridView, double &checksum )
+  {
+    typedef typename GridView::template Codim< codim >::Iterator Iterator;
+
+    long count = 0;
+    const Iterator end = gridView.template end< codim >();
+    for( Iterator it = gridView.template begin< codim >(); it != end; ++it, ++count )
+      checksum += it->type().dim();
+    return count;
+  }
+};
+
+template< class GridView, int codim >
+struct IterationBenchmark< GridView, codim, false >
+{
+  static long apply ( const GridView &gridView, double &checksum ) { return -1; }
+};
+
+
+// BenchmarkIteration
+// ------------------
+
+template< int codim >
+struct BenchmarkIteration
+{
+  template< class GridView >
+  static void apply ( BenchmarkReport &report, const std::string &grid, const std::string &operation,
+                      const GridView &gridView, double &checksum )
+  {
+    if( !Dune::Capabilities::hasEntity< typename GridView::Grid, codim >::v )
+      return;
+    recordTiming( report, grid, gridView, operation, codim,
+                  [ &gridView, &checksum ] { return IterationBenchmark< GridView, codim >::apply( gridView, checksum ); } );
+  }
+};
+
+
+// time the intersection iteration of all elements
+template< class GridView >
+inline long benchmarkIntersections ( const GridView &gridView, double &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+  typedef typename GridView::IntersectionIterator IntersectionIterator;
+
+  long count = 0;
+  const Iterator end = gridView.template end< 0 >();
+  for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+  {
+    const IntersectionIterator iend = gridView.iend( *it );
+    for( IntersectionIterator iit = gridView.ibegin( *it ); iit != iend; ++iit, ++count )
+      checksum += iit->neighbor() + iit->centerUnitOuterNormal()[ 0 ];
+  }
+  return count;
+}
+
+// time the element geometry, its center and the local coordinate of the center
+template< class GridView >
+inline long benchmarkGeometry ( const GridView &gridView, double &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+  typedef typename GridView::template Codim< 0 >::Geometry Geometry;
+
+  long count = 0;
+  const Iterator end = gridView.template end< 0 >();
+  for( Iterator it = gridView.template begin< 0 >(); it != end; ++it, ++count )
+  {
+    const Geometry geometry = it->geometry();
+    checksum += geometry.local( geometry.center() )[ 0 ];
+  }
+  return count;
+}
+
+// time the subentity indices of all elements in one codimension
+template< class GridView >
+inline long benchmarkSubIndices ( const GridView &gridView, int codim, double &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+  typedef typename GridView::ctype ctype;
+  const int dim = GridView::dimension;
+
+  long count = 0;
+  const Iterator end = gridView.template end< 0 >();
+  for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+  {
+    const int size = Dune::ReferenceElements< ctype, dim >::general( it->type() ).size( codim );
+    for( int i = 0; i < size; ++i, ++count )
+      checksum += gridView.indexSet().subIndex( *it, i, codim );
+  }
+  return count;
+}
+
+// time the construction of a mapper
+template< class GridView, template< int > class Layout >
+inline long benchmarkMapper ( const GridView &gridView, double &checksum )
+{
+  Dune::MultipleCodimMultipleGeomTypeMapper< GridView, Layout > mapper( gridView );
+  checksum += mapper.size();
+  return mapper.size();
+}
+
+
+// BenchmarkDataHandle
+// -------------------
+
+// sums one double per entity of a codimension
+template< class GridView >
+class BenchmarkDataHandle
+  : public Dune::CommDataHandleIF< BenchmarkDataHandle< GridView >, double >
+{
+public:
+  BenchmarkDataHandle ( const GridView &gridView, int codim )
+    : indexSet_( gridView.indexSet() ), codim_( codim ),
+      data_( gridView.size( codim ), 1.0 ), messages_( 0 )
+  {}
+
+  bool contains ( int dim, int codim ) const { return (codim == codim_); }
+  bool fixedsize ( int dim, int codim ) const { return true; }
+
+  template< class Entity >
+  std::size_t size ( const Entity &entity ) const { return 1; }
+
+  template< class Buffer, class Entity >
+  void gather ( Buffer &buffer, const Entity &entity ) const
+  {
+    buffer.write( data_[ indexSet_.index( entity ) ] );
+  }
+
+  template< class Buffer, class Entity >
+  void scatter ( Buffer &buffer, const Entity &entity, std::size_t n )
+  {
+    double value;
+    buffer.read( value );
+    data_[ indexSet_.index( entity ) ] += value;
+    ++messages_;
+  }
+
+  long messages () const { return messages_; }
+
+private:
+  const typename GridView::IndexSet &indexSet_;
+  int codim_;
+  std::vector< double > data_;
+  long messages_;
+};
+
+// time the communication of one double per entity of a codimension
+template< class GridView >
+inline void benchmarkCommunication ( BenchmarkReport &report, const std::string &grid, const GridView &gridView,
+                                     int codim, Dune::InterfaceType interface )
+{
+  try
+  {
+    recordTiming( report, grid, gridView, "communicate", codim,
+                  [ &gridView, codim, interface ] {
+                    BenchmarkDataHandle< GridView > handle( gridView, codim );
+                    gridView.communicate( handle, interface, Dune::ForwardCommunication );
+                    return handle.messages();
+                  } );
+  }
+  catch( const Dune::NotImplemented & )
+  {}
+}
+
+// time one global refinement and coarsening cycle through the adaptation interface
+template< class Grid >
+inline void benchmarkAdaptation ( BenchmarkReport &report, const std::string &name, Grid &grid )
+{
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+
+  try
+  {
+    recordTiming( report, name, grid.leafGridView(), "adaptCycle", -1,
+                  [ &grid ] {
+                    long count = 0;
+                    for( int refCount = 1; refCount >= -1; refCount -= 2 )
+                    {
+                      const GridView gridView = grid.leafGridView();
+                      const Iterator end = gridView.template end< 0 >();
+                      for( Iterator it = gridView.template begin< 0 >(); it != end; ++it, ++count )
+                        grid.mark( refCount, *it );
+                      grid.preAdapt();
+                      grid.adapt();
+                      grid.postAdapt();
+                    }
+                    return count;
+                  } );
+  }
+  catch( const Dune::NotImplemented & )
+  {}
+}
+
+
+// run all benchmarks on a grid
+template< class Grid >
+inline double benchmarkGrid ( BenchmarkReport &report, const std::string &name, Grid &grid )
+{
+  typedef typename Grid::LeafGridView LeafGridView;
+  typedef typename Grid::LevelGridView LevelGridView;
+  const int dim = Grid::dimension;
+
+  const LeafGridView leafView = grid.leafGridView();
+  const LevelGridView levelView = grid.levelGridView( grid.maxLevel() );
+
+  double checksum = 0;
+  const std::string leafIteration( "leafIteration" ), levelIteration( "levelIteration" );
+  Dune::ForLoop< BenchmarkIteration, 0, dim >::apply( report, name, leafIteration, leafView, checksum );
+  Dune::ForLoop< BenchmarkIteration, 0, dim >::apply( report, name, levelIteration, levelView, checksum );
+
+  recordTiming( report, name, leafView, "intersectionIteration", 1,
+                [ &leafView, &checksum ] { return benchmarkIntersections( leafView, checksum ); } );
+  recordTiming( report, name, leafView, "geometryLocal", 0,
+                [ &leafView, &checksum ] { return benchmarkGeometry( leafView, checksum ); } );
+  for( int codim = 0; codim <= dim; ++codim )
+    recordTiming( report, name, leafView, "subIndex", codim,
+                  [ &leafView, codim, &checksum ] { return benchmarkSubIndices( leafView, codim, checksum ); } );
+
+  recordTiming( report, name, leafView, "elementMapper", 0,
+                [ &leafView, &checksum ] { return benchmarkMapper< LeafGridView, Dune::MCMGElementLayout >( leafView, checksum ); } );
+  recordTiming( report, name, leafView, "vertexMapper", dim,
+                [ &leafView, &checksum ] { return benchmarkMapper< LeafGridView, Dune::MCMGVertexLayout >( leafView, checksum ); } );
+
+  benchmarkCommunication( report, name, leafView, 0, Dune::InteriorBorder_All_Interface );
+  benchmarkCommunication( report, name, leafView, dim, Dune::InteriorBorder_InteriorBorder_Interface );
+
+  benchmarkAdaptation( report, name, grid );
+
+  return checksum;
+}
+
+#endif // #ifndef DUNE_GRID_BENCHMARK_GRIDBENCHMARK_HH
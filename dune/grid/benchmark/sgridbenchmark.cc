@@ -0,0 +1,119 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#include <config.h>
+
+/** \file
+ *  \brief Compare element traversal, index and subIndex computation of
+ *         SGrid and YaspGrid on the same structured grid
+ *
+ *  Usage: sgridbenchmark [cells per direction] [repetitions]
+ *
+ *  The default uses a grid of 100^3 = 1M hexahedra.
+ */
+
+#include <array>
+#include <bitset>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/sgrid.hh>
+#include <dune/grid/yaspgrid.hh>
+
+// time a traversal of the leaf elements computing their index
+template< class GridView >
+double elementIndices ( const GridView &gridView, int repetitions, long &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+
+  Dune::Timer timer;
+  for( int r = 0; r < repetitions; ++r )
+  {
+    const Iterator end = gridView.template end< 0 >();
+    for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+      checksum += gridView.indexSet().index( *it );
+  }
+  return timer.elapsed() / repetitions;
+}
+
+// time a traversal of the leaf elements computing the indices of all subentities of a codimension
+template< class GridView >
+double subIndices ( const GridView &gridView, int codim, int repetitions, long &checksum )
+{
+  typedef typename GridView::template Codim< 0 >::Iterator Iterator;
+
+  Dune::Timer timer;
+  for( int r = 0; r < repetitions; ++r )
+  {
+    const Iterator end = gridView.template end< 0 >();
+    for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+    {
+      const int count = it->subEntities( codim );
+      for( int i = 0; i < count; ++i )
+        checksum += gridView.indexSet().subIndex( *it, i, codim );
+    }
+  }
+  return timer.elapsed() / repetitions;
+}
+
+template< class GridView >
+void run ( const char *name, const GridView &gridView, int repetitions, long &checksum )
+{
+  const int dim = GridView::dimension;
+  const double size = gridView.size( 0 );
+
+  std::cout << std::setw( 10 ) << name
+            << std::setw( 16 ) << 1e9 * elementIndices( gridView, repetitions, checksum ) / size;
+  for( int codim = 1; codim <= dim; ++codim )
+    std::cout << std::setw( 16 ) << 1e9 * subIndices( gridView, codim, repetitions, checksum ) / size;
+  std::cout << std::endl;
+}
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper &mpiHelper = Dune::MPIHelper::instance( argc, argv );
+
+  const int dim = 3;
+  typedef Dune::SGrid< dim, dim > SGrid;
+  typedef Dune::YaspGrid< dim > YaspGrid;
+
+  const int cells = (argc > 1 ? std::atoi( argv[ 1 ] ) : 100);
+  const int repetitions = (argc > 2 ? std::atoi( argv[ 2 ] ) : 5);
+
+  Dune::FieldVector< int, dim > n( cells );
+  Dune::FieldVector< double, dim > lower( 0.0 ), upper( 1.0 );
+  SGrid sgrid( n, lower, upper );
+
+  std::array< int, dim > elements;
+  elements.fill( cells );
+  YaspGrid yaspgrid( upper, elements, std::bitset< dim >(), 0 );
+
+  long checksum = 0;
+  if( mpiHelper.rank() == 0 )
+  {
+    std::cout << "time per element [ns], " << sgrid.size( 0 ) << " elements" << std::endl;
+    std::cout << std::setw( 10 ) << "" << std::setw( 16 ) << "index";
+    for( int codim = 1; codim <= dim; ++codim )
+      std::cout << std::setw( 15 ) << "subIndex " << codim;
+    std::cout << std::endl;
+  }
+
+  run( "SGrid", sgrid.leafGridView(), repetitions, checksum );
+  run( "YaspGrid", yaspgrid.leafGridView(), repetitions, checksum );
+
+  if( mpiHelper.rank() == 0 )
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
@@ -0,0 +1,247 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_COMMON_COMMPROFILER_HH
+#define DUNE_GRID_COMMON_COMMPROFILER_HH
+
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <tuple>
+
+#include <dune/common/timer.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+/** \file
+ *  \brief Optional profiling of the communicate methods of the grids
+ *
+ *  The communicate implementations of YaspGrid, ALUGrid and UGGrid open a
+ *  CommProfileScope for each communication they perform.  Unless the
+ *  preprocessor symbol DUNE_GRID_COMM_PROFILING is defined to a nonzero
+ *  value, the scope is an empty class and the instrumentation compiles to
+ *  nothing.  Otherwise the scope accumulates call counts, messages, bytes
+ *  and phase timings into the CommProfiler singleton, from where they can
+ *  be queried by data() or written by report().
+ *
+ *  Both variants of CommProfileScope live in different inline namespaces,
+ *  so translation units compiled with and without profiling can be linked
+ *  into one program without mixing up the two class layouts.  The
+ *  communicate methods are templates on the data handle, though, and the
+ *  linker keeps only one instantiation of each.  Reliable statistics
+ *  therefore require DUNE_GRID_COMM_PROFILING to be set for every
+ *  translation unit that communicates, and enabled() only reflects the
+ *  setting of the calling translation unit.
+ */
+
+#ifndef DUNE_GRID_COMM_PROFILING
+#define DUNE_GRID_COMM_PROFILING 0
+#endif
+
+namespace Dune
+{
+
+  // CommProfileData
+  // ---------------
+
+  /** \brief accumulated statistics of the communications on one interface and codimension */
+  struct CommProfileData
+  {
+    //! phases of a communication
+    enum Phase
+    {
+      sizePhase,      //!< computing (and exchanging) the message sizes
+      gatherPhase,    //!< packing the data into the send buffers
+      exchangePhase,  //!< transferring the buffers, including waiting for the neighbors
+      scatterPhase,   //!< unpacking the data from the receive buffers
+      numPhases
+    };
+
+    CommProfileData ()
+      : calls( 0 ), messagesSent( 0 ), messagesReceived( 0 ),
+        bytesSent( 0 ), bytesReceived( 0 )
+    {
+      for( int p = 0; p < numPhases; ++p )
+        time[ p ] = 0.0;
+    }
+
+    //! name of a phase as used in the report
+    static const char *phaseName ( int phase )
+    {
+      static const char *names[ numPhases ] = { "size", "gather", "exchange", "scatter" };
+      return names[ phase ];
+    }
+
+    //! total time spent in all phases
+    double totalTime () const
+    {
+      double t = 0.0;
+      for( int p = 0; p < numPhases; ++p )
+        t += time[ p ];
+      return t;
+    }
+
+    //! number of calls to communicate
+    std::size_t calls;
+    //! number of messages handed to the transport layer
+    std::size_t messagesSent, messagesReceived;
+    //! number of bytes in these messages
+    std::size_t bytesSent, bytesReceived;
+    //! wall clock time per phase in seconds
+    double time[ numPhases ];
+  };
+
+
+
+  // CommProfiler
+  // ------------
+
+  /** \brief collects the CommProfileData of all communications of this process
+   *
+   *  The data is keyed by the name of the grid implementation, the interface
+   *  type and the codimension.  Grids that communicate all codimensions in
+   *  one step (ALUGrid) use the codimension -1.
+   *
+   *  All data is process local; use the collective communication of the grid
+   *  to combine the numbers of several processes.
+   */
+  class CommProfiler
+  {
+  public:
+    typedef std::tuple< std::string, InterfaceType, int > Key;
+    typedef std::map< Key, CommProfileData > Map;
+    typedef Map::const_iterator Iterator;
+
+    //! true if the grids have been compiled with the profiling hooks
+    static constexpr bool enabled () { return DUNE_GRID_COMM_PROFILING != 0; }
+
+    //! the profiler instance all grids report to
+    static CommProfiler &instance ()
+    {
+      static CommProfiler profiler;
+      return profiler;
+    }
+
+    //! access the statistics for a grid, interface and codimension (created if necessary)
+    CommProfileData &data ( const std::string &grid, InterfaceType iftype, int codim )
+    {
+      return data_[ Key( grid, iftype, codim ) ];
+    }
+
+    //! return the statistics for a grid, interface and codimension (empty if there are none)
+    CommProfileData data ( const std::string &grid, InterfaceType iftype, int codim ) const
+    {
+      Iterator it = data_.find( Key( grid, iftype, codim ) );
+      return (it != data_.end() ? it->second : CommProfileData());
+    }
+
+    Iterator begin () const { return data_.begin(); }
+    Iterator end () const { return data_.end(); }
+
+    //! discard all statistics
+    void clear () { data_.clear(); }
+
+    //! write the statistics as a table, one line per grid, interface and codimension
+    void report ( std::ostream &out ) const
+    {
+      out << std::left << std::setw( 16 ) << "grid" << std::right
+          << std::setw( 4 ) << "if" << std::setw( 6 ) << "codim"
+          << std::setw( 8 ) << "calls"
+          << std::setw( 10 ) << "msg sent" << std::setw( 14 ) << "bytes sent"
+          << std::setw( 10 ) << "msg recv" << std::setw( 14 ) << "bytes recv";
+      for( int p = 0; p < CommProfileData::numPhases; ++p )
+        out << std::setw( 12 ) << CommProfileData::phaseName( p );
+      out << std::endl;
+
+      for( Iterator it = begin(); it != end(); ++it )
+      {
+        const CommProfileData &d = it->second;
+        out << std::left << std::setw( 16 ) << std::get< 0 >( it->first ) << std::right
+            << std::setw( 4 ) << int( std::get< 1 >( it->first ) ) << std::setw( 6 ) << std::get< 2 >( it->first )
+            << std::setw( 8 ) << d.calls
+            << std::setw( 10 ) << d.messagesSent << std::setw( 14 ) << d.bytesSent
+            << std::setw( 10 ) << d.messagesReceived << std::setw( 14 ) << d.bytesReceived;
+        for( int p = 0; p < CommProfileData::numPhases; ++p )
+          out << std::setw( 12 ) << d.time[ p ];
+        out << std::endl;
+      }
+    }
+
+  private:
+    CommProfiler () {}
+    CommProfiler ( const CommProfiler & );
+    CommProfiler &operator= ( const CommProfiler & );
+
+    Map data_;
+  };
+
+
+
+  // CommProfileScope
+  // ----------------
+
+  /** \brief instrumentation of one communication step
+   *
+   *  Constructing the scope counts a call and starts the size phase; each
+   *  call to phase() charges the time since the previous switch to the
+   *  current phase and starts the given one.  The destructor charges the
+   *  last phase.
+   */
+#if DUNE_GRID_COMM_PROFILING
+  inline namespace CommProfilingEnabled
+  {
+
+  class CommProfileScope
+  {
+  public:
+    CommProfileScope ( const char *grid, InterfaceType iftype, int codim )
+      : data_( CommProfiler::instance().data( grid, iftype, codim ) ),
+        phase_( CommProfileData::sizePhase )
+    {
+      ++data_.calls;
+    }
+
+    ~CommProfileScope () { data_.time[ phase_ ] += timer_.elapsed(); }
+
+    //! switch to the given phase
+    void phase ( CommProfileData::Phase p )
+    {
+      data_.time[ phase_ ] += timer_.elapsed();
+      timer_.reset();
+      phase_ = p;
+    }
+
+    //! count a message of the given size handed over for sending
+    void sent ( std::size_t bytes ) { ++data_.messagesSent; data_.bytesSent += bytes; }
+
+    //! count a message of the given size posted for receiving
+    void received ( std::size_t bytes ) { ++data_.messagesReceived; data_.bytesReceived += bytes; }
+
+  private:
+    CommProfileData &data_;
+    CommProfileData::Phase phase_;
+    Timer timer_;
+  };
+
+  } // inline namespace CommProfilingEnabled
+#else // #if DUNE_GRID_COMM_PROFILING
+  inline namespace CommProfilingDisabled
+  {
+
+  class CommProfileScope
+  {
+  public:
+    CommProfileScope ( const char *, InterfaceType, int ) {}
+
+    void phase ( CommProfileData::Phase ) {}
+    void sent ( std::size_t ) {}
+    void received ( std::size_t ) {}
+  };
+
+  } // inline namespace CommProfilingDisabled
+#endif // #else // #if DUNE_GRID_COMM_PROFILING
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_GRID_COMMON_COMMPROFILER_HH
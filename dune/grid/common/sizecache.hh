@@ -3,6 +3,7 @@
 #ifndef DUNE_SIZECACHE_HH
 #define DUNE_SIZECACHE_HH
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 #include <set>
@@ -53,6 +54,13 @@ namespace Dune {
     // stores all sizes of leafs
     mutable std::vector< int > leafTypeSizes_[nCodim];
 
+    // leaf sizes supplied by setLeafSize and not yet queried
+    mutable bool leafSupplied_[nCodim];
+
+    // number of iterations over the grid performed and avoided
+    mutable unsigned long sweeps_;
+    mutable unsigned long avoidedSweeps_;
+
     // the grid
     const GridType & grid_;
 
@@ -136,18 +144,24 @@ namespace Dune {
     SizeCache (const SizeCache & );
   public:
     /** \brief constructor taking grid reference */
-    SizeCache (const GridType & grid) : grid_( grid )
+    SizeCache (const GridType & grid)
+      : sweeps_( 0 ), avoidedSweeps_( 0 ), grid_( grid )
     {
       reset();
     }
 
-    /** \brief reset all cached sizes */
+    /** \brief reset all cached sizes
+     *
+     *  Sizes are recomputed on demand, separately for each level and
+     *  codimension.
+     */
     void reset()
     {
       for(int codim=0; codim<nCodim; ++codim)
       {
         leafSizes_[ codim ] = -1;
-        leafTypeSizes_[ codim ].resize( sizeCodim( codim ), -1 );
+        leafTypeSizes_[ codim ].assign( sizeCodim( codim ), -1 );
+        leafSupplied_[ codim ] = false;
       }
 
       const int numMxl = grid_.maxLevel()+1;
@@ -159,11 +173,47 @@ namespace Dune {
         for(int level = 0; level<numMxl; ++level)
         {
           vec[level] = -1;
-          levelTypeSizes_[codim][level].resize( sizeCodim( codim ), -1 );
+          levelTypeSizes_[codim][level].assign( sizeCodim( codim ), -1 );
         }
       }
     }
 
+    /** \brief supply the number of leaf entities of a codimension
+     *
+     *  Grids knowing their leaf sizes, e.g., from the underlying mesh,
+     *  can set them after reset() to avoid iterating over the grid.  If all
+     *  entities of the codimension have the same geometry type, the size for
+     *  this type is set as well.
+     */
+    void setLeafSize ( int codim, int size )
+    {
+      assert( (codim >= 0) && (codim < nCodim) );
+      leafSizes_[ codim ] = size;
+      leafSupplied_[ codim ] = true;
+
+      std::vector< int > &typeSizes = leafTypeSizes_[ codim ];
+      const int type = uniqueTypeIndex( codim );
+      if( type >= 0 )
+      {
+        std::fill( typeSizes.begin(), typeSizes.end(), 0 );
+        typeSizes[ type ] = size;
+      }
+      else
+        std::fill( typeSizes.begin(), typeSizes.end(), -1 );
+    }
+
+    /** \brief number of iterations over the grid performed to compute sizes */
+    unsigned long sweeps () const { return sweeps_; }
+
+    /** \brief number of size queries answered from supplied sizes that
+     *         would have required an iteration over the grid
+     *
+     *  Only grids calling setLeafSize() avoid sweeps; so far, this is
+     *  AlbertaGrid.  The counters live as long as the SizeCache, so grids
+     *  creating a new cache after adaptation (e.g., ALUGrid) restart them.
+     */
+    unsigned long avoidedSweeps () const { return avoidedSweeps_; }
+
     //********************************************************************
     // level sizes
     //********************************************************************
@@ -188,7 +238,9 @@ namespace Dune {
     int size (int level, GeometryType type) const
     {
       const int codim = GridType ::dimension - type.dim();
-      if( levelSizes_[codim][level] < 0)
+      if( level >= (int) levelSizes_[codim].size() ) return 0;
+
+      if( levelTypeSizes_[codim][level][gtIndex( type )] < 0)
         ForLoop< CountLevelEntities, 0, dim > :: apply( *this, level, codim );
 
       assert( levelTypeSizes_[codim][level][gtIndex( type )] >= 0 );
@@ -205,6 +257,8 @@ namespace Dune {
       assert( codim < nCodim );
       if( leafSizes_[codim] < 0 )
         ForLoop< CountLeafEntities, 0, dim > :: apply( *this, codim );
+      else
+        useSupplied( codim );
 
       assert( leafSizes_[codim] >= 0 );
       return leafSizes_[codim];
@@ -214,14 +268,45 @@ namespace Dune {
     int size ( const GeometryType type ) const
     {
       const int codim = GridType :: dimension - type.dim();
-      if( leafSizes_[codim] < 0 )
+      if( leafTypeSizes_[codim][ gtIndex( type )] < 0 )
         ForLoop< CountLeafEntities, 0, dim > :: apply( *this, codim );
+      else
+        useSupplied( codim );
 
       assert( leafTypeSizes_[codim][ gtIndex( type )] >= 0 );
       return leafTypeSizes_[codim][ gtIndex( type )];
     }
 
   private:
+    // count the first query of a supplied size as an avoided sweep
+    void useSupplied ( int codim ) const
+    {
+      if( leafSupplied_[ codim ] )
+      {
+        leafSupplied_[ codim ] = false;
+        ++avoidedSweeps_;
+      }
+    }
+
+    // index of the geometry type shared by all entities of a codimension, or -1
+    int uniqueTypeIndex ( int codim ) const
+    {
+      if( sizeCodim( codim ) == 1 )
+        return 0;
+      if( !Capabilities :: hasSingleGeometryType< GridType > :: v )
+        return -1;
+
+      const GeometryType type( Capabilities :: hasSingleGeometryType< GridType > :: topologyId, dim );
+      const ReferenceElement< ctype, dim > &refElem = ReferenceElements< ctype, dim > :: general( type );
+      const GeometryType subType = refElem.type( 0, codim );
+      for( int i = 1; i < refElem.size( codim ); ++i )
+      {
+        if( refElem.type( i, codim ) != subType )
+          return -1;
+      }
+      return gtIndex( subType );
+    }
+
     template <PartitionIteratorType pitype, int codim>
     void countLevelEntities(int level) const
     {
@@ -231,6 +316,7 @@ namespace Dune {
       Iterator it  = gridView.template begin<codim,pitype> ();
       Iterator end = gridView.template end<codim,pitype>   ();
       levelSizes_[codim][level] = countElements(it,end, levelTypeSizes_[codim][level]);
+      ++sweeps_;
     }
 
     template <PartitionIteratorType pitype, int codim>
@@ -243,6 +329,8 @@ namespace Dune {
       Iterator it  = gridView.template begin<codim,pitype> ();
       Iterator end = gridView.template end<codim,pitype>   ();
       leafSizes_[codim] = countElements(it,end, leafTypeSizes_[codim] );
+      leafSupplied_[codim] = false;
+      ++sweeps_;
     }
 
     // counts entities with given type for given iterator
@@ -275,6 +363,7 @@ namespace Dune {
       Iterator it  = gridView.template begin< 0, pitype> ();
       Iterator end = gridView.template end< 0, pitype>   ();
       levelSizes_[codim][level] = countElementsNoCodim< codim >(it,end, levelTypeSizes_[codim][level]);
+      ++sweeps_;
     }
 
     template <PartitionIteratorType pitype, int codim>
@@ -287,6 +376,8 @@ namespace Dune {
       Iterator it  = gridView.template begin< 0, pitype > ();
       Iterator end = gridView.template end< 0, pitype >   ();
       leafSizes_[codim] = countElementsNoCodim< codim >(it,end, leafTypeSizes_[codim] );
+      leafSupplied_[codim] = false;
+      ++sweeps_;
     }
 
     // counts entities with given type for given iterator
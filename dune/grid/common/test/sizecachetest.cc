@@ -0,0 +1,249 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+/** \file
+    \brief A unit test for the SizeCache
+ */
+
+#include <config.h>
+
+#include <bitset>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/geometry/referenceelements.hh>
+#include <dune/geometry/type.hh>
+
+#include <dune/grid/common/capabilities.hh>
+#include <dune/grid/common/sizecache.hh>
+#include <dune/grid/yaspgrid.hh>
+
+#if HAVE_UG
+#include <dune/grid/uggrid.hh>
+#include "../../../../doc/grids/gridfactory/hybridtestgrids.hh"
+#endif
+
+using namespace Dune;
+
+// /////////////////////////////////////////////////////////////////////////////////
+//   Count the entities of a codimension per geometry type by iterating over
+//   the elements of a grid view.
+// /////////////////////////////////////////////////////////////////////////////////
+template <class GridView>
+std::map<GeometryType, int> countEntities(const GridView& gridView, int codim)
+{
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  typedef typename GridView::IndexSet::IndexType Index;
+  const int dim = GridView::dimension;
+
+  std::map<GeometryType, std::set<Index> > indices;
+  const Iterator end = gridView.template end<0>();
+  for (Iterator it = gridView.template begin<0>(); it != end; ++it)
+  {
+    const ReferenceElement<typename GridView::ctype, dim>& refElement
+      = ReferenceElements<typename GridView::ctype, dim>::general(it->type());
+    for (int i = 0; i < refElement.size(codim); ++i)
+      indices[refElement.type(i, codim)].insert(gridView.indexSet().subIndex(*it, i, codim));
+  }
+
+  std::map<GeometryType, int> sizes;
+  typedef typename std::map<GeometryType, std::set<Index> >::const_iterator MapIterator;
+  for (MapIterator it = indices.begin(); it != indices.end(); ++it)
+    sizes[it->first] = it->second.size();
+  return sizes;
+}
+
+// all geometry types of a dimension the SizeCache distinguishes
+std::vector<GeometryType> geometryTypes(int mydim)
+{
+  std::vector<GeometryType> types;
+  for (unsigned int topologyId = 0; topologyId < (1u << mydim); topologyId += 2)
+    types.push_back(GeometryType(topologyId, mydim));
+  return types;
+}
+
+int totalSize(const std::map<GeometryType, int>& sizes)
+{
+  int total = 0;
+  for (std::map<GeometryType, int>::const_iterator it = sizes.begin(); it != sizes.end(); ++it)
+    total += it->second;
+  return total;
+}
+
+int typeSize(const std::map<GeometryType, int>& sizes, const GeometryType& type)
+{
+  std::map<GeometryType, int>::const_iterator it = sizes.find(type);
+  return (it != sizes.end() ? it->second : 0);
+}
+
+template <class Cache>
+void checkSweeps(const Cache& cache, unsigned long sweeps, unsigned long avoidedSweeps)
+{
+  if (cache.sweeps() != sweeps)
+    DUNE_THROW(GridError, "SizeCache performed " << cache.sweeps() << " sweeps instead of " << sweeps << ".");
+  if (cache.avoidedSweeps() != avoidedSweeps)
+    DUNE_THROW(GridError, "SizeCache avoided " << cache.avoidedSweeps() << " sweeps instead of " << avoidedSweeps << ".");
+}
+
+// /////////////////////////////////////////////////////////////////////////////////
+//   Compare the lazily computed sizes with a full iteration and check that
+//   each (level, codim) pair and each leaf codimension is counted only once.
+// /////////////////////////////////////////////////////////////////////////////////
+template <class Grid>
+void checkLazySizes(const Grid& grid, SizeCache<Grid>& cache)
+{
+  const int dim = Grid::dimension;
+
+  cache.reset();
+  unsigned long sweeps = cache.sweeps();
+  const unsigned long avoidedSweeps = cache.avoidedSweeps();
+
+  for (int level = 0; level <= grid.maxLevel(); ++level)
+  {
+    for (int codim = 0; codim <= dim; ++codim)
+    {
+      const std::map<GeometryType, int> sizes = countEntities(grid.levelGridView(level), codim);
+      const std::vector<GeometryType> types = geometryTypes(dim - codim);
+
+      // type queries first, the total must not trigger a second sweep
+      for (std::size_t i = 0; i < types.size(); ++i)
+      {
+        if (cache.size(level, types[i]) != typeSize(sizes, types[i]))
+          DUNE_THROW(GridError, "Wrong level size for type " << types[i] << " on level " << level << ".");
+      }
+      if (cache.size(level, codim) != totalSize(sizes))
+        DUNE_THROW(GridError, "Wrong level size for codimension " << codim << " on level " << level << ".");
+      checkSweeps(cache, ++sweeps, avoidedSweeps);
+    }
+  }
+  // levels above maxLevel are empty and need no sweep
+  if (cache.size(grid.maxLevel()+1, 0) != 0)
+    DUNE_THROW(GridError, "Nonzero size above the maximum level.");
+
+  for (int codim = 0; codim <= dim; ++codim)
+  {
+    const std::map<GeometryType, int> sizes = countEntities(grid.leafGridView(), codim);
+    const std::vector<GeometryType> types = geometryTypes(dim - codim);
+
+    // total first, the type queries must not trigger a second sweep
+    if (cache.size(codim) != totalSize(sizes))
+      DUNE_THROW(GridError, "Wrong leaf size for codimension " << codim << ".");
+    for (std::size_t i = 0; i < types.size(); ++i)
+    {
+      if (cache.size(types[i]) != typeSize(sizes, types[i]))
+        DUNE_THROW(GridError, "Wrong leaf size for type " << types[i] << ".");
+    }
+    checkSweeps(cache, ++sweeps, avoidedSweeps);
+  }
+}
+
+// /////////////////////////////////////////////////////////////////////////////////
+//   Check that supplied leaf sizes are used without iterating the grid.
+//   Type sizes can only be derived if all entities of a codimension have the
+//   same type; otherwise the first type query iterates the grid once.
+// /////////////////////////////////////////////////////////////////////////////////
+template <class Grid>
+void checkSuppliedSizes(const Grid& grid, SizeCache<Grid>& cache)
+{
+  const int dim = Grid::dimension;
+
+  cache.reset();
+  std::map<GeometryType, int> sizes[dim+1];
+  for (int codim = 0; codim <= dim; ++codim)
+  {
+    sizes[codim] = countEntities(grid.leafGridView(), codim);
+    cache.setLeafSize(codim, totalSize(sizes[codim]));
+  }
+
+  unsigned long sweeps = cache.sweeps();
+  unsigned long avoidedSweeps = cache.avoidedSweeps();
+  for (int codim = 0; codim <= dim; ++codim)
+  {
+    const std::vector<GeometryType> types = geometryTypes(dim - codim);
+    const bool uniqueType = (types.size() == 1) || Capabilities::hasSingleGeometryType<Grid>::v;
+
+    // only the first query of a supplied size counts as avoided sweep
+    if ((cache.size(codim) != totalSize(sizes[codim])) || (cache.size(codim) != totalSize(sizes[codim])))
+      DUNE_THROW(GridError, "Supplied leaf size for codimension " << codim << " not returned.");
+    checkSweeps(cache, sweeps, ++avoidedSweeps);
+
+    for (std::size_t i = 0; i < types.size(); ++i)
+    {
+      if (cache.size(types[i]) != typeSize(sizes[codim], types[i]))
+        DUNE_THROW(GridError, "Wrong leaf size for type " << types[i] << " after setLeafSize.");
+    }
+    checkSweeps(cache, (uniqueType ? sweeps : ++sweeps), avoidedSweeps);
+  }
+}
+
+template <class Grid>
+void checkSizeCache(const Grid& grid)
+{
+  SizeCache<Grid> cache(grid);
+  checkSweeps(cache, 0, 0);
+
+  checkLazySizes(grid, cache);
+  checkSuppliedSizes(grid, cache);
+
+  // lazy computation must work again after supplied sizes
+  checkLazySizes(grid, cache);
+}
+
+int main(int argc, char** argv)
+try
+{
+  // initialize MPI if neccessary
+  Dune::MPIHelper::instance(argc, argv);
+
+  // grids with a single geometry type
+  {
+    typedef YaspGrid<2> Grid;
+    Dune::array<int, 2> cells = {{ 3, 2 }};
+    Grid grid(FieldVector<double, 2>(1.0), cells, std::bitset<2>(), 0);
+    grid.globalRefine(1);
+    checkSizeCache(grid);
+  }
+
+  {
+    typedef YaspGrid<3> Grid;
+    Dune::array<int, 3> cells = {{ 2, 1, 3 }};
+    Grid grid(FieldVector<double, 3>(1.0), cells, std::bitset<3>(), 0);
+    checkSizeCache(grid);
+  }
+
+#if HAVE_UG
+  // grids with more than one element type
+  {
+    typedef UGGrid<2> Grid;
+    std::unique_ptr<Grid> grid(make2DHybridTestGrid<Grid>());
+    grid->mark(1, * grid->leafbegin<0>());
+    grid->adapt();
+    checkSizeCache(*grid);
+  }
+
+  {
+    typedef UGGrid<3> Grid;
+    std::unique_ptr<Grid> grid(make3DHybridTestGrid<Grid>());
+    grid->mark(1, * grid->leafbegin<0>());
+    grid->adapt();
+    checkSizeCache(*grid);
+  }
+#endif
+
+  return EXIT_SUCCESS;
+}
+catch (Exception &e) {
+  std::cerr << e << std::endl;
+  return 1;
+} catch (...) {
+  std::cerr << "Generic exception!" << std::endl;
+  return 2;
+}
@@ -3,15 +3,23 @@
 #ifndef DUNE_GEOGRID_CACHEDCOORDFUNCTION_HH
 #define DUNE_GEOGRID_CACHEDCOORDFUNCTION_HH
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <exception>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include <dune/common/fvector.hh>
 #include <dune/common/typetraits.hh>
 
 #include <dune/grid/common/gridenums.hh>
 
 #include <dune/grid/geometrygrid/capabilities.hh>
 #include <dune/grid/geometrygrid/coordfunctioncaller.hh>
+#include <dune/grid/geometrygrid/hostcorners.hh>
 #include <dune/grid/utility/persistentcontainer.hh>
 
 namespace Dune
@@ -31,6 +39,21 @@ namespace Dune
   namespace GeoGrid
   {
 
+    //! state of a coordinate cache entry
+    enum CoordCacheState { invalidCoordinate, pendingCoordinate, validCoordinate };
+
+    template< class Coordinate, class HostCoordinate >
+    struct CoordCacheEntry
+    {
+      CoordCacheEntry () : state( invalidCoordinate ) {}
+
+      Coordinate coordinate;
+      HostCoordinate hostCoordinate;
+      CoordCacheState state;
+    };
+
+
+
     template< class HostGrid, class Coordinate >
     class CoordCache
     {
@@ -40,7 +63,14 @@ namespace Dune
 
       typedef typename HostGrid::template Codim< dimension >::Entity Vertex;
 
-      typedef PersistentContainer< HostGrid, Coordinate > DataCache;
+    public:
+      //! type of the host corner an entry was evaluated for
+      typedef FieldVector< typename HostGrid::ctype, HostGrid::dimensionworld > HostCoordinate;
+
+      typedef CoordCacheEntry< Coordinate, HostCoordinate > Entry;
+
+    private:
+      typedef PersistentContainer< HostGrid, Entry > DataCache;
 
     public:
       explicit CoordCache ( const HostGrid &hostGrid )
@@ -50,29 +80,61 @@ namespace Dune
       template< class Entity >
       const Coordinate &operator() ( const Entity &entity, unsigned int corner ) const
       {
-        return data_( entity, corner );
+        return data_( entity, corner ).coordinate;
       }
 
       const Coordinate &operator() ( const Vertex &vertex, unsigned int corner ) const
       {
         assert( corner == 0 );
-        return data_[ vertex ];
+        return data_[ vertex ].coordinate;
       }
 
       template< class Entity >
       Coordinate &operator() ( const Entity &entity, unsigned int corner )
       {
-        return data_( entity,corner) ;
+        return data_( entity, corner ).coordinate;
       }
 
       Coordinate &operator() ( const Vertex &vertex, unsigned int corner )
       {
         assert( corner == 0 );
-        return data_[ vertex ];
+        return data_[ vertex ].coordinate;
+      }
+
+      /** \brief obtain the entry of a corner if its coordinate has to be computed
+       *
+       *  An entry is up to date if it is valid and was computed for the same
+       *  host corner.  Comparing the host corner detects slots that the host
+       *  grid handed to a different vertex during adaptation (index based
+       *  persistent containers reuse the indices of removed vertices).
+       *
+       *  \returns a pointer to the entry to fill or 0, if the coordinate is
+       *           cached or already pending
+       *
+       *  \note The entry is marked as pending by this method.  The caller is
+       *        responsible for filling in the coordinate and marking it valid,
+       *        or marking it invalid if the evaluation fails.
+       **/
+      template< class Entity >
+      Entry *invalidEntry ( const Entity &entity, unsigned int corner, const HostCoordinate &hostCoordinate )
+      {
+        Entry &entry = data_( entity, corner );
+        if( (entry.state != invalidCoordinate) && (entry.hostCoordinate == hostCoordinate) )
+          return 0;
+        entry.state = pendingCoordinate;
+        entry.hostCoordinate = hostCoordinate;
+        return &entry;
+      }
+
+      //! mark all coordinates as invalid
+      void invalidate ()
+      {
+        data_.fill( Entry() );
       }
 
       void adapt ()
       {
+        // newly created slots are invalid; reused slots are detected by invalidEntry
         data_.resize();
         data_.shrinkToFit();
       }
@@ -84,6 +146,213 @@ namespace Dune
       DataCache data_;
     };
 
+
+
+    // CoordCacheBuilder
+    // -----------------
+
+    template< class CoordFunctionInterface >
+    class CoordCacheBuilder;
+
+    /** \brief fills a coordinate cache from an analytical coordinate function
+     *
+     *  The host corners of all invalid cache entries are collected and
+     *  evaluated in chunks through AnalyticalCoordFunctionInterface::evaluateBatch.
+     *  With more than one thread, each chunk is split into one contiguous
+     *  part per thread and the parts are evaluated concurrently; the
+     *  coordinate function has to support concurrent calls to evaluateBatch
+     *  in this case.  The grid traversal itself remains sequential.
+     *
+     *  Entries become valid only after their chunk has been evaluated
+     *  successfully; if evaluateBatch throws, they are marked invalid again.
+     */
+    template< class ct, unsigned int dimD, unsigned int dimR, class Impl >
+    class CoordCacheBuilder< AnalyticalCoordFunctionInterface< ct, dimD, dimR, Impl > >
+    {
+      typedef AnalyticalCoordFunctionInterface< ct, dimD, dimR, Impl > CoordFunctionInterface;
+      typedef CoordCacheBuilder< CoordFunctionInterface > This;
+
+    public:
+      typedef typename CoordFunctionInterface::DomainVector DomainVector;
+      typedef typename CoordFunctionInterface::RangeVector RangeVector;
+
+      //! number of points evaluated per thread and chunk
+      static const std::size_t chunkSize = 4096;
+
+      explicit CoordCacheBuilder ( const CoordFunctionInterface &coordFunction, unsigned int numThreads = 1 )
+        : coordFunction_( coordFunction ),
+          numThreads_( std::max( numThreads, 1u ) )
+      {
+        x_.reserve( chunkSize*numThreads_ );
+        target_.reserve( chunkSize*numThreads_ );
+      }
+
+      template< class HostEntity, class Cache >
+      void insert ( const HostEntity &hostEntity, Cache &cache )
+      {
+        const HostCorners< HostEntity > hostCorners( hostEntity );
+        const std::size_t numCorners = hostCorners.size();
+        for( std::size_t i = 0; i < numCorners; ++i )
+        {
+          const DomainVector x = hostCorners[ i ];
+          typename Cache::Entry *target = cache.invalidEntry( hostEntity, i, x );
+          if( !target )
+            continue;
+
+          x_.push_back( x );
+          target_.push_back( Target( &target->coordinate, &target->state ) );
+          if( x_.size() == chunkSize*numThreads_ )
+            flush();
+        }
+      }
+
+      void flush ()
+      {
+        if( x_.empty() )
+          return;
+
+        try
+        {
+          evaluate();
+        }
+        catch( ... )
+        {
+          for( std::size_t i = 0; i < target_.size(); ++i )
+            *target_[ i ].second = invalidCoordinate;
+          x_.clear();
+          target_.clear();
+          throw;
+        }
+
+        for( std::size_t i = 0; i < target_.size(); ++i )
+        {
+          *target_[ i ].first = y_[ i ];
+          *target_[ i ].second = validCoordinate;
+        }
+        x_.clear();
+        target_.clear();
+      }
+
+    private:
+      typedef std::pair< RangeVector *, CoordCacheState * > Target;
+
+      CoordCacheBuilder ( const This & );
+      This &operator= ( const This & );
+
+      // evaluate all collected points into y_
+      void evaluate ()
+      {
+        const std::size_t size = x_.size();
+        const std::size_t numParts = std::min< std::size_t >( numThreads_, (size + chunkSize - 1) / chunkSize );
+        if( numParts <= 1 )
+        {
+          coordFunction_.evaluateBatch( x_, y_ );
+          assert( y_.size() == size );
+          return;
+        }
+
+        y_.resize( size );
+        std::vector< std::exception_ptr > errors( numParts );
+        std::vector< std::thread > threads;
+        threads.reserve( numParts-1 );
+
+        auto evaluatePart = [ this, &errors, size, numParts ] ( std::size_t part ) {
+          try
+          {
+            const std::size_t begin = size * part / numParts, end = size * (part+1) / numParts;
+            const std::vector< DomainVector > x( x_.begin() + begin, x_.begin() + end );
+            std::vector< RangeVector > y;
+            coordFunction_.evaluateBatch( x, y );
+            assert( y.size() == x.size() );
+            std::copy( y.begin(), y.end(), y_.begin() + begin );
+          }
+          catch( ... )
+          {
+            errors[ part ] = std::current_exception();
+          }
+        };
+
+        // join all started threads, even if starting one of them fails
+        try
+        {
+          for( std::size_t part = 1; part < numParts; ++part )
+            threads.push_back( std::thread( evaluatePart, part ) );
+        }
+        catch( ... )
+        {
+          for( std::size_t i = 0; i < threads.size(); ++i )
+            threads[ i ].join();
+          throw;
+        }
+        evaluatePart( 0 );
+        for( std::size_t i = 0; i < threads.size(); ++i )
+          threads[ i ].join();
+
+        for( std::size_t part = 0; part < numParts; ++part )
+        {
+          if( errors[ part ] )
+            std::rethrow_exception( errors[ part ] );
+        }
+      }
+
+      const CoordFunctionInterface &coordFunction_;
+      unsigned int numThreads_;
+      std::vector< DomainVector > x_;
+      std::vector< RangeVector > y_;
+      std::vector< Target > target_;
+    };
+
+    /** \brief fills a coordinate cache from a discrete coordinate function
+     *
+     *  Discrete coordinate functions are evaluated per host entity, so the
+     *  evaluation is sequential.
+     */
+    template< class ct, unsigned int dimR, class Impl >
+    class CoordCacheBuilder< DiscreteCoordFunctionInterface< ct, dimR, Impl > >
+    {
+      typedef DiscreteCoordFunctionInterface< ct, dimR, Impl > CoordFunctionInterface;
+      typedef CoordCacheBuilder< CoordFunctionInterface > This;
+
+    public:
+      typedef typename CoordFunctionInterface::RangeVector RangeVector;
+
+      explicit CoordCacheBuilder ( const CoordFunctionInterface &coordFunction, unsigned int = 1 )
+        : coordFunction_( coordFunction )
+      {}
+
+      template< class HostEntity, class Cache >
+      void insert ( const HostEntity &hostEntity, Cache &cache )
+      {
+        const HostCorners< HostEntity > hostCorners( hostEntity );
+        const std::size_t numCorners = hostCorners.size();
+        for( std::size_t i = 0; i < numCorners; ++i )
+        {
+          typename Cache::Entry *target = cache.invalidEntry( hostEntity, i, hostCorners[ i ] );
+          if( !target )
+            continue;
+
+          try
+          {
+            coordFunction_.evaluate( hostEntity, i, target->coordinate );
+          }
+          catch( ... )
+          {
+            target->state = invalidCoordinate;
+            throw;
+          }
+          target->state = validCoordinate;
+        }
+      }
+
+      void flush () {}
+
+    private:
+      CoordCacheBuilder ( const This & );
+      This &operator= ( const This & );
+
+      const CoordFunctionInterface &coordFunction_;
+    };
+
   } // namespace GeoGrid
 
 
@@ -105,25 +374,50 @@ namespace Dune
 
   private:
     typedef GeoGrid::CoordCache< HostGrid, RangeVector > Cache;
+    typedef GeoGrid::CoordCacheBuilder< typename CoordFunction::Interface > CacheBuilder;
 
   public:
+    /** \brief constructor
+     *
+     *  \param[in]  hostGrid       host grid whose vertices are cached
+     *  \param[in]  coordFunction  coordinate function to cache
+     *  \param[in]  numThreads     number of threads evaluating an analytical
+     *                             coordinate function (the function has to
+     *                             allow concurrent calls to evaluateBatch if
+     *                             this is larger than 1)
+     */
     explicit
     CachedCoordFunction ( const HostGrid &hostGrid,
-                          const CoordFunction &coordFunction = CoordFunction() )
+                          const CoordFunction &coordFunction = CoordFunction(),
+                          unsigned int numThreads = 1 )
       : hostGrid_( hostGrid ),
         coordFunction_( coordFunction ),
+        numThreads_( numThreads ),
         cache_( hostGrid )
     {
-      buildCache();
+      updateCache();
     }
 
+    /** \brief update the cache after adaptation of the host grid
+     *
+     *  Only the coordinates of vertices created during the last adaptation
+     *  cycle are evaluated.
+     */
     void adapt ()
     {
       cache_.adapt();
-      buildCache();
+      updateCache();
+    }
+
+    /** \brief evaluate the coordinate function for all vertices of the host grid */
+    void buildCache ()
+    {
+      cache_.invalidate();
+      updateCache();
     }
 
-    void buildCache ();
+    /** \brief evaluate the coordinate function for all vertices not cached, yet */
+    void updateCache ();
 
     template< class HostEntity >
     void insertEntity ( const HostEntity &hostEntity );
@@ -146,6 +440,7 @@ namespace Dune
   private:
     const HostGrid &hostGrid_;
     const CoordFunction &coordFunction_;
+    unsigned int numThreads_;
     Cache cache_;
   };
 
@@ -155,7 +450,7 @@ namespace Dune
   // -------------------------------------
 
   template< class HostGrid, class CoordFunction >
-  inline void CachedCoordFunction< HostGrid, CoordFunction >::buildCache ()
+  inline void CachedCoordFunction< HostGrid, CoordFunction >::updateCache ()
   {
     typedef typename HostGrid::template Codim< 0 >::Entity Element;
     typedef typename HostGrid::LevelGridView MacroView;
@@ -166,16 +461,19 @@ namespace Dune
     const MacroView macroView = hostGrid_.levelGridView( 0 );
     const int maxLevel = hostGrid_.maxLevel();
 
+    CacheBuilder builder( coordFunction_, numThreads_ );
+
     const MacroIterator mend = macroView.template end< 0, All_Partition >();
     for( MacroIterator mit = macroView.template begin< 0, All_Partition >(); mit != mend; ++mit )
     {
       const Element &macroElement = *mit;
-      insertEntity( macroElement );
+      builder.insert( macroElement, cache_ );
 
       const HierarchicIterator hend = macroElement.hend( maxLevel );
       for( HierarchicIterator hit = macroElement.hbegin( maxLevel ); hit != hend; ++hit )
-        insertEntity( *hit );
+        builder.insert( *hit, cache_ );
     }
+    builder.flush();
   }
 
 
@@ -184,16 +482,9 @@ namespace Dune
   inline void CachedCoordFunction< HostGrid, CoordFunction >
     ::insertEntity ( const HostEntity &hostEntity )
   {
-    typedef GeoGrid::CoordFunctionCaller< HostEntity, typename CoordFunction::Interface >
-    CoordFunctionCaller;
-
-    CoordFunctionCaller coordFunctionCaller( hostEntity, coordFunction_ );
-    const ReferenceElement< ctype, HostEntity::dimension > &refElement
-      = ReferenceElements< ctype, HostEntity::dimension >::general( hostEntity.type() );
-
-    const unsigned int numCorners = refElement.size( HostEntity::dimension );
-    for( unsigned int i = 0; i < numCorners; ++i )
-      coordFunctionCaller.evaluate( i, cache_( hostEntity, i ) );
+    CacheBuilder builder( coordFunction_ );
+    builder.insert( hostEntity, cache_ );
+    builder.flush();
   }
 
 } // namespace Dune
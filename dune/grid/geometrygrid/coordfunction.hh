@@ -3,6 +3,9 @@
 #ifndef DUNE_GEOGRID_COORDFUNCTION_HH
 #define DUNE_GEOGRID_COORDFUNCTION_HH
 
+#include <cstddef>
+#include <vector>
+
 #include <dune/common/fvector.hh>
 
 namespace Dune
@@ -72,6 +75,20 @@ namespace Dune
       return asImp().evaluate( x, y );
     }
 
+    /** \brief evaluate the global mapping for a batch of points
+     *
+     *  \param[in]   x  points to evaluate the mapping in
+     *  \param[out]  y  images of the points (resized to the size of x)
+     *
+     *  \note The default implementation simply calls evaluate for each point.
+     *        Implementations may override this method to vectorize (or
+     *        parallelize) the evaluation over the batch.
+     **/
+    void evaluateBatch ( const std::vector< DomainVector > &x, std::vector< RangeVector > &y ) const
+    {
+      asImp().evaluateBatch( x, y );
+    }
+
   protected:
     const Implementation &asImp () const
     {
@@ -102,6 +119,15 @@ namespace Dune
     typedef typename Base :: DomainVector DomainVector;
     typedef typename Base :: RangeVector RangeVector;
 
+    //! default implementation of the batched evaluation (calls evaluate for each point)
+    void evaluateBatch ( const std::vector< DomainVector > &x, std::vector< RangeVector > &y ) const
+    {
+      const std::size_t size = x.size();
+      y.resize( size );
+      for( std::size_t i = 0; i < size; ++i )
+        this->asImp().evaluate( x[ i ], y[ i ] );
+    }
+
   protected:
     AnalyticalCoordFunction ()
     {}
@@ -3,6 +3,8 @@
 #ifndef DUNE_GEOGRID_IDENTITY_HH
 #define DUNE_GEOGRID_IDENTITY_HH
 
+#include <vector>
+
 #include <dune/grid/geometrygrid/coordfunction.hh>
 
 namespace Dune
@@ -24,6 +26,11 @@ namespace Dune
     {
       y = x;
     }
+
+    void evaluateBatch ( const std::vector< DomainVector > &x, std::vector< RangeVector > &y ) const
+    {
+      y.assign( x.begin(), x.end() );
+    }
   };
 
 }
@@ -0,0 +1,100 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_IO_FILE_BUFFEREDOUTPUTFILE_HH
+#define DUNE_GRID_IO_FILE_BUFFEREDOUTPUTFILE_HH
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+/** \file
+ *  \brief output file with a large stream buffer and collective appending of rank data
+ */
+
+namespace Dune
+{
+
+  // BufferedOutputFile
+  // ------------------
+
+  /** \brief std::ofstream writing through a stream buffer of its own
+   *
+   *  The buffer is a member declared before the stream, so it outlives the
+   *  stream and the final flush on destruction.  Whether the file could be
+   *  opened is reported by is_open() or the state of stream().
+   */
+  class BufferedOutputFile
+  {
+  public:
+    //! default size of the stream buffer (1 MiB)
+    static const std::size_t defaultBufferSize = 1 << 20;
+
+    explicit BufferedOutputFile ( const std::string &fileName,
+                                  std::ios_base::openmode mode = std::ios_base::out,
+                                  std::size_t bufferSize = defaultBufferSize )
+      : buffer_( bufferSize )
+    {
+      // the buffer has to be installed before the file is opened
+      stream_.rdbuf()->pubsetbuf( buffer_.data(), buffer_.size() );
+      stream_.open( fileName.c_str(), mode );
+    }
+
+    ~BufferedOutputFile () { stream_.close(); }
+
+    bool is_open () const { return stream_.is_open(); }
+
+    std::ofstream &stream () { return stream_; }
+
+  private:
+    BufferedOutputFile ( const BufferedOutputFile & );
+    BufferedOutputFile &operator= ( const BufferedOutputFile & );
+
+    std::vector< char > buffer_;
+    std::ofstream stream_;
+  };
+
+
+
+  // appendInRankOrder
+  // -----------------
+
+  /** \brief append the data of all ranks to a file, one rank after the other
+   *
+   *  If truncate is true, rank 0 starts a new file.  This function is
+   *  collective: the writing rank broadcasts whether it succeeded before the
+   *  next rank starts, so a failure throws an IOError on all ranks.
+   *
+   *  \param[in]  comm      collective communication of the grid view
+   *  \param[in]  fileName  name of the file
+   *  \param[in]  data      data of this rank
+   *  \param[in]  truncate  true if rank 0 should start a new file
+   *  \param[in]  mode      additional open mode flags (e.g., std::ios_base::binary)
+   */
+  template< class Communication >
+  inline void appendInRankOrder ( const Communication &comm, const std::string &fileName,
+                                  const std::string &data, bool truncate,
+                                  std::ios_base::openmode mode = std::ios_base::openmode() )
+  {
+    for( int rank = 0; rank < comm.size(); ++rank )
+    {
+      int success = 1;
+      if( rank == comm.rank() )
+      {
+        const std::ios_base::openmode append = ((truncate && (rank == 0)) ? std::ios_base::trunc : std::ios_base::app);
+        BufferedOutputFile file( fileName, std::ios_base::out | append | mode );
+        file.stream().write( data.data(), data.size() );
+        file.stream().close();
+        success = (file.stream() ? 1 : 0);
+      }
+      comm.broadcast( &success, 1, rank );
+      if( !success )
+        DUNE_THROW( IOError, "Could not write to " << fileName << " on rank " << rank << "." );
+    }
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_GRID_IO_FILE_BUFFEREDOUTPUTFILE_HH
@@ -0,0 +1,450 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_IO_FILE_CHECKPOINTFILE_HH
+#define DUNE_GRID_IO_FILE_CHECKPOINTFILE_HH
+
+/** \file
+ *  \brief Binary checkpoint files written collectively by all processes
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+
+// bump this version number up if you introduce any changes
+// to the layout of the checkpoint file
+#define DUNE_CHECKPOINTFILE_FORMAT_VERSION 1
+
+namespace Dune
+{
+
+  namespace CheckpointFile
+  {
+
+    //! magic number identifying a checkpoint file
+    static const char magic[ 8 ] = { 'D', 'U', 'N', 'E', 'C', 'K', 'P', 'T' };
+
+    //! type used to store sizes and offsets in the file
+    typedef unsigned long long Offset;
+
+    //! MPI-IO counts are limited to int, so large blocks are transferred in chunks
+    static const std::size_t chunkSize = std::size_t( 1 ) << 30;
+
+    //! size of the file header for a given number of processes
+    inline std::size_t headerSize ( int size )
+    {
+      return sizeof( magic ) + 2*sizeof( unsigned int ) + (size+1)*sizeof( Offset );
+    }
+
+    inline void throwOnMismatch ( unsigned int version, int size, int commSize, const std::string &filename )
+    {
+      if( version != DUNE_CHECKPOINTFILE_FORMAT_VERSION )
+        DUNE_THROW( IOError, "Checkpoint file '" << filename << "' has unsupported format version " << version << "." );
+      if( size != commSize )
+        DUNE_THROW( IOError, "Checkpoint file '" << filename << "' was written by " << size
+                                                 << " processes, but is restored on " << commSize << " processes." );
+    }
+
+
+
+    // Generic (sequential) file access
+    // --------------------------------
+
+    /** \brief write the rank blocks into a single file (generic fallback)
+     *
+     *  The processes take turns writing their block at its offset. This is
+     *  only meant for communicators without parallel file access. After each
+     *  turn, the processes agree on whether the writing rank succeeded, so a
+     *  failure throws an IOError on all ranks.
+     */
+    template< class Comm >
+    inline void write ( const std::string &filename, const Comm &comm,
+                        const std::vector< char > &header, const std::vector< char > &block, Offset offset )
+    {
+      for( int rank = 0; rank < comm.size(); ++rank )
+      {
+        int success = 1;
+        if( rank == comm.rank() )
+        {
+          std::ios_base::openmode mode = std::ios_base::out | std::ios_base::binary;
+          if( rank > 0 )
+            mode |= std::ios_base::in;
+          std::fstream file( filename.c_str(), mode );
+          if( rank == 0 )
+            file.write( header.data(), header.size() );
+          file.seekp( offset );
+          file.write( block.data(), block.size() );
+          file.close();
+          success = (file ? 1 : 0);
+        }
+        if( !comm.min( success ) )
+          DUNE_THROW( IOError, "Could not write checkpoint file '" << filename << "' on rank " << rank << "." );
+      }
+    }
+
+    //! read the block of this process from a single file (generic fallback)
+    template< class Comm >
+    inline void read ( const std::string &filename, const Comm &comm, std::vector< char > &block )
+    {
+      std::ifstream file( filename.c_str(), std::ios_base::in | std::ios_base::binary );
+      if( !file )
+        DUNE_THROW( IOError, "Could not open checkpoint file '" << filename << "' for reading." );
+
+      char buffer[ sizeof( magic ) ];
+      file.read( buffer, sizeof( magic ) );
+      if( !file || !std::equal( buffer, buffer + sizeof( magic ), magic ) )
+        DUNE_THROW( IOError, "File '" << filename << "' is not a checkpoint file." );
+
+      unsigned int version, size;
+      file.read( reinterpret_cast< char * >( &version ), sizeof( version ) );
+      file.read( reinterpret_cast< char * >( &size ), sizeof( size ) );
+      throwOnMismatch( version, size, comm.size(), filename );
+
+      std::vector< Offset > offsets( size+1 );
+      file.read( reinterpret_cast< char * >( offsets.data() ), offsets.size()*sizeof( Offset ) );
+
+      block.resize( offsets[ comm.rank()+1 ] - offsets[ comm.rank() ] );
+      file.seekg( offsets[ comm.rank() ] );
+      file.read( block.data(), block.size() );
+      if( !file )
+        DUNE_THROW( IOError, "Could not read checkpoint file '" << filename << "'." );
+    }
+
+
+
+#if HAVE_MPI
+    // MPI-IO file access
+    // ------------------
+
+    /** \brief write the rank blocks into a single file using collective MPI-IO
+     *
+     *  All processes take part in every collective call, even after a failed
+     *  one, and agree on the result before closing the file. A failure on any
+     *  rank throws an IOError on all ranks.
+     */
+    inline void write ( const std::string &filename, const CollectiveCommunication< MPI_Comm > &comm,
+                        const std::vector< char > &header, const std::vector< char > &block, Offset offset )
+    {
+      MPI_File fh;
+      if( MPI_File_open( comm, const_cast< char * >( filename.c_str() ), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh ) != MPI_SUCCESS )
+        DUNE_THROW( IOError, "Could not open checkpoint file '" << filename << "' for writing." );
+
+      int success = (MPI_File_set_size( fh, 0 ) == MPI_SUCCESS);
+      if( comm.rank() == 0 )
+        success &= (MPI_File_write_at( fh, 0, const_cast< char * >( header.data() ), header.size(), MPI_BYTE, MPI_STATUS_IGNORE ) == MPI_SUCCESS);
+
+      const int chunks = comm.max( int( (block.size() + chunkSize - 1) / chunkSize ) );
+      for( int i = 0; i < chunks; ++i )
+      {
+        const std::size_t begin = std::min( i*chunkSize, block.size() );
+        const std::size_t count = std::min( chunkSize, block.size() - begin );
+        success &= (MPI_File_write_at_all( fh, offset + begin, const_cast< char * >( block.data() + begin ), count, MPI_BYTE, MPI_STATUS_IGNORE ) == MPI_SUCCESS);
+      }
+
+      success = comm.min( success );
+      MPI_File_close( &fh );
+      if( !success )
+        DUNE_THROW( IOError, "Could not write checkpoint file '" << filename << "'." );
+    }
+
+    //! read the block of this process from a single file using collective MPI-IO
+    inline void read ( const std::string &filename, const CollectiveCommunication< MPI_Comm > &comm, std::vector< char > &block )
+    {
+      MPI_File fh;
+      if( MPI_File_open( comm, const_cast< char * >( filename.c_str() ), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh ) != MPI_SUCCESS )
+        DUNE_THROW( IOError, "Could not open checkpoint file '" << filename << "' for reading." );
+
+      // only rank 0 reads the header, the offsets are distributed afterwards
+      // (info[ 0 ] is 0 if the header could not be read, 1 if it is no
+      // checkpoint header and 2 otherwise)
+      unsigned int info[ 3 ] = { 0, 0, 0 };
+      std::vector< char > header;
+      if( comm.rank() == 0 )
+      {
+        MPI_Offset fileSize;
+        if( MPI_File_get_size( fh, &fileSize ) == MPI_SUCCESS )
+        {
+          header.resize( std::min( std::size_t( fileSize ), headerSize( comm.size() ) ) );
+          if( MPI_File_read_at( fh, 0, header.data(), header.size(), MPI_BYTE, MPI_STATUS_IGNORE ) == MPI_SUCCESS )
+            info[ 0 ] = 1;
+        }
+        if( info[ 0 ] && (header.size() >= sizeof( magic ) + 2*sizeof( unsigned int )) && std::equal( magic, magic + sizeof( magic ), header.begin() ) )
+        {
+          info[ 0 ] = 2;
+          std::memcpy( info+1, header.data() + sizeof( magic ), 2*sizeof( unsigned int ) );
+        }
+      }
+      comm.broadcast( info, 3, 0 );
+      if( info[ 0 ] != 2 )
+      {
+        MPI_File_close( &fh );
+        if( info[ 0 ] == 0 )
+          DUNE_THROW( IOError, "Could not read checkpoint file '" << filename << "'." );
+        DUNE_THROW( IOError, "File '" << filename << "' is not a checkpoint file." );
+      }
+      if( (info[ 1 ] != DUNE_CHECKPOINTFILE_FORMAT_VERSION) || (int( info[ 2 ] ) != comm.size()) )
+      {
+        MPI_File_close( &fh );
+        throwOnMismatch( info[ 1 ], info[ 2 ], comm.size(), filename );
+      }
+
+      std::vector< Offset > offsets( comm.size()+1 );
+      if( comm.rank() == 0 )
+        std::memcpy( offsets.data(), header.data() + sizeof( magic ) + 2*sizeof( unsigned int ), offsets.size()*sizeof( Offset ) );
+      comm.broadcast( reinterpret_cast< char * >( offsets.data() ), offsets.size()*sizeof( Offset ), 0 );
+
+      block.resize( offsets[ comm.rank()+1 ] - offsets[ comm.rank() ] );
+      int success = 1;
+      const int chunks = comm.max( int( (block.size() + chunkSize - 1) / chunkSize ) );
+      for( int i = 0; i < chunks; ++i )
+      {
+        const std::size_t begin = std::min( i*chunkSize, block.size() );
+        const std::size_t count = std::min( chunkSize, block.size() - begin );
+        success &= (MPI_File_read_at_all( fh, offsets[ comm.rank() ] + begin, block.data() + begin, count, MPI_BYTE, MPI_STATUS_IGNORE ) == MPI_SUCCESS);
+      }
+
+      success = comm.min( success );
+      MPI_File_close( &fh );
+      if( !success )
+        DUNE_THROW( IOError, "Could not read checkpoint file '" << filename << "'." );
+    }
+#endif // #if HAVE_MPI
+
+  } // namespace CheckpointFile
+
+
+
+  // CheckpointFileWriter
+  // --------------------
+
+  /** \brief collective writer for binary checkpoint files
+   *
+   *  Each process serializes its data into a local buffer. On close(), which
+   *  has to be called by all processes, the buffers of all processes are written into a single file: a header with
+   *  the offset of each rank's block followed by the blocks themselves. With
+   *  MPI, the file is written through collective MPI-IO, otherwise the
+   *  processes write their blocks one after another.
+   *
+   *  Values are stored in binary and are only meant to be read back on the
+   *  same architecture and with the same number of processes.
+   *
+   *  \tparam  Comm  type of the collective communication
+   */
+  template< class Comm >
+  class CheckpointFileWriter
+  {
+    typedef CheckpointFileWriter< Comm > This;
+
+  public:
+    typedef Comm CollectiveCommunication;
+
+    /** \brief constructor
+     *
+     *  \param[in]  filename  name of the checkpoint file
+     *  \param[in]  comm      collective communication of all writing processes
+     */
+    CheckpointFileWriter ( const std::string &filename, const Comm &comm )
+      : filename_( filename ), comm_( comm ), closed_( false )
+    {}
+
+    //! return the collective communication
+    const Comm &comm () const { return comm_; }
+
+    //! write a value of a trivially copyable type
+    template< class T >
+    void write ( const T &value )
+    {
+      const char *data = reinterpret_cast< const char * >( &value );
+      buffer_.insert( buffer_.end(), data, data + sizeof( T ) );
+    }
+
+    //! write a string
+    void write ( const std::string &value )
+    {
+      write( CheckpointFile::Offset( value.size() ) );
+      buffer_.insert( buffer_.end(), value.begin(), value.end() );
+    }
+
+    //! write a vector of values
+    template< class T, class A >
+    void write ( const std::vector< T, A > &value )
+    {
+      writeRange( value );
+    }
+
+    /** \brief write the values of a container, e.g., a PersistentContainer
+     *
+     *  The values are written in iteration order. When reading back, the
+     *  container must be iterated in the same order, which holds for
+     *  PersistentContainers on the restored grid.
+     */
+    template< class Container >
+    void writeRange ( const Container &container )
+    {
+      CheckpointFile::Offset size = 0;
+      for( auto it = container.begin(); it != container.end(); ++it )
+        ++size;
+      write( size );
+      for( auto it = container.begin(); it != container.end(); ++it )
+        write( *it );
+    }
+
+    //! write all buffers into the file (collective)
+    void close ()
+    {
+      if( closed_ )
+        return;
+      closed_ = true;
+
+      const int size = comm_.size();
+      std::vector< unsigned long > sizes( size );
+      unsigned long mySize = buffer_.size();
+      comm_.allgather( &mySize, 1, sizes.data() );
+
+      std::vector< CheckpointFile::Offset > offsets( size+1 );
+      offsets[ 0 ] = CheckpointFile::headerSize( size );
+      for( int i = 0; i < size; ++i )
+        offsets[ i+1 ] = offsets[ i ] + sizes[ i ];
+
+      std::vector< char > header;
+      if( comm_.rank() == 0 )
+      {
+        const unsigned int info[ 2 ] = { DUNE_CHECKPOINTFILE_FORMAT_VERSION, (unsigned int)size };
+        header.insert( header.end(), CheckpointFile::magic, CheckpointFile::magic + sizeof( CheckpointFile::magic ) );
+        header.insert( header.end(), reinterpret_cast< const char * >( info ), reinterpret_cast< const char * >( info+2 ) );
+        header.insert( header.end(), reinterpret_cast< const char * >( offsets.data() ), reinterpret_cast< const char * >( offsets.data() + offsets.size() ) );
+      }
+
+      CheckpointFile::write( filename_, comm_, header, buffer_, offsets[ comm_.rank() ] );
+      std::vector< char >().swap( buffer_ );
+    }
+
+  private:
+    CheckpointFileWriter ( const This & );
+    This &operator= ( const This & );
+
+    std::string filename_;
+    Comm comm_;
+    std::vector< char > buffer_;
+    bool closed_;
+  };
+
+
+
+  // CheckpointFileReader
+  // --------------------
+
+  /** \brief collective reader for binary checkpoint files
+   *
+   *  The constructor reads the block of the calling process from the file
+   *  written by a CheckpointFileWriter. The values have to be read in the
+   *  order they have been written.
+   *
+   *  \tparam  Comm  type of the collective communication
+   */
+  template< class Comm >
+  class CheckpointFileReader
+  {
+    typedef CheckpointFileReader< Comm > This;
+
+  public:
+    typedef Comm CollectiveCommunication;
+
+    /** \brief constructor (collective)
+     *
+     *  \param[in]  filename  name of the checkpoint file
+     *  \param[in]  comm      collective communication of all reading processes
+     *
+     *  \note The file must have been written by as many processes as
+     *        comm contains.
+     */
+    CheckpointFileReader ( const std::string &filename, const Comm &comm = Comm() )
+      : filename_( filename ), comm_( comm ), position_( 0 )
+    {
+      CheckpointFile::read( filename_, comm_, buffer_ );
+    }
+
+    //! return the collective communication
+    const Comm &comm () const { return comm_; }
+
+    //! read a value of a trivially copyable type
+    template< class T >
+    void read ( T &value )
+    {
+      std::memcpy( &value, consume( sizeof( T ) ), sizeof( T ) );
+    }
+
+    //! read a string
+    void read ( std::string &value )
+    {
+      CheckpointFile::Offset size;
+      read( size );
+      const char *data = consume( size );
+      value.assign( data, data + size );
+    }
+
+    //! read a vector of values
+    template< class T, class A >
+    void read ( std::vector< T, A > &value )
+    {
+      CheckpointFile::Offset size;
+      read( size );
+      value.resize( size );
+      for( auto it = value.begin(); it != value.end(); ++it )
+        read( *it );
+    }
+
+    /** \brief read the values of a container, e.g., a PersistentContainer
+     *
+     *  The container must already have the size it had when it was written.
+     *  For a PersistentContainer, call resize() after restoring the grid.
+     */
+    template< class Container >
+    void readRange ( Container &container )
+    {
+      CheckpointFile::Offset size, count = 0;
+      read( size );
+      for( auto it = container.begin(); it != container.end(); ++it )
+        ++count;
+      if( count != size )
+        DUNE_THROW( IOError, "Checkpoint file '" << filename_ << "' contains " << size << " values, but container has " << count << "." );
+      for( auto it = container.begin(); it != container.end(); ++it )
+        read( *it );
+    }
+
+    //! return true if all data of this process has been read
+    bool eof () const { return (position_ == buffer_.size()); }
+
+  private:
+    CheckpointFileReader ( const This & );
+    This &operator= ( const This & );
+
+    const char *consume ( std::size_t size )
+    {
+      if( position_ + size > buffer_.size() )
+        DUNE_THROW( IOError, "Unexpected end of data in checkpoint file '" << filename_ << "'." );
+      const char *data = buffer_.data() + position_;
+      position_ += size;
+      return data;
+    }
+
+    std::string filename_;
+    Comm comm_;
+    std::vector< char > buffer_;
+    std::size_t position_;
+  };
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_GRID_IO_FILE_CHECKPOINTFILE_HH
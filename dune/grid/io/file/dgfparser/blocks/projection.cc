@@ -2,6 +2,9 @@
 // vi: set et ts=4 sw=2 sts=2:
 #include <config.h>
 
+#include <algorithm>
+#include <cmath>
+
 #include <dune/common/math.hh>
 
 #include <dune/grid/io/file/dgfparser/blocks/projection.hh>
@@ -15,6 +18,9 @@ namespace Dune
     namespace Expr
     {
 
+      typedef ProjectionBlock::CompiledExpression CompiledExpression;
+      typedef CompiledExpression::Value Value;
+
       struct ConstantExpression
         : public ProjectionBlock::Expression
       {
@@ -27,6 +33,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         Vector value_;
@@ -37,6 +44,7 @@ namespace Dune
         : public ProjectionBlock::Expression
       {
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
       };
 
 
@@ -50,6 +58,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *function_;
@@ -67,6 +76,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         std::vector< const ProjectionBlock::Expression * > expressions_;
@@ -82,6 +92,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -97,6 +108,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -111,6 +123,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -125,6 +138,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -139,6 +153,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -153,6 +168,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *expression_;
@@ -169,6 +185,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *exprA_;
@@ -188,6 +205,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *exprA_;
@@ -207,6 +225,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *exprA_;
@@ -226,6 +245,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *exprA_;
@@ -245,6 +265,7 @@ namespace Dune
         {}
 
         virtual void evaluate ( const Vector &argument, Vector &result ) const;
+        virtual Value compile ( CompiledExpression &program, const Value &argument ) const;
 
       private:
         const ProjectionBlock::Expression *exprA_;
@@ -434,10 +455,360 @@ namespace Dune
           result[ i ] *= factor;
       }
 
+
+      Value ConstantExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        return program.constant( value_ );
+      }
+
+
+      Value VariableExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        return argument;
+      }
+
+
+      Value FunctionCallExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        // inline the function body
+        return function_->compile( program, expression_->compile( program, argument ) );
+      }
+
+
+      Value VectorExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        std::vector< Value > values;
+        int size = 0;
+        typedef std::vector< const Expression * >::const_iterator Iterator;
+        const Iterator end = expressions_.end();
+        for( Iterator it = expressions_.begin(); it != end; ++it )
+        {
+          values.push_back( (*it)->compile( program, argument ) );
+          size += values.back().size;
+        }
+
+        const Value result = program.allocate( size );
+        int offset = result.offset;
+        for( size_t i = 0; i < values.size(); ++i )
+        {
+          program.append( CompiledExpression::copy, Value( offset, values[ i ].size ), values[ i ] );
+          offset += values[ i ].size;
+        }
+        return result;
+      }
+
+
+      Value BracketExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        if( field_ >= size_t( value.size ) )
+          DUNE_THROW( MathError, "Index out of bounds (" <<  field_ << " not in [ 0, " << value.size << " [)." );
+        return Value( value.offset + int( field_ ), 1 );
+      }
+
+
+      Value MinusExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        const Value result = program.allocate( value.size );
+        program.append( CompiledExpression::negate, result, value );
+        return result;
+      }
+
+
+      Value NormExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        const Value result = program.allocate( 1 );
+        program.append( CompiledExpression::norm, result, value );
+        return result;
+      }
+
+
+      Value SqrtExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        if( value.size != 1 )
+          DUNE_THROW( MathError, "Cannot calculate square root of a vector." );
+        const Value result = program.allocate( 1 );
+        program.append( CompiledExpression::sqrt, result, value );
+        return result;
+      }
+
+
+      Value SinExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        if( value.size != 1 )
+          DUNE_THROW( MathError, "Cannot calculate the sine of a vector." );
+        const Value result = program.allocate( 1 );
+        program.append( CompiledExpression::sin, result, value );
+        return result;
+      }
+
+
+      Value CosExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value value = expression_->compile( program, argument );
+        if( value.size != 1 )
+          DUNE_THROW( MathError, "Cannot calculate the cosine of a vector." );
+        const Value result = program.allocate( 1 );
+        program.append( CompiledExpression::cos, result, value );
+        return result;
+      }
+
+
+      Value PowerExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value a = exprA_->compile( program, argument );
+        const Value b = exprB_->compile( program, argument );
+        if( (a.size != 1) || (b.size != 1) )
+          DUNE_THROW( MathError, "Cannot calculate powers of vectors." );
+        const Value result = program.allocate( 1 );
+        program.append( CompiledExpression::power, result, a, b );
+        return result;
+      }
+
+
+      Value SumExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value a = exprA_->compile( program, argument );
+        const Value b = exprB_->compile( program, argument );
+        if( a.size != b.size )
+          DUNE_THROW( MathError, "Cannot sum vectors of different size." );
+        const Value result = program.allocate( a.size );
+        program.append( CompiledExpression::sum, result, a, b );
+        return result;
+      }
+
+
+      Value DifferenceExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value a = exprA_->compile( program, argument );
+        const Value b = exprB_->compile( program, argument );
+        if( a.size != b.size )
+          DUNE_THROW( MathError, "Cannot sum vectors of different size." );
+        const Value result = program.allocate( a.size );
+        program.append( CompiledExpression::difference, result, a, b );
+        return result;
+      }
+
+
+      Value ProductExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value a = exprA_->compile( program, argument );
+        const Value b = exprB_->compile( program, argument );
+        if( a.size == b.size )
+        {
+          const Value result = program.allocate( 1 );
+          program.append( CompiledExpression::dot, result, a, b );
+          return result;
+        }
+        else if( b.size == 1 )
+        {
+          const Value result = program.allocate( a.size );
+          program.append( CompiledExpression::scale, result, a, b );
+          return result;
+        }
+        else if( a.size == 1 )
+        {
+          const Value result = program.allocate( b.size );
+          program.append( CompiledExpression::scale, result, b, a );
+          return result;
+        }
+        else
+          DUNE_THROW( MathError, "Cannot multiply non-scalar vectors of different size." );
+      }
+
+
+      Value QuotientExpression::compile ( CompiledExpression &program, const Value &argument ) const
+      {
+        const Value b = exprB_->compile( program, argument );
+        if( b.size != 1 )
+          DUNE_THROW( MathError, "Cannot divide by a vector." );
+        const Value a = exprA_->compile( program, argument );
+        const Value result = program.allocate( a.size );
+        program.append( CompiledExpression::divide, result, a, b );
+        return result;
+      }
+
     } // namespace Expr
 
 
 
+    // ProjectionBlock::CompiledExpression
+    // -----------------------------------
+
+    ProjectionBlock::CompiledExpression::CompiledExpression ( const Expression &expression, int argumentSize )
+      : argumentSize_( argumentSize ),
+        numSlots_( argumentSize ),
+        width_( 0 )
+    {
+      // the argument occupies the first slots
+      result_ = expression.compile( *this, Value( 0, argumentSize ) );
+    }
+
+
+    void ProjectionBlock::CompiledExpression
+    ::evaluate ( std::size_t count, const double *argument, double *result ) const
+    {
+      // evaluate blocks of points, so each instruction is dispatched once per block
+      const std::size_t blockSize = 64;
+      const std::size_t resultSize = result_.size;
+      for( std::size_t begin = 0; begin < count; begin += blockSize )
+      {
+        const std::size_t width = std::min( blockSize, count - begin );
+        setWidth( width );
+
+        const double *x = argument + begin*argumentSize_;
+        for( std::size_t p = 0; p < width; ++p )
+          for( int i = 0; i < argumentSize_; ++i )
+            memory_[ i*width + p ] = x[ p*argumentSize_ + i ];
+
+        const std::size_t size = code_.size();
+        for( std::size_t k = 0; k < size; ++k )
+          execute( code_[ k ], width );
+
+        double *y = result + begin*resultSize;
+        for( std::size_t p = 0; p < width; ++p )
+          for( std::size_t i = 0; i < resultSize; ++i )
+            y[ p*resultSize + i ] = memory_[ (result_.offset + i)*width + p ];
+      }
+    }
+
+
+    ProjectionBlock::CompiledExpression::Value
+    ProjectionBlock::CompiledExpression::allocate ( int size )
+    {
+      const Value value( numSlots_, size );
+      numSlots_ += size;
+      return value;
+    }
+
+
+    ProjectionBlock::CompiledExpression::Value
+    ProjectionBlock::CompiledExpression::constant ( const Vector &value )
+    {
+      const Value result = allocate( value.size() );
+      for( size_t i = 0; i < value.size(); ++i )
+        constants_.push_back( std::make_pair( result.offset + int( i ), value[ i ] ) );
+      return result;
+    }
+
+
+    void ProjectionBlock::CompiledExpression
+    ::append ( OpCode op, const Value &dst, const Value &a, const Value &b )
+    {
+      Instruction instruction;
+      instruction.op = op;
+      instruction.dst = dst;
+      instruction.a = a;
+      instruction.b = b;
+      code_.push_back( instruction );
+    }
+
+
+    void ProjectionBlock::CompiledExpression::setWidth ( std::size_t width ) const
+    {
+      if( width == width_ )
+        return;
+
+      // no instruction writes to constant slots, so they are set only here
+      width_ = width;
+      memory_.resize( numSlots_ * width );
+      for( size_t k = 0; k < constants_.size(); ++k )
+        std::fill_n( memory_.begin() + constants_[ k ].first * width, width, constants_[ k ].second );
+    }
+
+
+    void ProjectionBlock::CompiledExpression
+    ::execute ( const Instruction &instruction, std::size_t width ) const
+    {
+      double *dst = memory_.data() + instruction.dst.offset * width;
+      const double *a = memory_.data() + instruction.a.offset * width;
+      const double *b = memory_.data() + instruction.b.offset * width;
+      const std::size_t size = instruction.a.size * width;
+
+      switch( instruction.op )
+      {
+      case copy :
+        std::copy( a, a + size, dst );
+        break;
+
+      case negate :
+        for( std::size_t j = 0; j < size; ++j )
+          dst[ j ] = -a[ j ];
+        break;
+
+      case norm :
+        for( std::size_t p = 0; p < width; ++p )
+        {
+          double normsqr = 0.0;
+          for( std::size_t j = p; j < size; j += width )
+            normsqr += a[ j ] * a[ j ];
+          dst[ p ] = std::sqrt( normsqr );
+        }
+        break;
+
+      case sqrt :
+        for( std::size_t p = 0; p < width; ++p )
+          dst[ p ] = std::sqrt( a[ p ] );
+        break;
+
+      case sin :
+        for( std::size_t p = 0; p < width; ++p )
+          dst[ p ] = std::sin( a[ p ] );
+        break;
+
+      case cos :
+        for( std::size_t p = 0; p < width; ++p )
+          dst[ p ] = std::cos( a[ p ] );
+        break;
+
+      case power :
+        for( std::size_t p = 0; p < width; ++p )
+          dst[ p ] = std::pow( a[ p ], b[ p ] );
+        break;
+
+      case sum :
+        for( std::size_t j = 0; j < size; ++j )
+          dst[ j ] = a[ j ] + b[ j ];
+        break;
+
+      case difference :
+        for( std::size_t j = 0; j < size; ++j )
+          dst[ j ] = a[ j ] - b[ j ];
+        break;
+
+      case dot :
+        for( std::size_t p = 0; p < width; ++p )
+        {
+          double product = 0.0;
+          for( std::size_t j = p; j < size; j += width )
+            product += a[ j ] * b[ j ];
+          dst[ p ] = product;
+        }
+        break;
+
+      case scale :
+        for( std::size_t j = 0; j < size; j += width )
+          for( std::size_t p = 0; p < width; ++p )
+            dst[ j+p ] = a[ j+p ] * b[ p ];
+        break;
+
+      case divide :
+        for( std::size_t p = 0; p < width; ++p )
+        {
+          const double factor = 1.0 / b[ p ];
+          for( std::size_t j = p; j < size; j += width )
+            dst[ j ] = a[ j ] * factor;
+        }
+        break;
+      }
+    }
+
+
+
     // ProjectionBlock
     // ---------------
 
@@ -3,7 +3,10 @@
 #ifndef DUNE_DGF_PROJECTIONBLOCK_HH
 #define DUNE_DGF_PROJECTIONBLOCK_HH
 
+#include <cstddef>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include <dune/grid/common/boundaryprojection.hh>
 #include <dune/grid/io/file/dgfparser/blocks/basic.hh>
@@ -52,6 +55,7 @@ namespace Dune
 
     public:
       struct Expression;
+      class CompiledExpression;
 
     private:
       template< int dimworld >
@@ -128,6 +132,62 @@ namespace Dune
     std::ostream &operator<< ( std::ostream &out, const ProjectionBlock::Token &token );
 
 
+    class ProjectionBlock::CompiledExpression
+    {
+    public:
+      typedef std::vector< double > Vector;
+
+      // a range of memory slots holding an intermediate value
+      struct Value
+      {
+        Value ( int o = 0, int s = 0 ) : offset( o ), size( s ) {}
+
+        int offset, size;
+      };
+
+      enum OpCode { copy, negate, norm, sqrt, sin, cos, power, sum, difference, dot, scale, divide };
+
+      // compile an expression for arguments of the given size
+      CompiledExpression ( const Expression &expression, int argumentSize );
+
+      int argumentSize () const { return argumentSize_; }
+      int resultSize () const { return result_.size; }
+
+      void evaluate ( const double *argument, double *result ) const
+      {
+        evaluate( 1, argument, result );
+      }
+
+      // evaluate for count points stored one after the other
+      void evaluate ( std::size_t count, const double *argument, double *result ) const;
+
+      // interface for Expression::compile
+      Value allocate ( int size );
+      Value constant ( const Vector &value );
+      void append ( OpCode op, const Value &dst, const Value &a, const Value &b = Value() );
+
+    private:
+      struct Instruction
+      {
+        OpCode op;
+        Value dst, a, b;
+      };
+
+      void setWidth ( std::size_t width ) const;
+      void execute ( const Instruction &instruction, std::size_t width ) const;
+
+      int argumentSize_;
+      Value result_;
+      std::vector< Instruction > code_;
+      std::vector< std::pair< int, double > > constants_;
+      int numSlots_;
+
+      // slot i of point p is memory_[ i*width_ + p ]
+      mutable std::vector< double > memory_;
+      mutable std::size_t width_;
+    };
+
+
     struct ProjectionBlock::Expression
     {
       typedef std::vector< double > Vector;
@@ -136,6 +196,10 @@ namespace Dune
       {}
 
       virtual void evaluate ( const Vector &argument, Vector &result ) const = 0;
+
+      // append the instructions evaluating this expression to program
+      virtual CompiledExpression::Value
+      compile ( CompiledExpression &program, const CompiledExpression::Value &argument ) const = 0;
     };
 
 
@@ -148,17 +212,21 @@ namespace Dune
     public:
       typedef typename Base::CoordinateType CoordinateType;
 
+      // surplus components of the result are ignored, as they always were
       BoundaryProjection ( const Expression *expression )
-        : expression_( expression )
-      {}
+        : program_( *expression, dimworld ), y_( program_.resultSize() )
+      {
+        if( program_.resultSize() < dimworld )
+          DUNE_THROW( MathError, "Boundary projection returns a vector of size " << program_.resultSize() << " instead of " << dimworld << "." );
+      }
 
       virtual CoordinateType operator() ( const CoordinateType &global ) const
       {
-        std::vector< double > x( dimworld );
+        double x[ dimworld ];
         for( int i = 0; i < dimworld; ++i )
           x[ i ] = global[ i ];
-        std::vector< double > y;
-        expression_->evaluate( x, y );
+        double *y = &y_[ 0 ];
+        program_.evaluate( x, y );
         CoordinateType result;
         for( int i = 0; i < dimworld; ++i )
           result[ i ] = y[ i ];
@@ -166,7 +234,8 @@ namespace Dune
       }
 
     private:
-      const Expression *expression_;
+      CompiledExpression program_;
+      mutable std::vector< double > y_;
     };
 
   }
@@ -9,9 +9,13 @@
  */
 
 #include <fstream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include <dune/grid/common/grid.hh>
+#include <dune/grid/io/file/bufferedoutputfile.hh>
+#include <dune/grid/utility/globalindexset.hh>
 #include <dune/geometry/referenceelements.hh>
 
 namespace Dune
@@ -24,6 +28,11 @@ namespace Dune
    *  The DGFWriter allows create a DGF file from a given GridView. It allows
    *  for the easy creation of file format converters.
    *
+   *  The grid view is traversed only once: vertices are streamed directly
+   *  while the element connectivity is kept in a flat table until the element
+   *  blocks are written. For distributed grids, writeParallel() writes the
+   *  interior elements of all ranks using globally consistent vertex numbers.
+   *
    *  \tparam  GV  GridView to write in DGF format
    */
   template< class GV >
@@ -40,21 +49,32 @@ namespace Dune
     /** \brief dimension of the grid */
     static const int dimGrid = GridView::dimension;
 
+    /** \brief output layout of writeParallel() */
+    enum PartitionMode {
+      mergedFile,    //!< all ranks write into one file using global vertex numbers
+      partitionFiles //!< each rank writes its interior elements into its own file
+    };
+
   private:
     typedef typename GridView::IndexSet IndexSet;
     typedef typename GridView::template Codim< 0 >::Iterator ElementIterator;
+    typedef typename GridView::template Codim< 0 >::template Partition< Interior_Partition >::Iterator InteriorIterator;
     typedef typename GridView::IntersectionIterator IntersectionIterator;
-    typedef typename GridView::template Codim< dimGrid >::EntityPointer VertexPointer;
 
     typedef typename ElementIterator :: Entity Element ;
-    typedef typename Element :: EntityPointer ElementPointer;
-    typedef typename Element :: EntitySeed ElementSeed ;
+    typedef typename Element :: Geometry ElementGeometry;
 
     typedef typename IndexSet::IndexType Index;
 
     typedef ReferenceElement< typename Grid::ctype, dimGrid > RefElement;
     typedef ReferenceElements< typename Grid::ctype, dimGrid > RefElements;
 
+    // element blocks of the DGF file
+    enum ElementKind { noElement = 0, simplexElement = 1, cubeElement = 2 };
+
+    // maximal number of corners of an element (cube)
+    static const int maxCorners = (1 << dimGrid);
+
   public:
     /** \brief constructor
      *
@@ -96,6 +116,30 @@ namespace Dune
      */
     void write ( const std::string &fileName ) const;
 
+    /** \brief write the interior elements of a distributed GridView
+     *
+     *  In mergedFile mode, each vertex is written once by the rank owning its
+     *  global index (see GlobalIndexSet) and the ranks append their data in
+     *  turn. In partitionFiles mode, each rank writes a self-contained file
+     *  named by partitionFileName(). This method is collective.
+     *
+     *  \note Boundary segments are not written in parallel.
+     *
+     *  \param[in] fileName   name of the (merged) file
+     *  \param[in] mode       write one merged file or one file per rank
+     *  \param[in] addParams  additional data to write to dgf file
+     */
+    void writeParallel ( const std::string &fileName, PartitionMode mode = mergedFile,
+                         const std::stringstream& addParams = std::stringstream() ) const;
+
+    /** \brief return the name of the file written by a rank in partitionFiles mode */
+    static std::string partitionFileName ( const std::string &fileName, int rank )
+    {
+      std::ostringstream name;
+      name << fileName << "." << rank;
+      return name.str();
+    }
+
   protected:
     GridView gridView_;
 
@@ -104,59 +148,43 @@ namespace Dune
     //  helper methods
     /////////////////////////////////////////////
 
-    // write all elements of type elementType
-    void writeAllElements( const std::vector<ElementSeed>& elementSeeds,
-                           const IndexSet& indexSet,
-                           const GeometryType& elementType,
-                           const std::vector< Index >& vertexIndex,
-                           std::ostream &gridout ) const
+    // set the stream to full double precision
+    static void setPrecision ( std::ostream &gridout )
     {
-      if( elementSeeds.size() > 0 )
-      {
-        // perform grid traversal based on new element ordering
-        typedef typename std::vector<ElementSeed> :: const_iterator iterator ;
-        const iterator end = elementSeeds.end();
-        for( iterator it = elementSeeds.begin(); it != end ; ++ it )
-        {
-          // convert entity seed into entity pointer
-          const ElementPointer ep = gridView_.grid().entityPointer( *it );
-          // write element
-          writeElement( *ep, indexSet, elementType, vertexIndex, gridout );
-        }
-      }
+      gridout.setf( std::ios_base::scientific, std::ios_base::floatfield );
+      gridout.precision( 16 );
+    }
+
+    // return the element block an element belongs to
+    static ElementKind elementKind ( const Element &element )
+    {
+      const GeometryType type = element.type();
+      if( (dimGrid > 1) && type.isSimplex() )
+        return simplexElement;
+      else if( type.isCube() )
+        return cubeElement;
       else
-      {
-        // perform default grid traversal
-        const ElementIterator end = gridView_.template end< 0 >();
-        for( ElementIterator it = gridView_.template begin< 0 >(); it != end; ++it )
-        {
-          // write element
-          writeElement( *it, indexSet, elementType, vertexIndex, gridout );
-        }
-      }
+        return noElement;
     }
 
-    // write one element
-    void writeElement( const Element& element,
-                       const IndexSet& indexSet,
-                       const GeometryType& elementType,
-                       const std::vector< Index >& vertexIndex,
-                       std::ostream &gridout ) const
+    // write all elements of one kind from the connectivity table
+    static void writeElements ( const std::vector< unsigned char > &kinds,
+                                const std::vector< Index > &connectivity,
+                                ElementKind kind, std::ostream &gridout )
     {
-      // if element's type is not the same as the type to write the return
-      if( element.type() != elementType )
-        return ;
-
-      // get vertex numbers of the element
-      const size_t vxSize = element.subEntities( Element::dimension );
-      std::vector<Index> vertices(vxSize);
-      for( size_t i = 0; i < vxSize; ++i )
-        vertices[ i ] = vertexIndex[ indexSet.subIndex( element, i, dimGrid ) ];
-
-      gridout << vertices[ 0 ];
-      for( size_t i = 1; i < vxSize; ++i )
-        gridout << " " << vertices[ i ];
-      gridout << std::endl;
+      const size_t size = kinds.size();
+      for( size_t i = 0; i < size; ++i )
+      {
+        if( kinds[ i ] != kind )
+          continue;
+
+        const Index *vertices = &connectivity[ i*maxCorners ];
+        const int numCorners = (kind == simplexElement ? dimGrid+1 : maxCorners);
+        gridout << vertices[ 0 ];
+        for( int j = 1; j < numCorners; ++j )
+          gridout << " " << vertices[ j ];
+        gridout << "\n";
+      }
     }
   };
 
@@ -167,56 +195,40 @@ namespace Dune
           const std::vector< Index >& newElemOrder,
           const std::stringstream& addParams ) const
   {
-    // set the stream to full double precision
-    gridout.setf( std::ios_base::scientific, std::ios_base::floatfield );
-    gridout.precision( 16 );
+    setPrecision( gridout );
 
     const IndexSet &indexSet = gridView_.indexSet();
 
-    // vector containing entity seed (only needed if new ordering is given)
-    std::vector< ElementSeed > elementSeeds;
-
-    // if ordering was provided
-    const size_t orderSize = newElemOrder.size() ;
-    if( orderSize == indexSet.size( 0 ) )
-    {
-      const ElementIterator end = gridView_.template end< 0 >();
-      ElementIterator it = gridView_.template begin< 0 >();
-
-      if( it != end )
-      {
-        elementSeeds.resize( orderSize, (*it).seed() ) ;
-        size_t countElements = 0 ;
-        for( ; it != end; ++it, ++countElements )
-        {
-          const Element& element = *it ;
-          assert( newElemOrder[ indexSet.index( element ) ] < orderSize );
-          elementSeeds[ newElemOrder[ indexSet.index( element ) ] ] = element.seed();
-        }
-
-        // make sure that the size of the index set is equal
-        // to the number of counted elements
-        if( countElements != orderSize )
-          DUNE_THROW(InvalidStateException,"DGFWriter::write: IndexSet not consecutive");
-      }
-    }
+    // use the new ordering, if it was provided
+    const size_t numElements = indexSet.size( 0 );
+    const bool reorder = (newElemOrder.size() == numElements);
 
     // write DGF header
-    gridout << "DGF" << std::endl;
+    gridout << "DGF\n";
 
     const Index vxSize = indexSet.size( dimGrid );
     std::vector< Index > vertexIndex( vxSize, vxSize );
 
-    gridout << "%" << " Elements = " << indexSet.size( 0 ) << "  |  Vertices = " << vxSize << std::endl;
+    gridout << "%" << " Elements = " << numElements << "  |  Vertices = " << vxSize << "\n";
+
+    // write all vertices into the "vertex" block and store the element connectivity
+    std::vector< unsigned char > kinds( numElements, noElement );
+    std::vector< Index > connectivity( numElements * maxCorners );
 
-    // write all vertices into the "vertex" block
-    gridout << std::endl << "VERTEX" << std::endl;
+    gridout << "\nVERTEX\n";
     Index vertexCount = 0;
+    size_t countElements = 0;
     const ElementIterator end = gridView_.template end< 0 >();
-    for( ElementIterator it = gridView_.template begin< 0 >(); it != end; ++it )
+    for( ElementIterator it = gridView_.template begin< 0 >(); it != end; ++it, ++countElements )
     {
       const Element& element = *it ;
+      const size_t position = (reorder ? size_t( newElemOrder[ indexSet.index( element ) ] ) : countElements);
+      if( position >= numElements )
+        DUNE_THROW( InvalidStateException, "DGFWriter::write: IndexSet not consecutive" );
+
+      const ElementGeometry geometry = element.geometry();
       const int numCorners = element.subEntities( dimGrid );
+      Index *vertices = &connectivity[ position*maxCorners ];
       for( int i=0; i<numCorners; ++i )
       {
         const Index vxIndex = indexSet.subIndex( element, i, dimGrid );
@@ -224,54 +236,45 @@ namespace Dune
         if( vertexIndex[ vxIndex ] == vxSize )
         {
           vertexIndex[ vxIndex ] = vertexCount++;
-          gridout << element.geometry().corner( i ) << std::endl;
+          gridout << geometry.corner( i ) << "\n";
         }
+        vertices[ i ] = vertexIndex[ vxIndex ];
       }
+      kinds[ position ] = elementKind( element );
     }
-    gridout << "#" << std::endl;
+    gridout << "#\n";
     if( vertexCount != vxSize )
       DUNE_THROW( GridError, "Index set reports wrong number of vertices." );
 
+    // make sure that the size of the index set is equal
+    // to the number of counted elements
+    if( countElements != numElements )
+      DUNE_THROW(InvalidStateException,"DGFWriter::write: IndexSet not consecutive");
+
     if( dimGrid > 1 )
     {
-      // type of element to write
-      GeometryType simplex( GeometryType::simplex, dimGrid );
-
       // only write simplex block if grid view contains simplices
-      if( indexSet.size( simplex ) > 0 )
+      if( indexSet.size( GeometryType( GeometryType::simplex, dimGrid ) ) > 0 )
       {
         // write all simplices to the "simplex" block
-        gridout << std::endl << "SIMPLEX" << std::endl;
-
-        // write all simplex elements
-        writeAllElements( elementSeeds, indexSet, simplex, vertexIndex, gridout );
-
-        // write end marker for block
-        gridout << "#" << std::endl;
+        gridout << "\nSIMPLEX\n";
+        writeElements( kinds, connectivity, simplexElement, gridout );
+        gridout << "#\n";
       }
     }
 
+    // only write cube block if grid view contains cubes
+    if( indexSet.size( GeometryType( GeometryType::cube, dimGrid ) ) > 0 )
     {
-      // cube geometry type
-      GeometryType cube( GeometryType::cube, dimGrid );
-
-      // only write cube block if grid view contains cubes
-      if( indexSet.size( cube ) > 0 )
-      {
-        // write all cubes to the "cube" block
-        gridout << std::endl << "CUBE" << std::endl;
-
-        // write all simplex elements
-        writeAllElements( elementSeeds, indexSet, cube, vertexIndex, gridout );
-
-        // write end marker for block
-        gridout << "#" << std::endl;
-      }
+      // write all cubes to the "cube" block
+      gridout << "\nCUBE\n";
+      writeElements( kinds, connectivity, cubeElement, gridout );
+      gridout << "#\n";
     }
 
     // write all boundaries to the "boundarysegments" block
 #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
-    gridout << std::endl << "BOUNDARYSEGMENTS" << std::endl;
+    gridout << "\nBOUNDARYSEGMENTS\n";
     for( ElementIterator it = gridView_.template begin< 0 >(); it != end; ++it )
     {
       const Element& element = *it ;
@@ -305,16 +308,16 @@ namespace Dune
         gridout << boundaryId << "   " << vertices[ 0 ];
         for( unsigned int i = 1; i < faceSize; ++i )
           gridout << " " << vertices[ i ];
-        gridout << std::endl;
+        gridout << "\n";
       }
     }
-    gridout << "#" << std::endl << std::endl;
+    gridout << "#\n\n";
 #endif // #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
 
     // add additional parameters given by the user
-    gridout << addParams.str() << std::endl;
+    gridout << addParams.str() << "\n";
 
-    gridout << std::endl << "#" << std::endl;
+    gridout << "\n#" << std::endl;
   }
 
   template< class GV >
@@ -339,13 +342,153 @@ namespace Dune
   template< class GV >
   inline void DGFWriter< GV >::write ( const std::string &fileName ) const
   {
-    std::ofstream gridout( fileName.c_str() );
-    if( gridout )
-      write( gridout );
+    BufferedOutputFile file( fileName );
+    if( file.is_open() )
+      write( file.stream() );
     else
       std::cerr << "Couldn't open file `"<< fileName << "'!"<< std::endl;
   }
 
+  template< class GV >
+  inline void DGFWriter< GV >::
+  writeParallel ( const std::string &fileName, PartitionMode mode,
+                  const std::stringstream& addParams ) const
+  {
+    const typename GridView::CollectiveCommunication &comm = gridView_.comm();
+    const int rank = comm.rank();
+
+    if( mode == partitionFiles )
+    {
+      // each partition is a grid of its own, use the local numbering
+      const std::string name = partitionFileName( fileName, rank );
+      BufferedOutputFile file( name );
+      if( !file.is_open() )
+        DUNE_THROW( IOError, "DGFWriter: Could not open " << name << "." );
+      std::ofstream &gridout = file.stream();
+
+      setPrecision( gridout );
+
+      const IndexSet &indexSet = gridView_.indexSet();
+      const Index vxSize = indexSet.size( dimGrid );
+      std::vector< Index > vertexIndex( vxSize, vxSize );
+      std::vector< unsigned char > kinds;
+      std::vector< Index > connectivity;
+
+      gridout << "DGF\n" << "\nVERTEX\n";
+      Index vertexCount = 0;
+      const InteriorIterator end = gridView_.template end< 0, Interior_Partition >();
+      for( InteriorIterator it = gridView_.template begin< 0, Interior_Partition >(); it != end; ++it )
+      {
+        const Element &element = *it;
+        const ElementGeometry geometry = element.geometry();
+        const int numCorners = element.subEntities( dimGrid );
+        connectivity.resize( connectivity.size() + maxCorners );
+        Index *vertices = &connectivity[ connectivity.size() - maxCorners ];
+        for( int i = 0; i < numCorners; ++i )
+        {
+          const Index vxIndex = indexSet.subIndex( element, i, dimGrid );
+          if( vertexIndex[ vxIndex ] == vxSize )
+          {
+            vertexIndex[ vxIndex ] = vertexCount++;
+            gridout << geometry.corner( i ) << "\n";
+          }
+          vertices[ i ] = vertexIndex[ vxIndex ];
+        }
+        kinds.push_back( elementKind( element ) );
+      }
+      gridout << "#\n";
+
+      bool hasKind[ 3 ] = { false, false, false };
+      for( size_t i = 0; i < kinds.size(); ++i )
+        hasKind[ kinds[ i ] ] = true;
+
+      if( hasKind[ simplexElement ] )
+      {
+        gridout << "\nSIMPLEX\n";
+        writeElements( kinds, connectivity, simplexElement, gridout );
+        gridout << "#\n";
+      }
+      if( hasKind[ cubeElement ] )
+      {
+        gridout << "\nCUBE\n";
+        writeElements( kinds, connectivity, cubeElement, gridout );
+        gridout << "#\n";
+      }
+
+      gridout << addParams.str() << "\n" << "\n#" << std::endl;
+      gridout.close();
+      if( !gridout )
+        DUNE_THROW( IOError, "DGFWriter: Could not write to " << name << "." );
+      return;
+    }
+
+    // global vertex numbers, each rank owns a consecutive range
+    GlobalIndexSet< GridView > globalIndexSet( gridView_, dimGrid );
+    const Index firstOwned = globalIndexSet.firstOwnedIndex();
+
+    std::vector< typename ElementGeometry::GlobalCoordinate > ownedVertices( globalIndexSet.ownedSize() );
+    std::vector< unsigned char > kinds;
+    std::vector< Index > connectivity;
+
+    const InteriorIterator end = gridView_.template end< 0, Interior_Partition >();
+    for( InteriorIterator it = gridView_.template begin< 0, Interior_Partition >(); it != end; ++it )
+    {
+      const Element &element = *it;
+      const ElementGeometry geometry = element.geometry();
+      const int numCorners = element.subEntities( dimGrid );
+      connectivity.resize( connectivity.size() + maxCorners );
+      Index *vertices = &connectivity[ connectivity.size() - maxCorners ];
+      for( int i = 0; i < numCorners; ++i )
+      {
+        const Index vxIndex = globalIndexSet.subIndex( element, i, dimGrid );
+        if( globalIndexSet.owned( vxIndex ) )
+          ownedVertices[ vxIndex - firstOwned ] = geometry.corner( i );
+        vertices[ i ] = vxIndex;
+      }
+      kinds.push_back( elementKind( element ) );
+    }
+
+    // only write blocks that contain elements on some rank
+    int hasKind[ 3 ] = { 0, 0, 0 };
+    for( size_t i = 0; i < kinds.size(); ++i )
+      hasKind[ kinds[ i ] ] = 1;
+    comm.max( hasKind, 3 );
+
+    // rank 0 writes the headers of the blocks, the last rank the end of the file
+    const bool first = (rank == 0);
+    const bool last = (rank == comm.size()-1);
+
+    std::ostringstream vertexData;
+    setPrecision( vertexData );
+    if( first )
+      vertexData << "DGF\n" << "%" << " Vertices = " << globalIndexSet.size( dimGrid ) << "\n" << "\nVERTEX\n";
+    for( size_t i = 0; i < ownedVertices.size(); ++i )
+      vertexData << ownedVertices[ i ] << "\n";
+    if( last )
+      vertexData << "#\n";
+    appendInRankOrder( comm, fileName, vertexData.str(), true );
+
+    for( int kind = simplexElement; kind <= cubeElement; ++kind )
+    {
+      if( !hasKind[ kind ] )
+        continue;
+
+      std::ostringstream elementData;
+      if( first )
+        elementData << (kind == simplexElement ? "\nSIMPLEX\n" : "\nCUBE\n");
+      writeElements( kinds, connectivity, ElementKind( kind ), elementData );
+      if( last )
+        elementData << "#\n";
+      appendInRankOrder( comm, fileName, elementData.str(), false );
+    }
+
+    // the last rank closes the file
+    std::ostringstream trailer;
+    if( last )
+      trailer << addParams.str() << "\n" << "\n#" << std::endl;
+    appendInRankOrder( comm, fileName, trailer.str(), false );
+  }
+
 }
 
 #endif // #ifndef DUNE_DGFWRITER_HH
@@ -0,0 +1,189 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+/** \file
+ *  \brief compare the compiled projection expressions of the DGF parser
+ *         with the evaluation of the parsed expressions
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/fvector.hh>
+
+#include <dune/grid/io/file/dgfparser/blocks/projection.hh>
+
+typedef Dune::dgf::ProjectionBlock ProjectionBlock;
+typedef ProjectionBlock::Expression Expression;
+typedef ProjectionBlock::CompiledExpression CompiledExpression;
+
+
+// points in [-1,1]^dimworld, none of them at the origin
+std::vector< double > testPoints ( int dimworld, std::size_t count )
+{
+  std::vector< double > points( count*dimworld );
+  for( std::size_t p = 0; p < count; ++p )
+  {
+    for( int i = 0; i < dimworld; ++i )
+      points[ p*dimworld + i ] = std::sin( 0.7*double( p+1 ) + 1.3*double( i ) );
+  }
+  return points;
+}
+
+
+// evaluate one function of a projection block point by point and in batches
+bool checkFunction ( const ProjectionBlock &block, const std::string &name, int dimworld )
+{
+  const Expression *expression = block.function( name );
+  if( !expression )
+  {
+    std::cerr << "Error: function " << name << " not found." << std::endl;
+    return false;
+  }
+
+  const CompiledExpression program( *expression, dimworld );
+
+  // more than one block of the batched evaluation and a partial block
+  const std::size_t count = 150;
+  const std::vector< double > points = testPoints( dimworld, count );
+
+  const int resultSize = program.resultSize();
+  std::vector< double > expected;
+  std::vector< double > x( dimworld ), y;
+  for( std::size_t p = 0; p < count; ++p )
+  {
+    x.assign( points.begin() + p*dimworld, points.begin() + (p+1)*dimworld );
+    expression->evaluate( x, y );
+    if( int( y.size() ) != resultSize )
+    {
+      std::cerr << "Error: function " << name << " returns " << y.size() << " components, "
+                << "its compiled version " << resultSize << "." << std::endl;
+      return false;
+    }
+    expected.insert( expected.end(), y.begin(), y.end() );
+  }
+
+  bool success = true;
+
+  std::vector< double > single( resultSize );
+  for( std::size_t p = 0; p < count; ++p )
+  {
+    program.evaluate( &points[ p*dimworld ], &single[ 0 ] );
+    for( int i = 0; i < resultSize; ++i )
+    {
+      if( single[ i ] != expected[ p*resultSize + i ] )
+      {
+        std::cerr << "Error: compiled function " << name << " differs in point " << p
+                  << ", component " << i << ": " << single[ i ]
+                  << " instead of " << expected[ p*resultSize + i ] << "." << std::endl;
+        success = false;
+      }
+    }
+  }
+
+  std::vector< double > batched( count*resultSize );
+  program.evaluate( count, &points[ 0 ], &batched[ 0 ] );
+  for( std::size_t k = 0; k < batched.size(); ++k )
+  {
+    if( batched[ k ] != expected[ k ] )
+    {
+      std::cerr << "Error: batched function " << name << " differs in point " << (k / resultSize)
+                << ", component " << (k % resultSize) << ": " << batched[ k ]
+                << " instead of " << expected[ k ] << "." << std::endl;
+      success = false;
+    }
+  }
+
+  return success;
+}
+
+
+// check all functions of the projection block in an example grid file
+bool checkFile ( const std::string &name, int dimworld, const std::vector< std::string > &functions )
+{
+  const std::string filename = std::string( DUNE_GRID_EXAMPLE_GRIDS_PATH ) + "dgf/" + name;
+  std::ifstream file( filename.c_str() );
+  if( !file )
+    DUNE_THROW( Dune::IOError, "Could not open " << filename << "." );
+
+  std::cout << "Checking projection functions in " << name << std::endl;
+  const ProjectionBlock block( file, dimworld );
+
+  bool success = true;
+  for( std::size_t i = 0; i < functions.size(); ++i )
+    success &= checkFunction( block, functions[ i ], dimworld );
+  return success;
+}
+
+
+// boundary projections use the first dimworld components of the function
+bool checkBoundaryProjection ()
+{
+  std::istringstream input( "DGF\n"
+                            "PROJECTION\n"
+                            "function lifted( x ) = [ x[ 0 ], 2 * x[ 1 ], 1 ]\n"
+                            "function scalar( x ) = x[ 0 ]\n"
+                            "default lifted\n"
+                            "segment 0 1 scalar\n"
+                            "#\n" );
+  const ProjectionBlock block( input, 2 );
+
+  bool success = true;
+
+  const Dune::DuneBoundaryProjection< 2 > *projection = block.defaultProjection< 2 >();
+  Dune::FieldVector< double, 2 > x;
+  x[ 0 ] = 0.25;
+  x[ 1 ] = -0.5;
+  const Dune::FieldVector< double, 2 > y = (*projection)( x );
+  if( (y[ 0 ] != x[ 0 ]) || (y[ 1 ] != 2*x[ 1 ]) )
+  {
+    std::cerr << "Error: boundary projection with 3 components returns " << y << "." << std::endl;
+    success = false;
+  }
+  delete projection;
+
+  try
+  {
+    delete block.boundaryProjection< 2 >( 0 );
+    std::cerr << "Error: boundary projection with 1 component accepted." << std::endl;
+    success = false;
+  }
+  catch( const Dune::MathError & )
+  {}
+
+  return success;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  bool success = true;
+
+  std::vector< std::string > functions;
+  functions.push_back( "p" );
+  functions.push_back( "id" );
+  success &= checkFile( "example-projection.dgf", 2, functions );
+
+  functions.clear();
+  functions.push_back( "angle" );
+  functions.push_back( "coordfunction" );
+  success &= checkFile( "helix.dgf", 3, functions );
+  success &= checkFile( "helix-deprecated.dgf", 3, functions );
+
+  success &= checkBoundaryProjection();
+
+  return (success ? 0 : 1);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
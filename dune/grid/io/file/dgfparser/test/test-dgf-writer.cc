@@ -0,0 +1,119 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+/** \file
+ *  \brief write distributed grids with DGFWriter::writeParallel and read
+ *         the files back with GridPtr
+ */
+
+#include <bitset>
+#include <iostream>
+#include <set>
+#include <string>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/onedgrid.hh>
+#include <dune/grid/yaspgrid.hh>
+#include <dune/grid/io/file/dgfparser/dgfoned.hh>
+#include <dune/grid/io/file/dgfparser/dgfwriter.hh>
+#include <dune/grid/utility/globalindexset.hh>
+
+#if ENABLE_ALUGRID
+#include <dune/grid/alugrid.hh>
+#include <dune/grid/io/file/dgfparser/dgfalu.hh>
+#endif
+
+using namespace Dune;
+
+// read a DGF file on this rank only and compare its sizes
+template< class ReadGrid >
+void checkReadGrid ( const std::string &fileName, int elements, int vertices )
+{
+  GridPtr< ReadGrid > gridPtr( fileName, MPIHelper::getLocalCommunicator() );
+  const int readElements = gridPtr->size( 0 );
+  const int readVertices = gridPtr->size( ReadGrid::dimension );
+  if( (readElements != elements) || (readVertices != vertices) )
+    DUNE_THROW( GridError, "'" << fileName << "' contains " << readElements << " elements and "
+                               << readVertices << " vertices instead of " << elements << " and " << vertices << "." );
+}
+
+template< class ReadGrid, class GridView >
+void checkWriteParallel ( const GridView &gridView, const std::string &fileName )
+{
+  typedef typename GridView::template Codim< 0 >::template Partition< Interior_Partition >::Iterator Iterator;
+  typedef DGFWriter< GridView > Writer;
+
+  const int dim = GridView::dimension;
+  const typename GridView::CollectiveCommunication &comm = gridView.comm();
+
+  // interior elements of this rank and the vertices they use
+  int elements = 0;
+  std::set< typename GridView::IndexSet::IndexType > vertices;
+  const Iterator end = gridView.template end< 0, Interior_Partition >();
+  for( Iterator it = gridView.template begin< 0, Interior_Partition >(); it != end; ++it, ++elements )
+  {
+    for( unsigned int i = 0; i < it->subEntities( dim ); ++i )
+      vertices.insert( gridView.indexSet().subIndex( *it, i, dim ) );
+  }
+
+  const int globalElements = comm.sum( elements );
+  const int globalVertices = GlobalIndexSet< GridView >( gridView, dim ).size( dim );
+
+  Writer writer( gridView );
+
+  // every rank reads the complete merged file
+  writer.writeParallel( fileName, Writer::mergedFile );
+  checkReadGrid< ReadGrid >( fileName, globalElements, globalVertices );
+
+  // every rank reads its own partition
+  writer.writeParallel( fileName, Writer::partitionFiles );
+  checkReadGrid< ReadGrid >( Writer::partitionFileName( fileName, comm.rank() ), elements, vertices.size() );
+}
+
+int main ( int argc, char **argv )
+try
+{
+  MPIHelper::instance( argc, argv );
+
+  {
+    std::cout << "Checking distributed YaspGrid< 1 >" << std::endl;
+    Dune::array< int, 1 > cells = {{ 32 }};
+    YaspGrid< 1 > grid( FieldVector< double, 1 >( 1.0 ), cells, std::bitset< 1 >(), 1 );
+    checkWriteParallel< OneDGrid >( grid.leafGridView(), "writeparallel-yasp-1d.dgf" );
+  }
+
+#if ENABLE_ALUGRID
+  typedef ALUGrid< 3, 3, cube, nonconforming > ALUCubeGrid;
+
+  {
+    std::cout << "Checking distributed YaspGrid< 3 >" << std::endl;
+    Dune::array< int, 3 > cells = {{ 4, 4, 4 }};
+    YaspGrid< 3 > grid( FieldVector< double, 3 >( 1.0 ), cells, std::bitset< 3 >(), 1 );
+    checkWriteParallel< ALUCubeGrid >( grid.leafGridView(), "writeparallel-yasp-3d.dgf" );
+  }
+
+  {
+    std::cout << "Checking distributed ALUGrid< 3, 3, cube, nonconforming >" << std::endl;
+    GridPtr< ALUCubeGrid > gridPtr( DUNE_GRID_EXAMPLE_GRIDS_PATH "dgf/test3d.dgf" );
+    gridPtr->globalRefine( 1 );
+    gridPtr.loadBalance();
+    checkWriteParallel< ALUCubeGrid >( gridPtr->leafGridView(), "writeparallel-alu-3d.dgf" );
+  }
+#endif // #if ENABLE_ALUGRID
+
+  return 0;
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
+catch( ... )
+{
+  std::cerr << "Generic exception!" << std::endl;
+  return 1;
+}
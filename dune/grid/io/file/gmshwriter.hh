@@ -6,14 +6,17 @@
 
 #include <fstream>
 #include <iostream>
-
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 
 #include <dune/geometry/type.hh>
 
 #include <dune/grid/common/grid.hh>
+#include <dune/grid/io/file/bufferedoutputfile.hh>
+#include <dune/grid/utility/globalindexset.hh>
 
 
 namespace Dune {
@@ -23,7 +26,8 @@ namespace Dune {
 
      \brief Write Gmsh mesh file
 
-     Write a grid using the given GridView as an ASCII Gmsh file of version 2.0.
+     Write a grid using the given GridView as a Gmsh file. The ASCII format
+     is written as version 2.0, the binary format as version 2.2.
 
      If the grid contains an element type not supported by gmsh an IOError exception is thrown.
 
@@ -32,12 +36,27 @@ namespace Dune {
      All grids in a gmsh file live in three-dimensional Euclidean space. If the world dimension
      of the grid type that you are writing is less than three, the remaining coordinates are
      set to zero.
+
+     For distributed grids, writeParallel() writes the interior elements of
+     all ranks with globally consistent node numbers, either into a single
+     file or into one file per rank.
    */
   template <class GridView>
   class GmshWriter
   {
+  public:
+    //! file format of the mesh file
+    enum Format { ascii, binary };
+
+    //! output layout of writeParallel()
+    enum PartitionMode {
+      mergedFile,    //!< all ranks write into one file
+      partitionFiles //!< each rank writes its own file, see partitionFileName()
+    };
+
   private:
     const GridView gv;
+    Format format_;
 
     static const int dim = GridView::dimension;
     static const int dimWorld = GridView::dimensionworld;
@@ -45,12 +64,43 @@ namespace Dune {
 
     typedef typename GridView::template Codim<dim>::Iterator VertexIterator;
     typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+    typedef typename GridView::template Codim<0>::Entity Element;
+    typedef typename GridView::template Codim<dim>::Entity Vertex;
+    typedef typename Vertex::Geometry::GlobalCoordinate GlobalCoordinate;
 
+    //! largest Gmsh element type number used
+    static const std::size_t maxGmshType = 15;
 
-    /** \brief Returns index of i-th vertex of an element, plus 1 (for gmsh numbering) */
-    size_t nodeIndexFromIterator(const ElementIterator& eIt, int i) const {
-      return gv.indexSet().subIndex(*eIt, i, dim)+1;
-    }
+    /** \brief Node numbers of the local numbering (index plus 1) */
+    struct LocalNodeNumber
+    {
+      explicit LocalNodeNumber ( const GridView &gridView ) : gridView_( gridView ) {}
+
+      std::size_t operator() ( const Element &element, int i ) const
+      {
+        return gridView_.indexSet().subIndex( element, i, dim )+1;
+      }
+
+    private:
+      const GridView &gridView_;
+    };
+
+    /** \brief Node numbers from a precomputed table indexed by the vertex index */
+    struct TableNodeNumber
+    {
+      TableNodeNumber ( const GridView &gridView, const std::vector< std::size_t > &table )
+        : gridView_( gridView ), table_( table )
+      {}
+
+      std::size_t operator() ( const Element &element, int i ) const
+      {
+        return table_[ gridView_.indexSet().subIndex( element, i, dim ) ];
+      }
+
+    private:
+      const GridView &gridView_;
+      const std::vector< std::size_t > &table_;
+    };
 
     /** \brief Translate GeometryType to corresponding Gmsh element type number
       * \throws IOError if there is no equivalent type in Gmsh
@@ -81,88 +131,167 @@ namespace Dune {
       return element_type;
     }
 
-    /** \brief Writes all the elements of a grid line by line
+    /** \brief Return the Dune corner of the k-th node of a Gmsh element
      *
-     * Each line has the format
-     *    element-number element-type number-of-tags <tags> node-number-list
-     * Counting of the element numbers starts by "1".
-     * Tags are ignored, i.e. number-of-tags is always zero and no tags are printed.
-     * node-number-list depends on the type of the given element.
+     * 3, 5 and 7 got different vertex numbering compared to Dune
      */
-    void outputElements(std::ofstream& file) const {
-      ElementIterator eIt    = gv.template begin<0>();
-      ElementIterator eEndIt = gv.template end<0>();
-
-      for (size_t i = 1; eIt != eEndIt; ++eIt, ++i) {
-        // Check whether the type is compatible. If not, close file and rethrow exception.
-        try {
-          size_t element_type = translateDuneToGmshType(eIt->type());
+    static int gmshToDuneCorner ( size_t element_type, int k )
+    {
+      static const int quadrilateral[ 4 ] = { 0, 1, 3, 2 };
+      static const int hexahedron[ 8 ] = { 0, 1, 3, 2, 4, 5, 7, 6 };
+      static const int pyramid[ 5 ] = { 0, 1, 3, 2, 4 };
+
+      switch( element_type )
+      {
+      case 3 : return quadrilateral[ k ];
+      case 5 : return hexahedron[ k ];
+      case 7 : return pyramid[ k ];
+      default : return k;
+      }
+    }
 
-          file << i << " " << element_type << " " << 0; // "0" for "I do not use any tags."
+    /** \brief Write an integer in the binary format */
+    static void writeBinary ( std::ostream &file, int value )
+    {
+      file.write( reinterpret_cast< const char * >( &value ), sizeof( int ) );
+    }
 
-          // Output list of nodes.
-          // 3, 5 and 7 got different vertex numbering compared to Dune
-          if (3 == element_type)
-            file << " "
-                 << nodeIndexFromIterator(eIt, 0) << " " << nodeIndexFromIterator(eIt, 1) << " "
-                 << nodeIndexFromIterator(eIt, 3) << " " << nodeIndexFromIterator(eIt, 2);
-          else if (5 == element_type)
-            file << " "
-                 << nodeIndexFromIterator(eIt, 0) << " " << nodeIndexFromIterator(eIt, 1) << " "
-                 << nodeIndexFromIterator(eIt, 3) << " " << nodeIndexFromIterator(eIt, 2) << " "
-                 << nodeIndexFromIterator(eIt, 4) << " " << nodeIndexFromIterator(eIt, 5) << " "
-                 << nodeIndexFromIterator(eIt, 7) << " " << nodeIndexFromIterator(eIt, 6);
-          else if (7 == element_type)
-            file << " "
-                 << nodeIndexFromIterator(eIt, 0) << " " << nodeIndexFromIterator(eIt, 1) << " "
-                 << nodeIndexFromIterator(eIt, 3) << " " << nodeIndexFromIterator(eIt, 2) << " "
-                 << nodeIndexFromIterator(eIt, 4);
-          else {
-            for (int k = 0; k < eIt->geometry().corners(); ++k)
-              file << " " << nodeIndexFromIterator(eIt, k);
-          }
-
-          file << std::endl;
-
-        } catch(Exception& e) {
-          file.close();
-          throw;
-        }
+    /** \brief Write the mesh format section */
+    void outputHeader ( std::ostream &file ) const
+    {
+      if( format_ == binary )
+      {
+        file << "$MeshFormat\n"
+             << "2.2 1 " << sizeof(double) << "\n"; // "2.2" for "version 2.2", "1" for binary
+        writeBinary( file, 1 ); // allows the reader to detect the endianness
+        file << "\n$EndMeshFormat\n";
+      }
+      else
+      {
+        file << "$MeshFormat\n"
+             << "2.0 0 " << sizeof(double) << "\n" // "2.0" for "version 2.0", "0" for ASCII
+             << "$EndMeshFormat\n";
       }
     }
 
-
-    /** \brief Writes all the vertices of a grid line by line
+    /** \brief Write a single node
      *
-     * Each line has the format
+     * In ASCII each line has the format
      *  node-number x-coord y-coord z-coord
+     */
+    void outputNode ( std::ostream &file, size_t nodeNumber, const GlobalCoordinate &globalCoord ) const
+    {
+      double x[ 3 ] = { 0, 0, 0 };
+      for( int k = 0; k < dimWorld; ++k )
+        x[ k ] = globalCoord[ k ];
+
+      if( format_ == binary )
+      {
+        writeBinary( file, nodeNumber );
+        file.write( reinterpret_cast< const char * >( x ), 3*sizeof( double ) );
+      }
+      else
+        file << nodeNumber << " " << x[ 0 ] << " " << x[ 1 ] << " " << x[ 2 ] << "\n";
+    }
+
+    /** \brief Writes all the vertices of a grid
+     *
      * The node-numbers will most certainly not have the arrangement "1, 2, 3, ...".
      */
-    void outputNodes(std::ofstream& file) const {
+    void outputNodes(std::ostream& file) const {
       VertexIterator vIt    = gv.template begin<dim>();
       VertexIterator vEndIt = gv.template end<dim>();
 
-      for (; vIt != vEndIt; ++vIt) {
-        typename VertexIterator::Entity::Geometry::GlobalCoordinate globalCoord = vIt->geometry().center();
-        int nodeIndex = gv.indexSet().index(*vIt)+1; // Start counting indices by "1".
+      for (; vIt != vEndIt; ++vIt)
+        outputNode( file, gv.indexSet().index(*vIt)+1, vIt->geometry().center() ); // Start counting indices by "1".
+    }
+
+    /** \brief Writes the elements of a partition of the grid
+     *
+     * In ASCII each line has the format
+     *    element-number element-type number-of-tags <tags> node-number-list
+     * Counting of the element numbers starts by firstNumber.
+     * Tags are ignored, i.e. number-of-tags is always zero and no tags are printed.
+     * node-number-list depends on the type of the given element.
+     *
+     * In binary format the elements are grouped into one block per element type.
+     */
+    template< PartitionIteratorType pitype, class NodeNumber >
+    void outputElements ( std::ostream &file, size_t firstNumber, const NodeNumber &nodeNumber ) const
+    {
+      typedef typename GridView::template Codim< 0 >::template Partition< pitype >::Iterator Iterator;
+
+      std::vector< std::vector< int > > blocks( format_ == binary ? maxGmshType+1 : 0 );
+      std::vector< int > blockSize( blocks.size(), 0 );
+
+      const Iterator end = gv.template end< 0, pitype >();
+      size_t i = firstNumber;
+      for( Iterator it = gv.template begin< 0, pitype >(); it != end; ++it, ++i )
+      {
+        const Element &element = *it;
+        const size_t element_type = translateDuneToGmshType( element.type() );
+        const int corners = element.subEntities( dim );
+
+        if( format_ == binary )
+        {
+          std::vector< int > &block = blocks[ element_type ];
+          block.push_back( i );
+          for( int k = 0; k < corners; ++k )
+            block.push_back( nodeNumber( element, gmshToDuneCorner( element_type, k ) ) );
+          ++blockSize[ element_type ];
+        }
+        else
+        {
+          file << i << " " << element_type << " " << 0; // "0" for "I do not use any tags."
+          for( int k = 0; k < corners; ++k )
+            file << " " << nodeNumber( element, gmshToDuneCorner( element_type, k ) );
+          file << "\n";
+        }
+      }
 
-        if (1 == dimWorld)
-          file << nodeIndex << " " << globalCoord[0] << " " << 0 << " " << 0 << std::endl;
-        else if (2 == dimWorld)
-          file << nodeIndex << " " << globalCoord[0] << " " << globalCoord[1] << " " << 0 << std::endl;
-        else // (3 == dimWorld)
-          file << nodeIndex << " " << globalCoord[0] << " " << globalCoord[1] << " " << globalCoord[2] << std::endl;
+      // header of each block: element-type number-of-elements number-of-tags
+      for( size_t type = 0; type < blocks.size(); ++type )
+      {
+        if( blockSize[ type ] == 0 )
+          continue;
+        writeBinary( file, type );
+        writeBinary( file, blockSize[ type ] );
+        writeBinary( file, 0 );
+        file.write( reinterpret_cast< const char * >( blocks[ type ].data() ), blocks[ type ].size()*sizeof( int ) );
       }
     }
 
+    /** \brief Throw an IOError if a file could not be opened */
+    static void checkOpen ( const BufferedOutputFile &file, const std::string &fileName )
+    {
+      if (!file.is_open())
+        DUNE_THROW(Dune::IOError, "Could not open " << fileName << " with write access.");
+    }
+
+    /** \brief Close the file and throw an IOError if any write failed */
+    static void checkClose ( std::ofstream &file, const std::string &fileName )
+    {
+      file.close();
+      if( !file )
+        DUNE_THROW( IOError, "Could not write to " << fileName << "." );
+    }
 
   public:
     /** \brief Constructor expecting GridView of Grid to be written.
         \param gridView GridView that will be used in write(const std::string&).
+        \param format   file format, ASCII or binary
     */
-    GmshWriter(const GridView& gridView) : gv(gridView) {}
+    GmshWriter(const GridView& gridView, Format format = ascii)
+      : gv(gridView), format_(format)
+    {}
 
-    /** \brief Write given grid in Gmsh 2.0 compatible ASCII file.
+    //! set the file format for subsequent writes
+    void setFormat ( Format format ) { format_ = format; }
+
+    //! return the file format
+    Format format () const { return format_; }
+
+    /** \brief Write given grid in Gmsh compatible file.
         \param fileName Path of file. write(const std::string&) does not attach a ".msh"-extension by itself.
 
         Opens the file with given name and path, stores the element data of the grid
@@ -174,38 +303,163 @@ namespace Dune {
         encountered.
     */
     void write(const std::string& fileName) const {
-      std::ofstream file(fileName.c_str());
-
-      if (!file.is_open())
-        DUNE_THROW(Dune::IOError, "Could not open " << fileName << " with write access.");
+      BufferedOutputFile output( fileName, std::ios_base::out | std::ios_base::binary );
+      checkOpen( output, fileName );
+      std::ofstream &file = output.stream();
 
       // Output Header
-      file << "$MeshFormat" << std::endl
-           << "2.0 0 " << sizeof(double) << std::endl // "2.0" for "version 2.0", "0" for ASCII
-           << "$EndMeshFormat" << std::endl;
-
+      outputHeader( file );
 
       // Output Nodes
       const size_t number_of_nodes = gv.size(dim);
-      file << "$Nodes" << std::endl
-           << number_of_nodes << std::endl;
+      file << "$Nodes\n"
+           << number_of_nodes << "\n";
 
       outputNodes(file);
 
-      file << "$EndNodes" << std::endl;
+      file << (format_ == binary ? "\n" : "") << "$EndNodes\n";
 
 
       // Output Elements
       const size_t number_of_elements = gv.size(0);
-      file << "$Elements" << std::endl
-           << number_of_elements << std::endl;
+      file << "$Elements\n"
+           << number_of_elements << "\n";
 
-      outputElements(file);
+      outputElements< All_Partition >( file, 1, LocalNodeNumber( gv ) );
 
-      file << "$EndElements" << std::endl; // Add an additional new line for good measure.
+      file << (format_ == binary ? "\n" : "") << "$EndElements\n";
 
+      checkClose( file, fileName );
+    }
 
-      file.close();
+    /** \brief Write the interior elements of a distributed grid.
+
+        The nodes are numbered globally consistent through a GlobalIndexSet
+        and the elements are numbered consecutively in rank order, so the
+        files of all ranks fit together. This method is collective.
+
+        \param fileName Path of the (merged) file.
+        \param mode     write one merged file or one file per rank named
+                        by partitionFileName()
+
+        \note The grid has to support communication of vertices.
+    */
+    void writeParallel ( const std::string &fileName, PartitionMode mode = mergedFile ) const
+    {
+      const typename GridView::CollectiveCommunication &comm = gv.comm();
+      const int rank = comm.rank();
+
+      // global node numbers for all local vertices
+      GlobalIndexSet< GridView > globalIndexSet( gv, dim );
+      std::vector< size_t > nodeNumbers( gv.size( dim ), 0 );
+      std::vector< GlobalCoordinate > nodes( gv.size( dim ) );
+
+      typedef typename GridView::template Codim< 0 >::template Partition< Interior_Partition >::Iterator InteriorIterator;
+      const InteriorIterator end = gv.template end< 0, Interior_Partition >();
+      size_t number_of_elements = 0;
+      for( InteriorIterator it = gv.template begin< 0, Interior_Partition >(); it != end; ++it, ++number_of_elements )
+      {
+        const Element &element = *it;
+        const int corners = element.subEntities( dim );
+        for( int k = 0; k < corners; ++k )
+        {
+          const size_t index = gv.indexSet().subIndex( element, k, dim );
+          if( nodeNumbers[ index ] != 0 )
+            continue;
+          nodeNumbers[ index ] = globalIndexSet.subIndex( element, k, dim )+1;
+          nodes[ index ] = element.geometry().corner( k );
+        }
+      }
+
+      // element numbers are consecutive in rank order
+      std::vector< size_t > elementCounts( comm.size() );
+      comm.allgather( &number_of_elements, 1, elementCounts.data() );
+      size_t firstElement = 1;
+      for( int r = 0; r < rank; ++r )
+        firstElement += elementCounts[ r ];
+
+      const TableNodeNumber nodeNumber( gv, nodeNumbers );
+
+      if( mode == partitionFiles )
+      {
+        const std::string name = partitionFileName( fileName, rank );
+        BufferedOutputFile output( name, std::ios_base::out | std::ios_base::binary );
+        checkOpen( output, name );
+        std::ofstream &file = output.stream();
+
+        size_t number_of_nodes = 0;
+        for( size_t i = 0; i < nodeNumbers.size(); ++i )
+          number_of_nodes += (nodeNumbers[ i ] != 0);
+
+        outputHeader( file );
+        file << "$Nodes\n" << number_of_nodes << "\n";
+        for( size_t i = 0; i < nodeNumbers.size(); ++i )
+        {
+          if( nodeNumbers[ i ] != 0 )
+            outputNode( file, nodeNumbers[ i ], nodes[ i ] );
+        }
+        file << (format_ == binary ? "\n" : "") << "$EndNodes\n";
+
+        file << "$Elements\n" << number_of_elements << "\n";
+        outputElements< Interior_Partition >( file, firstElement, nodeNumber );
+        file << (format_ == binary ? "\n" : "") << "$EndElements\n";
+
+        checkClose( file, name );
+        return;
+      }
+
+      // each node is written by the rank owning its global index
+      std::ostringstream nodeData;
+      for( size_t i = 0; i < nodeNumbers.size(); ++i )
+      {
+        if( (nodeNumbers[ i ] != 0) && globalIndexSet.owned( nodeNumbers[ i ]-1 ) )
+          outputNode( nodeData, nodeNumbers[ i ], nodes[ i ] );
+      }
+
+      std::ostringstream elementData;
+      outputElements< Interior_Partition >( elementData, firstElement, nodeNumber );
+
+      // sizes of the sections are collective
+      const unsigned int number_of_nodes = globalIndexSet.size( dim );
+      const size_t total_elements = comm.sum( number_of_elements );
+
+      // rank 0 writes the section headers, the last rank the end of the file
+      std::string nodeSection, elementSection;
+      if( rank == 0 )
+      {
+        std::ostringstream header;
+        outputHeader( header );
+        header << "$Nodes\n" << number_of_nodes << "\n";
+        nodeSection = header.str();
+
+        std::ostringstream separator;
+        separator << (format_ == binary ? "\n" : "") << "$EndNodes\n"
+                  << "$Elements\n" << total_elements << "\n";
+        elementSection = separator.str();
+      }
+      nodeSection += nodeData.str();
+      elementSection += elementData.str();
+      if( rank == comm.size()-1 )
+        elementSection += std::string( format_ == binary ? "\n" : "" ) + "$EndElements\n";
+
+      appendInRankOrder( comm, fileName, nodeSection, true, std::ios_base::binary );
+      appendInRankOrder( comm, fileName, elementSection, false, std::ios_base::binary );
+    }
+
+    /** \brief Return the name of the file written by a rank in partitionFiles mode
+
+        A trailing ".msh" is kept as extension, e.g. "mesh.msh" becomes
+        "mesh_1.msh" on rank 0 (Gmsh counts partitions starting with 1).
+    */
+    static std::string partitionFileName ( const std::string &fileName, int rank )
+    {
+      const std::string extension( ".msh" );
+      std::ostringstream name;
+      if( (fileName.size() >= extension.size()) && (fileName.compare( fileName.size() - extension.size(), extension.size(), extension ) == 0) )
+        name << fileName.substr( 0, fileName.size() - extension.size() ) << "_" << (rank+1) << extension;
+      else
+        name << fileName << "_" << (rank+1);
+      return name.str();
     }
   };
 
@@ -4,6 +4,12 @@
 #include "config.h"
 #define DISABLE_DEPRECATED_METHOD_CHECK 1
 
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
 // dune grid includes
@@ -47,6 +53,96 @@ struct EnableLevelIntersectionIteratorCheck< Dune::AlbertaGrid< dim, dimworld >
 };
 #endif
 
+// read the numbers of nodes and elements from the section headers of a
+// Gmsh file; they are ASCII in binary files, too
+void readGmshCounts ( const std::string &fileName, int &nodes, int &elements )
+{
+  std::ifstream file( fileName.c_str(), std::ios_base::in | std::ios_base::binary );
+  if( !file )
+    DUNE_THROW( IOError, "Could not open " << fileName << "." );
+
+  nodes = elements = -1;
+  std::string line;
+  while( std::getline( file, line ) )
+  {
+    if( line == "$Nodes" )
+      file >> nodes;
+    else if( line == "$Elements" )
+      file >> elements;
+  }
+  if( (nodes < 0) || (elements < 0) )
+    DUNE_THROW( IOError, "Missing $Nodes or $Elements in " << fileName << "." );
+}
+
+// the node numbers in an ASCII Gmsh file
+std::vector< int > readGmshNodeNumbers ( const std::string &fileName )
+{
+  std::ifstream file( fileName.c_str() );
+  std::string line;
+  while( std::getline( file, line ) && (line != "$Nodes") )
+    continue;
+
+  int count = 0;
+  file >> count;
+  std::vector< int > numbers( count );
+  for( int i = 0; i < count; ++i )
+  {
+    double x;
+    file >> numbers[ i ] >> x >> x >> x;
+  }
+  if( !file )
+    DUNE_THROW( IOError, "Could not read the nodes of " << fileName << "." );
+  return numbers;
+}
+
+void checkGmshCounts ( const std::string &fileName, int nodes, int elements )
+{
+  int fileNodes, fileElements;
+  readGmshCounts( fileName, fileNodes, fileElements );
+  if( (fileNodes != nodes) || (fileElements != elements) )
+    DUNE_THROW( GridError, fileName << " contains " << fileNodes << " nodes and " << fileElements
+                                    << " elements instead of " << nodes << " and " << elements << "." );
+}
+
+// check the numbers of nodes and elements in all files written by the
+// GmshWriter and that each node of the merged file has exactly one owner
+template< class GridView >
+void checkWrittenFiles ( const GridView &gridView, const std::string &outFilename )
+{
+  typedef Dune::GmshWriter< GridView > GmshWriter;
+  const int dim = GridView::dimension;
+
+  checkGmshCounts( outFilename, gridView.size( dim ), gridView.size( 0 ) );
+  checkGmshCounts( outFilename + ".binary.msh", gridView.size( dim ), gridView.size( 0 ) );
+
+  // the parallel output only contains the interior elements and their vertices
+  typedef typename GridView::template Codim< 0 >::template Partition< Dune::Interior_Partition >::Iterator Iterator;
+  int interior = 0;
+  std::set< int > vertices;
+  for( Iterator it = gridView.template begin< 0, Dune::Interior_Partition >(); it != gridView.template end< 0, Dune::Interior_Partition >(); ++it, ++interior )
+  {
+    for( unsigned int k = 0; k < it->subEntities( dim ); ++k )
+      vertices.insert( gridView.indexSet().subIndex( *it, k, dim ) );
+  }
+
+  const int rank = gridView.comm().rank();
+  checkGmshCounts( GmshWriter::partitionFileName( outFilename + ".partition.msh", rank ), vertices.size(), interior );
+  checkGmshCounts( GmshWriter::partitionFileName( outFilename + ".partition.binary.msh", rank ), vertices.size(), interior );
+
+  int nodes, elements;
+  readGmshCounts( outFilename + ".parallel.msh", nodes, elements );
+  if( elements != gridView.comm().sum( interior ) )
+    DUNE_THROW( GridError, "Wrong number of elements in " << outFilename << ".parallel.msh." );
+  if( (gridView.comm().size() == 1) && (nodes != gridView.size( dim )) )
+    DUNE_THROW( GridError, "Wrong number of nodes in " << outFilename << ".parallel.msh." );
+  checkGmshCounts( outFilename + ".parallel.binary.msh", nodes, elements );
+
+  // every node is written once, by its owner
+  const std::vector< int > numbers = readGmshNodeNumbers( outFilename + ".parallel.msh" );
+  if( (int( numbers.size() ) != nodes) || (int( std::set< int >( numbers.begin(), numbers.end() ).size() ) != nodes) )
+    DUNE_THROW( GridError, "Nodes missing or written twice in " << outFilename << ".parallel.msh." );
+}
+
 template <typename GridType>
 void testReadingAndWritingGrid( const std::string& filename, const std::string& outFilename, int refinements )
 {
@@ -68,9 +164,21 @@ void testReadingAndWritingGrid( const std::string& filename, const std::string&
 #endif // #if HAVE_GRAPE
 
   // Test writing
-  Dune::GmshWriter<typename GridType::LeafGridView> writer( grid->leafGridView() );
+  typedef Dune::GmshWriter<typename GridType::LeafGridView> GmshWriter;
+  GmshWriter writer( grid->leafGridView() );
   writer.write( outFilename );
 
+  // Test parallel and binary writing
+  writer.writeParallel( outFilename + ".parallel.msh" );
+  writer.writeParallel( outFilename + ".partition.msh", GmshWriter::partitionFiles );
+  writer.setFormat( GmshWriter::binary );
+  writer.write( outFilename + ".binary.msh" );
+  writer.writeParallel( outFilename + ".parallel.binary.msh" );
+  writer.writeParallel( outFilename + ".partition.binary.msh", GmshWriter::partitionFiles );
+
+  // read everything back
+  checkWrittenFiles( grid->leafGridView(), outFilename );
+
   // vtk output
   std::ostringstream vtkName;
   vtkName << filename << "-" << refinements;
@@ -7,6 +7,11 @@
 #include <dune/grid/yaspgrid.hh>
 #include <dune/grid/io/file/vtk/vtksequencewriter.hh>
 
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
 #include <vector>
 #include <unistd.h>
 
@@ -62,7 +67,7 @@ public:
 };
 
 template< class GridView >
-void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
+int doWrite( const GridView &gridView, Dune::VTK::DataMode dm, bool async = false )
 {
   enum { dim = GridView :: dimension };
 
@@ -72,9 +77,15 @@ void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
 
   std::stringstream name;
   name << "vtktest-" << dim << "D-" << VTKDataMode(dm);
+  if(async)
+    name << "-async";
   Dune :: VTKSequenceWriter< GridView >
   vtk( gridView, name.str(), ".", "", dm );
-
+  // write in the background and reuse the points and cells
+  if(async) {
+    vtk.setAsynchronous();
+    vtk.setGridGeneration(0);
+  }
 
   vtk.addVertexData(vertexdata,"vertexData");
   vtk.addCellData(celldata,"cellData");
@@ -82,11 +93,49 @@ void doWrite( const GridView &gridView, Dune::VTK::DataMode dm )
     (new VTKVectorFunction< GridView >);
   vtk.addVertexData(vectordata);
   double time = 0;
+  int steps = 0;
   while (time<1) {
     vectordata->setTime(time);
     vtk.write(time);
+    // the data written in the background must not see this change
+    celldata.assign(celldata.size(), ++steps);
     time += 0.1;
   }
+  vtk.flush();
+  return steps;
+}
+
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  if(!file)
+    DUNE_THROW(Dune::IOError, "Could not read " << fileName);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+// compare the output of doWrite() with the one written asynchronously
+template< class GridView >
+void checkAsync( const GridView &gridView, Dune::VTK::DataMode dm )
+{
+  enum { dim = GridView :: dimension };
+
+  const int steps = doWrite( gridView, dm );
+  doWrite( gridView, dm, true );
+  if( gridView.comm().size() > 1 )
+    return;
+
+  std::stringstream name;
+  name << "vtktest-" << dim << "D-" << VTKDataMode(dm);
+  const char* extension = (dim == 1 ? ".vtp" : ".vtu");
+  for(int i = 0; i < steps; ++i)
+  {
+    std::ostringstream sync, async;
+    sync << name.str() << "-" << std::setw(5) << std::setfill('0') << i << extension;
+    async << name.str() << "-async-" << std::setw(5) << std::setfill('0') << i << extension;
+    if(readFile(sync.str()) != readFile(async.str()))
+      DUNE_THROW(Dune::Exception, async.str() << " differs from " << sync.str());
+  }
 }
 
 template<int dim>
@@ -97,8 +146,8 @@ void vtkCheck(const Dune::array<int,dim>& n,
   Dune::YaspGrid<dim> g(h, n);
   g.globalRefine(1);
 
-  doWrite( g.template leafGridView(), Dune::VTK::conforming );
-  doWrite( g.template leafGridView(), Dune::VTK::nonconforming );
+  checkAsync( g.template leafGridView(), Dune::VTK::conforming );
+  checkAsync( g.template leafGridView(), Dune::VTK::nonconforming );
   doWrite( g.template levelGridView( 0 ), Dune::VTK::conforming );
   doWrite( g.template levelGridView( 0 ), Dune::VTK::nonconforming );
   doWrite( g.template levelGridView( g.maxLevel() ), Dune::VTK::conforming );
@@ -6,6 +6,11 @@
 #endif
 
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <ostream>
 #include <sstream>
@@ -93,6 +98,187 @@ struct Acc
   }
 };
 
+// read the whole contents of a file
+std::string readFile(const std::string &name)
+{
+  std::ifstream file(name.c_str(), std::ios::binary);
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+// extract the Piece element (including indentation) from a VTK file
+std::string extractPiece(const std::string &contents)
+{
+  const std::string endTag = "</Piece>\n";
+  std::string::size_type begin = contents.find("<Piece");
+  std::string::size_type end = contents.find(endTag);
+  if(begin == std::string::npos || end == std::string::npos)
+    return "";
+  begin = contents.rfind('\n', begin) + 1;
+  return contents.substr(begin, end + endTag.size() - begin);
+}
+
+// return the value of an attribute of the XML element starting at pos
+std::string attribute(const std::string &contents, std::string::size_type pos,
+                      const std::string &name)
+{
+  const std::string::size_type end = contents.find('>', pos);
+  const std::string::size_type begin = contents.find(" " + name + "=\"", pos);
+  if(begin == std::string::npos || begin > end)
+    return "";
+  const std::string::size_type first = begin + name.size() + 3;
+  return contents.substr(first, contents.find('"', first) - first);
+}
+
+// position of the last tag before pos, or -1 if there is none
+long long lastTag(const std::string &contents, const std::string &tag,
+                  std::string::size_type pos)
+{
+  const std::string::size_type found = contents.rfind(tag, pos);
+  return (found == std::string::npos ? -1 : (long long)found);
+}
+
+// read a value of type T at the given byte position of a string
+template<class T>
+T readValue(const std::string &contents, std::string::size_type pos)
+{
+  T value;
+  std::memcpy(&value, contents.data() + pos, sizeof(T));
+  return value;
+}
+
+// compare the byte counts in an appended raw VTK file with the Piece header
+/*
+ * Each array is preceded by a 32 bit header holding its size in bytes.  This
+ * size has to match the number of items given by the Piece element, and the
+ * offset attributes have to step over header and data.  The number of
+ * corners is taken from the last entry of the offsets array.
+ */
+int checkAppendedSizes(const std::string &name, const std::string &indexType)
+{
+  const std::string contents = readFile(name);
+  const std::string::size_type piece = contents.find("<Piece");
+  std::string::size_type data = contents.find("<AppendedData");
+  if(piece == std::string::npos || data == std::string::npos)
+  {
+    std::cerr << "Error: " << name << " has no Piece or AppendedData" << std::endl;
+    return 1;
+  }
+  data = contents.find('_', data) + 1;
+
+  const bool polyData = (contents.find("<PolyData") != std::string::npos);
+  const long long ncells =
+    std::atoll(attribute(contents, piece, polyData ? "NumberOfLines" : "NumberOfCells").c_str());
+  const long long npoints = std::atoll(attribute(contents, piece, "NumberOfPoints").c_str());
+
+  struct Array { std::string name, type; long long ncomps, offset; bool pointData; };
+  std::vector<Array> arrays;
+  long long ncorners = 0;
+  for(std::string::size_type pos = contents.find("<DataArray", piece);
+      pos < data; pos = contents.find("<DataArray", pos + 1))
+  {
+    // the array belongs to the points if the innermost open section is PointData or Points
+    const long long points =
+      std::max(lastTag(contents, "<PointData", pos), lastTag(contents, "<Points", pos));
+    const long long cells =
+      std::max(lastTag(contents, "<CellData", pos),
+               lastTag(contents, polyData ? "<Lines" : "<Cells", pos));
+    Array array = { attribute(contents, pos, "Name"), attribute(contents, pos, "type"),
+                    std::atoll(attribute(contents, pos, "NumberOfComponents").c_str()),
+                    std::atoll(attribute(contents, pos, "offset").c_str()),
+                    points > cells };
+    arrays.push_back(array);
+
+    if(array.name == "offsets" && ncells > 0)
+    {
+      const std::string::size_type end =
+        data + array.offset + 4 + readValue<std::uint32_t>(contents, data + array.offset);
+      if(array.type == "Int64")
+        ncorners = readValue<std::int64_t>(contents, end - 8);
+      else
+        ncorners = readValue<std::int32_t>(contents, end - 4);
+    }
+  }
+
+  int result = 0;
+  long long offset = 0;
+  for(std::size_t i = 0; i < arrays.size(); ++i)
+  {
+    const Array &array = arrays[i];
+    const long long typeSize =
+      std::atoll(array.type.c_str() + array.type.find_first_of("0123456789")) / 8;
+    const long long nitems =
+      (array.name == "connectivity" ? ncorners : (array.pointData ? npoints : ncells));
+
+    const std::uint32_t bytes = readValue<std::uint32_t>(contents, data + array.offset);
+    if(array.offset != offset || bytes != array.ncomps*nitems*typeSize)
+    {
+      std::cerr << "Error: array " << array.name << " in " << name << " has offset "
+                << array.offset << " and " << bytes << " bytes, expected offset "
+                << offset << " and " << array.ncomps*nitems*typeSize << " bytes" << std::endl;
+      result = 1;
+    }
+    if((array.name == "connectivity" || array.name == "offsets") && array.type != indexType)
+    {
+      std::cerr << "Error: array " << array.name << " in " << name << " has type "
+                << array.type << " instead of " << indexType << std::endl;
+      result = 1;
+    }
+    offset += 4 + bytes;
+  }
+  return result;
+}
+
+// name of the file holding the piece of this rank
+template< class GridView >
+std::string pieceFileName( const GridView &gridView, const std::string &prefix )
+{
+  const int size = gridView.comm().size();
+  const std::string extension = (GridView::dimension > 1 ? ".vtu" : ".vtp");
+  if(size == 1)
+    return prefix + extension;
+  std::ostringstream name;
+  name << 's' << std::setw(4) << std::setfill('0') << size
+       << "-p" << std::setw(4) << gridView.comm().rank() << '-' << prefix << extension;
+  return name.str();
+}
+
+// compare aggregated parallel output with one file per rank
+template< class GridView >
+int checkAggregation( Dune::VTKWriter< GridView > &vtk, const GridView &gridView,
+                      const std::string &prefix )
+{
+  const int rank = gridView.comm().rank();
+  const int size = gridView.comm().size();
+  const int groupSize = 2;
+  const std::string extension = (GridView::dimension > 1 ? ".vtu" : ".vtp");
+
+  vtk.pwrite(prefix + "-perrank", "", "", Dune::VTK::base64);
+  vtk.setAggregationSize(groupSize);
+  const std::string name = vtk.pwrite(prefix + "-aggregated", "", "", Dune::VTK::base64);
+  vtk.setAggregationSize(1);
+
+  int result = 0;
+  if(rank == 0) acc(result, checkVTKFile(name));
+
+  // the piece of this rank has to appear unchanged in the file of its group
+  std::ostringstream pieceName, groupName;
+  pieceName << 's' << std::setw(4) << std::setfill('0') << size
+            << "-p" << std::setw(4) << rank << '-' << prefix << "-perrank" << extension;
+  groupName << 's' << std::setw(4) << std::setfill('0') << size
+            << "-a" << std::setw(4) << rank / groupSize << '-' << prefix << "-aggregated" << extension;
+
+  const std::string piece = extractPiece(readFile(pieceName.str()));
+  if(piece.empty() || readFile(groupName.str()).find(piece) == std::string::npos)
+  {
+    std::cerr << "Error: Piece of " << pieceName.str() << " not found in "
+              << groupName.str() << std::endl;
+    acc(result, 1);
+  }
+  return result;
+}
+
 template< class GridView >
 int doWrite( const GridView &gridView, Dune :: VTK :: DataMode dm )
 {
@@ -124,11 +310,29 @@ int doWrite( const GridView &gridView, Dune :: VTK :: DataMode dm )
 
   name = vtk.write(prefix.str() + "-appendedraw", Dune::VTK::appendedraw);
   if(rank == 0) acc(result, checkVTKFile(name));
+  acc(result, checkAppendedSizes(pieceFileName(gridView, prefix.str() + "-appendedraw"),
+                                 "Int32"));
 
   name = vtk.write(prefix.str() + "-appendedbase64",
                    Dune::VTK::appendedbase64);
   if(rank == 0) acc(result, checkVTKFile(name));
 
+  acc(result, checkAggregation(vtk, gridView, prefix.str()));
+
+  // double precision data and coordinates with 64 bit connectivity
+  std::vector<double> doubledata(is.size(dim),1.0/3.0);
+  vtk.addVertexData(doubledata,"doubleData",1,Dune::VTK::Precision::float64);
+  vtk.setCoordinatePrecision(Dune::VTK::Precision::float64);
+  vtk.setIndexPrecision(Dune::VTK::Precision::int64);
+
+  name = vtk.write(prefix.str() + "-float64-ascii");
+  if(rank == 0) acc(result, checkVTKFile(name));
+
+  name = vtk.write(prefix.str() + "-float64-appendedraw", Dune::VTK::appendedraw);
+  if(rank == 0) acc(result, checkVTKFile(name));
+  acc(result, checkAppendedSizes(pieceFileName(gridView, prefix.str() + "-float64-appendedraw"),
+                                 "Int64"));
+
   return result;
 }
 
@@ -0,0 +1,127 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_AGGREGATION_HH
+#define DUNE_GRID_IO_FILE_VTK_AGGREGATION_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <string>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/collectivecommunication.hh>
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+
+namespace Dune {
+
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+    //! return the aggregator of a rank for groups of groupSize consecutive ranks
+    inline int aggregatorRank(int rank, int groupSize)
+    {
+      return rank - rank % groupSize;
+    }
+
+    //! collect the pieces of groups of consecutive ranks on one rank per group
+    /**
+     * The ranks are split into groups of groupSize consecutive ranks.  The
+     * first rank of each group, the aggregator, calls f(piece) for each piece
+     * of its group in rank order, starting with its own.  All other ranks
+     * send their piece to the aggregator.  This method is collective.
+     *
+     * If f throws, the aggregator still receives the remaining pieces of its
+     * group, so that the sending ranks do not block, and rethrows the first
+     * exception afterwards.  Only the aggregator throws; the caller has to
+     * make the error known on the other ranks.
+     *
+     * \returns true on the aggregator
+     */
+    template<class Comm, class F>
+    inline bool aggregatePieces(const Comm& comm, int groupSize,
+                                const std::string& piece, F f)
+    {
+      // without message passing each rank is its own aggregator
+      if(comm.size() > 1)
+        DUNE_THROW(NotImplemented, "VTK::aggregatePieces: unsupported "
+                   "collective communication");
+      f(piece);
+      return true;
+    }
+
+#if HAVE_MPI
+    template<class F>
+    inline bool aggregatePieces(const CollectiveCommunication<MPI_Comm>& comm,
+                                int groupSize, const std::string& piece, F f)
+    {
+      // send large pieces in chunks, MPI counts are int
+      static const std::size_t chunkSize = std::size_t(1) << 30;
+      static const int tag = 519;
+
+      const int rank = comm.rank();
+      const int aggregator = aggregatorRank(rank, groupSize);
+      if(rank != aggregator)
+      {
+        unsigned long long size = piece.size();
+        MPI_Send(&size, 1, MPI_UNSIGNED_LONG_LONG, aggregator, tag, comm);
+        for(std::size_t begin = 0; begin < piece.size(); begin += chunkSize)
+        {
+          const std::size_t count = std::min(chunkSize, piece.size() - begin);
+          MPI_Send(const_cast<char*>(piece.data() + begin), count, MPI_CHAR,
+                   aggregator, tag, comm);
+        }
+        return false;
+      }
+
+      std::exception_ptr error;
+      try {
+        f(piece);
+      }
+      catch(...) {
+        error = std::current_exception();
+      }
+
+      // receive one piece after the other, so the aggregator only keeps one
+      std::string buffer;
+      const int end = std::min(aggregator + groupSize, comm.size());
+      for(int source = aggregator+1; source < end; ++source)
+      {
+        unsigned long long size;
+        MPI_Recv(&size, 1, MPI_UNSIGNED_LONG_LONG, source, tag, comm,
+                 MPI_STATUS_IGNORE);
+        buffer.resize(size);
+        for(std::size_t begin = 0; begin < buffer.size(); begin += chunkSize)
+        {
+          const std::size_t count = std::min(chunkSize, buffer.size() - begin);
+          MPI_Recv(&buffer[begin], count, MPI_CHAR, source, tag, comm,
+                   MPI_STATUS_IGNORE);
+        }
+        if(error)
+          continue;
+        try {
+          f(buffer);
+        }
+        catch(...) {
+          error = std::current_exception();
+        }
+      }
+      if(error)
+        std::rethrow_exception(error);
+      return true;
+    }
+#endif // #if HAVE_MPI
+
+  } // namespace VTK
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_AGGREGATION_HH
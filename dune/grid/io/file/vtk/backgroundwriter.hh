@@ -0,0 +1,157 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+
+#ifndef DUNE_GRID_IO_FILE_VTK_BACKGROUNDWRITER_HH
+#define DUNE_GRID_IO_FILE_VTK_BACKGROUNDWRITER_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <dune/common/exceptions.hh>
+
+namespace Dune {
+
+  //! \addtogroup VTK
+  //! \{
+
+  namespace VTK {
+
+    //! execute output jobs on a separate thread
+    /**
+     * Jobs are executed one after the other in the order they were submitted
+     * on a single thread owned by this object.  At most maxPending jobs wait
+     * for execution; submit() blocks while the queue is full, which limits
+     * the memory held by pending output.  An exception thrown by a job is
+     * rethrown by the next call to submit() or wait().  The destructor waits
+     * until all submitted jobs are done.
+     */
+    class BackgroundWriter {
+    public:
+      typedef std::function<void()> Job;
+
+      //! start the writer thread
+      explicit BackgroundWriter(std::size_t maxPending = 2)
+        : maxPending_(std::max<std::size_t>(maxPending, 1)), busy_(false),
+          stop_(false), thread_(&BackgroundWriter::run, this)
+      { }
+
+      //! finish all pending jobs and stop the writer thread
+      ~BackgroundWriter()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        notEmpty_.notify_one();
+        thread_.join();
+      }
+
+      //! queue a job, blocking while maxPending jobs are waiting
+      void submit(Job job)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        notFull_.wait(lock, [this] { return queue_.size() < maxPending_ || error_; });
+        rethrow();
+        queue_.push_back(std::move(job));
+        notEmpty_.notify_one();
+      }
+
+      //! block until all submitted jobs are done
+      void wait()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+        rethrow();
+      }
+
+      //! number of jobs submitted but not yet finished
+      std::size_t pending() const
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size() + (busy_ ? 1 : 0);
+      }
+
+      //! a job writing a string to a file
+      static Job writeFile(const std::string& fileName,
+                           std::shared_ptr<const std::string> contents)
+      {
+        return [fileName, contents] {
+                 std::ofstream file(fileName.c_str(), std::ios::binary);
+                 if(!file.is_open())
+                   DUNE_THROW(IOError, "Could not write to file " << fileName);
+                 file.write(contents->data(), contents->size());
+                 if(!file)
+                   DUNE_THROW(IOError, "Failed writing to file " << fileName);
+               };
+      }
+
+    private:
+      // called with mutex_ locked
+      void rethrow()
+      {
+        if(!error_)
+          return;
+        std::exception_ptr error = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(error);
+      }
+
+      void run()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while(true)
+        {
+          notEmpty_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+          if(queue_.empty())
+            return;
+
+          Job job = std::move(queue_.front());
+          queue_.pop_front();
+          busy_ = true;
+          notFull_.notify_one();
+
+          lock.unlock();
+          std::exception_ptr error;
+          try {
+            job();
+          }
+          catch(...) {
+            error = std::current_exception();
+          }
+          lock.lock();
+
+          // keep the first error until it is reported
+          if(error && !error_)
+            error_ = error;
+          busy_ = false;
+          notFull_.notify_one();
+          idle_.notify_all();
+        }
+      }
+
+      const std::size_t maxPending_;
+      mutable std::mutex mutex_;
+      std::condition_variable notEmpty_, notFull_, idle_;
+      std::deque<Job> queue_;
+      bool busy_;
+      bool stop_;
+      std::exception_ptr error_;
+      std::thread thread_;
+    };
+
+  } // namespace VTK
+
+  //! \} group VTK
+
+} // namespace Dune
+
+#endif // DUNE_GRID_IO_FILE_VTK_BACKGROUNDWRITER_HH
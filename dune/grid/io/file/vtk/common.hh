@@ -78,6 +78,35 @@ namespace Dune
       nonconforming
     };
 
+    //! Value type of a data array in the file
+    /**
+     * \code
+     * #include <dune/grid/io/file/vtk/common.hh>
+     * \endcode
+     */
+    enum class Precision {
+      //! 32 bit signed integers
+      int32,
+      //! 64 bit signed integers
+      int64,
+      //! single precision floating point values
+      float32,
+      //! double precision floating point values
+      float64
+    };
+
+    //! map a precision to the VTK name of its type
+    inline std::string toString(Precision p)
+    {
+      switch(p) {
+      case Precision::int32 :   return "Int32";
+      case Precision::int64 :   return "Int64";
+      case Precision::float32 : return "Float32";
+      case Precision::float64 : return "Float64";
+      }
+      DUNE_THROW(IOError, "VTK::toString: unsupported precision");
+    }
+
     //////////////////////////////////////////////////////////////////////
     //
     //  PrintType
@@ -300,8 +329,8 @@ namespace Dune
      * This struct provides general information about a data field to be
      * written to a VTK file.
      *
-     * It currently stores the data type and the number of components as well as
-     * the name of the field.
+     * It currently stores the data type, the number of components and the
+     * precision written to the file as well as the name of the field.
      */
     class FieldInfo
     {
@@ -319,11 +348,13 @@ namespace Dune
         tensor
       };
 
-      //! Create a FieldInfo instance with the given name, type and size.
-      FieldInfo(std::string name, Type type, std::size_t size)
+      //! Create a FieldInfo instance with the given name, type, size and precision.
+      FieldInfo(std::string name, Type type, std::size_t size,
+                Precision precision = Precision::float32)
         : _name(name)
         , _type(type)
         , _size(size)
+        , _precision(precision)
       {}
 
       //! The name of the data field
@@ -344,11 +375,18 @@ namespace Dune
         return _size;
       }
 
+      //! The precision of the values written to the file
+      Precision precision() const
+      {
+        return _precision;
+      }
+
     private:
 
       std::string _name;
       Type _type;
       std::size_t _size;
+      Precision _precision;
 
     };
 
@@ -4,7 +4,9 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_DATAARRAYWRITER_HH
 #define DUNE_GRID_IO_FILE_VTK_DATAARRAYWRITER_HH
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <ostream>
 #include <string>
 
@@ -61,6 +63,23 @@ namespace Dune
       virtual ~DataArrayWriter () {}
     };
 
+    //! size of an array in bytes, as stored in the header of binary data
+    /**
+     * The header of binary and appended data is a 32 bit unsigned integer
+     * (the default header_type of VTK files), so a single array may not
+     * exceed 4 GiB, even if the number of items or the offsets into the
+     * appended section do.
+     */
+    template<class T>
+    inline std::uint32_t dataArrayBytes(unsigned ncomps, std::size_t nitems)
+    {
+      const std::size_t bytes = std::size_t(ncomps)*nitems*sizeof(T);
+      if(bytes > std::numeric_limits<std::uint32_t>::max())
+        DUNE_THROW(IOError, "Dune::VTK::DataArrayWriter: array of " << bytes
+                   << " bytes does not fit into a 32 bit header");
+      return bytes;
+    }
+
     //! a streaming writer for data array tags, uses ASCII inline format
     template<class T>
     class AsciiDataArrayWriter : public DataArrayWriter<T>
@@ -77,8 +96,12 @@ namespace Dune
        */
       AsciiDataArrayWriter(std::ostream& theStream, std::string name,
                            int ncomps, const Indent& indent_)
-        : s(theStream), counter(0), numPerLine(12), indent(indent_)
+        : s(theStream), counter(0), numPerLine(12), indent(indent_),
+          oldPrecision(theStream.precision())
       {
+        // keep all digits of double precision values
+        if(!std::numeric_limits<T>::is_integer && sizeof(T) > sizeof(float))
+          s.precision(std::numeric_limits<T>::digits10 + 2);
         TypeName<T> tn;
         s << indent << "<DataArray type=\"" << tn() << "\" "
           << "Name=\"" << name << "\" ";
@@ -104,13 +127,15 @@ namespace Dune
         if (counter%numPerLine!=0) s << "\n";
         --indent;
         s << indent << "</DataArray>\n";
+        s.precision(oldPrecision);
       }
 
     private:
       std::ostream& s;
-      int counter;
-      int numPerLine;
+      std::size_t counter;
+      std::size_t numPerLine;
       Indent indent;
+      std::streamsize oldPrecision;
     };
 
     //! a streaming writer for data array tags, uses binary inline format
@@ -130,7 +155,7 @@ namespace Dune
        *                  for the actual data.
        */
       BinaryDataArrayWriter(std::ostream& theStream, std::string name,
-                            int ncomps, int nitems, const Indent& indent_)
+                            int ncomps, std::size_t nitems, const Indent& indent_)
         : s(theStream), b64(theStream), indent(indent_)
       {
         TypeName<T> tn;
@@ -142,7 +167,7 @@ namespace Dune
         // write indentation for the data chunk
         s << indent+1;
         // store size, needs to be exactly 32 bit
-        std::uint32_t size = ncomps*nitems*sizeof(T);
+        std::uint32_t size = dataArrayBytes<T>(ncomps, nitems);
         b64.write(size);
         b64.flush();
       }
@@ -188,7 +213,7 @@ namespace Dune
        *                  header line.
        */
       AppendedRawDataArrayWriter(std::ostream& s, std::string name,
-                                 int ncomps, unsigned nitems, unsigned& offset,
+                                 int ncomps, std::size_t nitems, std::size_t& offset,
                                  const Indent& indent)
       {
         TypeName<T> tn;
@@ -197,7 +222,7 @@ namespace Dune
         s << "NumberOfComponents=\"" << ncomps << "\" ";
         s << "format=\"appended\" offset=\""<< offset << "\" />\n";
         offset += 4; // header
-        offset += ncomps*nitems*sizeof(T);
+        offset += dataArrayBytes<T>(ncomps, nitems);
       }
 
       //! write one data element to output stream (noop)
@@ -226,8 +251,8 @@ namespace Dune
        *                  header line.
        */
       AppendedBase64DataArrayWriter(std::ostream& s, std::string name,
-                                    int ncomps, unsigned nitems,
-                                    unsigned& offset, const Indent& indent)
+                                    int ncomps, std::size_t nitems,
+                                    std::size_t& offset, const Indent& indent)
       {
         TypeName<T> tn;
         s << indent << "<DataArray type=\"" << tn() << "\" "
@@ -235,7 +260,7 @@ namespace Dune
         s << "NumberOfComponents=\"" << ncomps << "\" ";
         s << "format=\"appended\" offset=\""<< offset << "\" />\n";
         offset += 8; // header
-        unsigned bytes = ncomps*nitems*sizeof(T);
+        std::size_t bytes = dataArrayBytes<T>(ncomps, nitems);
         offset += bytes/3*4;
         if(bytes%3 != 0)
           offset += 4;
@@ -266,11 +291,11 @@ namespace Dune
        *                  point data.
        */
       NakedBase64DataArrayWriter(std::ostream& theStream, int ncomps,
-                                 int nitems)
+                                 std::size_t nitems)
         : b64(theStream)
       {
         // store size
-        std::uint32_t size = ncomps*nitems*sizeof(T);
+        std::uint32_t size = dataArrayBytes<T>(ncomps, nitems);
         b64.write(size);
         b64.flush();
       }
@@ -300,10 +325,10 @@ namespace Dune
        *                  point data.
        */
       NakedRawDataArrayWriter(std::ostream& theStream, int ncomps,
-                              int nitems)
+                              std::size_t nitems)
         : s(theStream)
       {
-        s.write((unsigned int)(ncomps*nitems*sizeof(T)));
+        s.write(dataArrayBytes<T>(ncomps, nitems));
       }
 
       //! write one data element to output stream
@@ -329,7 +354,7 @@ namespace Dune
 
       OutputType type;
       std::ostream& stream;
-      unsigned offset;
+      std::size_t offset;
       //! whether we are in the main or in the appended section writing phase
       Phase phase;
 
@@ -404,7 +429,7 @@ namespace Dune
        */
       template<typename T>
       DataArrayWriter<T>* make(const std::string& name, unsigned ncomps,
-                               unsigned nitems, const Indent& indent) {
+                               std::size_t nitems, const Indent& indent) {
         switch(phase) {
         case main :
           switch(type) {
@@ -210,6 +210,20 @@ namespace Dune {
                << " NumberOfComponents=\"" << ncomps << "\"/>\n";
       }
 
+      //! Add an array of the given precision to the output file
+      /**
+       * \param name      Name of the array.
+       * \param ncomps    Number of components in each vector of the array.
+       * \param precision Value type of the array.
+       */
+      void addArray(const std::string& name, unsigned ncomps,
+                    Precision precision) {
+        stream << indent << "<PDataArray"
+               << " type=\"" << toString(precision) << "\""
+               << " Name=\"" << name << "\""
+               << " NumberOfComponents=\"" << ncomps << "\"/>\n";
+      }
+
       //! Add a serial piece to the output file
       inline void addPiece(const std::string& filename) {
         stream << indent << "<Piece "
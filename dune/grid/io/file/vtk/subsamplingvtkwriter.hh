@@ -4,8 +4,12 @@
 #ifndef DUNE_SUBSAMPLINGVTKWRITER_HH
 #define DUNE_SUBSAMPLINGVTKWRITER_HH
 
+#include <cstdint>
+#include <map>
 #include <ostream>
+#include <vector>
 
+#include <dune/common/fvector.hh>
 #include <dune/common/indent.hh>
 #include <dune/geometry/type.hh>
 #include <dune/geometry/virtualrefinement.hh>
@@ -44,6 +48,7 @@ namespace Dune
     typedef typename Refinement::IndexVector IndexVector;
     typedef typename Refinement::ElementIterator SubElementIterator;
     typedef typename Refinement::VertexIterator SubVertexIterator;
+    typedef FieldVector<ctype, dim> LocalCoordinate;
 
     typedef typename Base::CellIterator CellIterator;
     typedef typename Base::FunctionIterator FunctionIterator;
@@ -89,32 +94,51 @@ namespace Dune
     }
 
 
-    template<typename SubIterator>
-    struct IteratorSelector
-    {};
-
-    SubElementIterator refinementBegin(const Refinement& refinement, int level, IteratorSelector<SubElementIterator>)
+    //! the refinement of one geometry type at the subsampling level
+    struct SubsamplingTable
     {
-      return refinement.eBegin(level);
-    }
-
-    SubVertexIterator refinementBegin(const Refinement& refinement, int level, IteratorSelector<SubVertexIterator>)
+      //! type of the sub-elements
+      GeometryType subType;
+      //! local coordinates of the sub-vertices
+      std::vector<LocalCoordinate> vertices;
+      //! local coordinates of the sub-element centers
+      std::vector<LocalCoordinate> elementCenters;
+      //! sub-vertex numbers of the sub-element corners in VTK order
+      std::vector<int> connectivity;
+      //! number of corners of each sub-element
+      int cornersPerElement;
+    };
+
+    //! return the refinement table of a geometry type, building it on first use
+    const SubsamplingTable& table(const GeometryType& type)
     {
-      return refinement.vBegin(level);
+      typename std::map<GeometryType, SubsamplingTable>::iterator it = tables.find(type);
+      if(it != tables.end())
+        return it->second;
+
+      SubsamplingTable& t = tables[type];
+      t.subType = subsampledGeometryType(type);
+      Refinement &refinement = buildRefinement<dim, ctype>(type, t.subType);
+      t.cornersPerElement = 0;
+      for(SubVertexIterator sit = refinement.vBegin(level),
+            send = refinement.vEnd(level); sit != send; ++sit)
+        t.vertices.push_back(sit.coords());
+      for(SubElementIterator sit = refinement.eBegin(level),
+            send = refinement.eEnd(level); sit != send; ++sit)
+      {
+        t.elementCenters.push_back(sit.coords());
+        IndexVector indices = sit.vertexIndices();
+        t.cornersPerElement = indices.size();
+        for(unsigned int ii = 0; ii < indices.size(); ++ii)
+          t.connectivity.push_back(indices[VTK::renumber(t.subType, ii)]);
+      }
+      return t;
     }
 
-    SubElementIterator refinementEnd(const Refinement& refinement, int level, IteratorSelector<SubElementIterator>)
-    {
-      return refinement.eEnd(level);
-    }
+    typedef std::vector<LocalCoordinate> SubsamplingTable::*Positions;
 
-    SubVertexIterator refinementEnd(const Refinement& refinement, int level, IteratorSelector<SubVertexIterator>)
-    {
-      return refinement.vEnd(level);
-    }
-
-    template<typename Data, typename Iterator, typename SubIterator>
-    void writeData(VTK::VTUWriter& writer, const Data& data, const Iterator begin, const Iterator end, int nentries, IteratorSelector<SubIterator> sis)
+    template<typename Data>
+    void writeData(VTK::VTUWriter& writer, const Data& data, std::int64_t nentries, Positions positions)
     {
       for (auto it = data.begin(),
              iend = data.end();
@@ -122,51 +146,54 @@ namespace Dune
            ++it)
       {
         const auto& f = *it;
-        VTK::FieldInfo fieldInfo = f.fieldInfo();
-        std::size_t writecomps = fieldInfo.size();
-        switch (fieldInfo.type())
+        std::size_t writecomps = Base::writeComponents(f.fieldInfo());
+        switch (f.fieldInfo().precision())
           {
-          case VTK::FieldInfo::Type::scalar:
+          case VTK::Precision::int32:
+            writeFunction<int>(writer, f, writecomps, nentries, positions);
             break;
-          case VTK::FieldInfo::Type::vector:
-            // vtk file format: a vector data always should have 3 comps (with
-            // 3rd comp = 0 in 2D case)
-            if (writecomps > 3)
-              DUNE_THROW(IOError,"Cannot write VTK vectors with more than 3 components (components was " << writecomps << ")");
-            writecomps = 3;
+          case VTK::Precision::int64:
+            writeFunction<std::int64_t>(writer, f, writecomps, nentries, positions);
+            break;
+          case VTK::Precision::float32:
+            writeFunction<float>(writer, f, writecomps, nentries, positions);
+            break;
+          case VTK::Precision::float64:
+            writeFunction<double>(writer, f, writecomps, nentries, positions);
             break;
-          case VTK::FieldInfo::Type::tensor:
-            DUNE_THROW(NotImplemented,"VTK output for tensors not implemented yet");
-          }
-        shared_ptr<VTK::DataArrayWriter<float> > p
-          (writer.makeArrayWriter<float>(f.name(), writecomps, nentries));
-        if(!p->writeIsNoop())
-          for (Iterator eit = begin; eit!=end; ++eit)
-          {
-            const Entity & e = *eit;
-            f.bind(e);
-            Refinement &refinement =
-              buildRefinement<dim, ctype>(eit->type(),
-                                          subsampledGeometryType(eit->type()));
-            for(SubIterator sit = refinementBegin(refinement,level,sis),
-                  send = refinementEnd(refinement,level,sis);
-                sit != send;
-                ++sit)
-              {
-                f.write(sit.coords(),*p);
-                // expand 2D-Vectors to 3D for VTK format
-                for(unsigned j = f.fieldInfo().size(); j < writecomps; j++)
-                  p->write(0.0);
-              }
-            f.unbind();
           }
       }
     }
 
+    //! evaluate a function at the given positions of the tables of all elements
+    template<typename T, typename Function>
+    void writeFunction(VTK::VTUWriter& writer, const Function& f, std::size_t writecomps,
+                       std::int64_t nentries, Positions positions)
+    {
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>(f.name(), writecomps, nentries));
+      if(!p->writeIsNoop())
+        for (CellIterator eit = cellBegin(); eit!=cellEnd(); ++eit)
+        {
+          const Entity & e = *eit;
+          f.bind(e);
+          f.write(table(e.type()).*positions, *p, writecomps);
+          f.unbind();
+        }
+    }
+
+    //! write the positions of vertices with coordinate type T
+    template<typename T>
+    void writeCoordinates(VTK::VTUWriter& writer);
+
+    //! write the connectivity and offsets arrays with index type T
+    template<typename T>
+    void writeConnectivity(VTK::VTUWriter& writer);
+
 
   protected:
     //! count the vertices, cells and corners
-    virtual void countEntities(int &nvertices, int &ncells, int &ncorners);
+    virtual void countEntities(std::int64_t &nvertices, std::int64_t &ncells, std::int64_t &ncorners);
 
     //! write cell data
     virtual void writeCellData(VTK::VTUWriter& writer);
@@ -189,28 +216,31 @@ namespace Dune
     // currently does not make sense for subsampled meshes, as the higher order
     // information is missing. See FS#676.
     template<class V>
-    void addVertexData (const V& v, const std::string &name, int ncomps=1);
+    void addVertexData (const V& v, const std::string &name, int ncomps=1,
+                        VTK::Precision precision = VTK::Precision::float32);
     template<class V>
-    void addCellData (const V& v, const std::string &name, int ncomps=1);
+    void addCellData (const V& v, const std::string &name, int ncomps=1,
+                      VTK::Precision precision = VTK::Precision::float32);
 
     int level;
     bool coerceToSimplex;
+    std::map<GeometryType, SubsamplingTable> tables;
   };
 
   //! count the vertices, cells and corners
   template <class GridView>
-  void SubsamplingVTKWriter<GridView>::countEntities(int &nvertices, int &ncells, int &ncorners)
+  void SubsamplingVTKWriter<GridView>::countEntities(std::int64_t &nvertices, std::int64_t &ncells, std::int64_t &ncorners)
   {
     nvertices = 0;
     ncells = 0;
     ncorners = 0;
     for (CellIterator it=this->cellBegin(); it!=cellEnd(); ++it)
     {
-      Refinement &refinement = buildRefinement<dim, ctype>(it->type(), subsampledGeometryType(it->type()));
+      const SubsamplingTable& t = table(it->type());
 
-      ncells += refinement.nElements(level);
-      nvertices += refinement.nVertices(level);
-      ncorners += refinement.nElements(level) * refinement.eBegin(level).vertexIndices().size();
+      ncells += t.elementCenters.size();
+      nvertices += t.vertices.size();
+      ncorners += t.connectivity.size();
     }
   }
 
@@ -229,7 +259,7 @@ namespace Dune
     std::tie(defaultScalarField, defaultVectorField) = this->getDataNames(celldata);
 
     writer.beginCellData(defaultScalarField, defaultVectorField);
-    writeData(writer,celldata,cellBegin(),cellEnd(),ncells,IteratorSelector<SubElementIterator>());
+    writeData(writer,celldata,ncells,&SubsamplingTable::elementCenters);
     writer.endCellData();
   }
 
@@ -247,7 +277,7 @@ namespace Dune
     std::tie(defaultScalarField, defaultVectorField) = this->getDataNames(vertexdata);
 
     writer.beginPointData(defaultScalarField, defaultVectorField);
-    writeData(writer,vertexdata,cellBegin(),cellEnd(),nvertices,IteratorSelector<SubVertexIterator>());
+    writeData(writer,vertexdata,nvertices,&SubsamplingTable::vertices);
     writer.endPointData();
   }
 
@@ -256,30 +286,33 @@ namespace Dune
   void SubsamplingVTKWriter<GridView>::writeGridPoints(VTK::VTUWriter& writer)
   {
     writer.beginPoints();
+    if (this->coordinatePrecision() == VTK::Precision::float64)
+      writeCoordinates<double>(writer);
+    else
+      writeCoordinates<float>(writer);
+    writer.endPoints();
+  }
 
-    shared_ptr<VTK::DataArrayWriter<float> > p
-      (writer.makeArrayWriter<float>("Coordinates", 3, nvertices));
+  template <class GridView>
+  template <typename T>
+  void SubsamplingVTKWriter<GridView>::writeCoordinates(VTK::VTUWriter& writer)
+  {
+    shared_ptr<VTK::DataArrayWriter<T> > p
+      (writer.makeArrayWriter<T>("Coordinates", 3, nvertices));
     if(!p->writeIsNoop())
       for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
       {
-        Refinement &refinement =
-          buildRefinement<dim, ctype>(i->type(),
-                                      subsampledGeometryType(i->type()));
-        for(SubVertexIterator sit = refinement.vBegin(level),
-            send = refinement.vEnd(level);
-            sit != send; ++sit)
+        const typename Entity::Geometry geometry = i->geometry();
+        const std::vector<LocalCoordinate>& vertices = table(i->type()).vertices;
+        for(std::size_t k = 0; k < vertices.size(); ++k)
         {
-          FieldVector<ctype, dimw> coords = i->geometry().global(sit.coords());
+          FieldVector<ctype, dimw> coords = geometry.global(vertices[k]);
           for (int j=0; j<std::min(int(dimw),3); j++)
             p->write(coords[j]);
           for (int j=std::min(int(dimw),3); j<3; j++)
-            p->write(0.0);
+            p->write(T(0));
         }
       }
-    // free the VTK::DataArrayWriter before touching the stream
-    p.reset();
-
-    writer.endPoints();
   }
 
   //! write the connectivity array
@@ -287,74 +320,69 @@ namespace Dune
   void SubsamplingVTKWriter<GridView>::writeGridCells(VTK::VTUWriter& writer)
   {
     writer.beginCells();
+    if (this->indexPrecision() == VTK::Precision::int64)
+      writeConnectivity<std::int64_t>(writer);
+    else
+      writeConnectivity<int>(writer);
+
+    // types
+    if (dim>1)
+    {
+      shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
+        (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
+      if(!p3->writeIsNoop())
+        for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+        {
+          const SubsamplingTable& t = table(it->type());
+          int vtktype = VTK::geometryType(t.subType);
+          for(std::size_t i = 0; i < t.elementCenters.size(); ++i)
+            p3->write(vtktype);
+        }
+    }
+
+    writer.endCells();
+  }
 
+  template <class GridView>
+  template <typename T>
+  void SubsamplingVTKWriter<GridView>::writeConnectivity(VTK::VTUWriter& writer)
+  {
     // connectivity
     {
-      shared_ptr<VTK::DataArrayWriter<int> > p1
-        (writer.makeArrayWriter<int>("connectivity", 1, ncorners));
+      shared_ptr<VTK::DataArrayWriter<T> > p1
+        (writer.makeArrayWriter<T>("connectivity", 1, ncorners));
       // The offset within the index numbering
       if(!p1->writeIsNoop()) {
-        int offset = 0;
+        T offset = 0;
         for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
         {
-          GeometryType coercedToType = subsampledGeometryType(i->type());
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(), coercedToType);
-          for(SubElementIterator sit = refinement.eBegin(level),
-              send = refinement.eEnd(level);
-              sit != send; ++sit)
-          {
-            IndexVector indices = sit.vertexIndices();
-            for(unsigned int ii = 0; ii < indices.size(); ++ii)
-              p1->write(offset+indices[VTK::renumber(coercedToType, ii)]);
-          }
-          offset += refinement.nVertices(level);
+          const SubsamplingTable& t = table(i->type());
+          for(std::size_t k = 0; k < t.connectivity.size(); ++k)
+            p1->write(offset+t.connectivity[k]);
+          offset += t.vertices.size();
         }
       }
     }
 
     // offsets
     {
-      shared_ptr<VTK::DataArrayWriter<int> > p2
-        (writer.makeArrayWriter<int>("offsets", 1, ncells));
+      shared_ptr<VTK::DataArrayWriter<T> > p2
+        (writer.makeArrayWriter<T>("offsets", 1, ncells));
       if(!p2->writeIsNoop()) {
         // The offset into the connectivity array
-        int offset = 0;
+        T offset = 0;
         for (CellIterator i=cellBegin(); i!=cellEnd(); ++i)
         {
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(i->type(),
-                                        subsampledGeometryType(i->type()));
-          unsigned int verticesPerCell =
-            refinement.eBegin(level).vertexIndices().size();
-          for(int element = 0; element < refinement.nElements(level);
+          const SubsamplingTable& t = table(i->type());
+          for(std::size_t element = 0; element < t.elementCenters.size();
               ++element)
           {
-            offset += verticesPerCell;
+            offset += t.cornersPerElement;
             p2->write(offset);
           }
         }
       }
     }
-
-    // types
-    if (dim>1)
-    {
-      shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
-        (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
-      if(!p3->writeIsNoop())
-        for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
-        {
-          GeometryType coerceTo = subsampledGeometryType(it->type());
-          Refinement &refinement =
-            buildRefinement<dim, ctype>(it->type(), coerceTo);
-          int vtktype = VTK::geometryType(coerceTo);
-          for(int i = 0; i < refinement.nElements(level); ++i)
-            p3->write(vtktype);
-        }
-    }
-
-    writer.endCells();
   }
 }
 
@@ -9,12 +9,17 @@
 #include <sstream>
 #include <fstream>
 #include <iomanip>
+#include <memory>
+#include <exception>
 
 #include <dune/grid/io/file/vtk/common.hh>
+#include <dune/common/exceptions.hh>
 #include <dune/common/path.hh>
 #include <dune/common/shared_ptr.hh>
 
+#include <dune/grid/io/file/vtk/backgroundwriter.hh>
 #include <dune/grid/io/file/vtk/vtkwriter.hh>
+#include <dune/grid/io/file/vtk/vtuwriter.hh>
 
 namespace Dune {
 
@@ -36,6 +41,7 @@ namespace Dune {
     std::string name_,path_,extendpath_;
     int rank_;
     int size_;
+    std::unique_ptr<VTK::BackgroundWriter> backgroundWriter_;
   public:
     /** \brief Set up the VTKSequenceWriterBase class
      *
@@ -56,12 +62,79 @@ namespace Dune {
         size_(size)
     {}
 
-    ~VTKSequenceWriterBase() {}
+    /** \brief Destructor, waits until all time steps are written
+     *
+     * A destructor must not throw, so an error that occurred while writing
+     * in the background is only reported on std::cerr.  Call flush() before
+     * to handle such errors.
+     */
+    ~VTKSequenceWriterBase()
+    {
+      try {
+        flush();
+      }
+      catch(const Dune::Exception& e) {
+        std::cerr << "VTKSequenceWriterBase: writing in the background failed: "
+                  << e << std::endl;
+      }
+      catch(const std::exception& e) {
+        std::cerr << "VTKSequenceWriterBase: writing in the background failed: "
+                  << e.what() << std::endl;
+      }
+    }
+
+    /** \brief Write the time steps on a background thread
+     *
+     * In this mode, write() records the grid and all data of the time step
+     * into memory and returns.  Encoding and writing the files is done by a
+     * separate thread.  If maxPending time steps are still waiting for that
+     * thread, write() blocks until one of them is done.  A value of 0
+     * switches back to writing synchronously.
+     *
+     * \note Output aggregation (see VTKWriter::setAggregationSize()) is not
+     *       supported in this mode.
+     */
+    void setAsynchronous (std::size_t maxPending = 2)
+    {
+      flush();
+      backgroundWriter_.reset();
+      if(maxPending > 0)
+        backgroundWriter_.reset(new VTK::BackgroundWriter(maxPending));
+    }
+
+    //! return whether time steps are written on a background thread
+    bool asynchronous () const
+    {
+      return bool(backgroundWriter_);
+    }
+
+    /** \brief Wait until all time steps are written
+     *
+     * Rethrows an exception that occurred while writing in the background.
+     */
+    void flush ()
+    {
+      if(backgroundWriter_)
+        backgroundWriter_->wait();
+    }
+
+    /** \brief Reuse points and cells between time steps
+     *
+     * \param generation Counter identifying the current state of the grid;
+     *                   change it whenever the grid changes.
+     *
+     * \sa VTKWriter::setGridGeneration()
+     */
+    void setGridGeneration (unsigned long generation)
+    {
+      vtkWriter_->setGridGeneration(generation);
+    }
 
     /** \brief Adds a field of cell data to the VTK file */
-    void addCellData (const shared_ptr<const typename VTKWriter<GridView>::VTKFunction> &p)
+    void addCellData (const shared_ptr<const typename VTKWriter<GridView>::VTKFunction> &p,
+                      VTK::Precision precision = VTK::Precision::float32)
     {
-      vtkWriter_->addCellData(p);
+      vtkWriter_->addCellData(p, precision);
     }
 
     /** \brief Adds a field of cell data to the VTK file */
@@ -74,11 +147,13 @@ namespace Dune {
      * \param v The container with the values of the grid function for each cell
      * \param name A name to identify the grid function
      * \param ncomps Number of components (default is 1)
+     * \param precision Precision of the values in the file
      */
     template<class V >
-    void addCellData (const V &v, const std::string &name, int ncomps=1)
+    void addCellData (const V &v, const std::string &name, int ncomps=1,
+                      VTK::Precision precision = VTK::Precision::float32)
     {
-      vtkWriter_->addCellData(v, name, ncomps);
+      vtkWriter_->addCellData(v, name, ncomps, precision);
     }
 
     /** \brief Adds a field of vertex data to the VTK file */
@@ -88,20 +163,23 @@ namespace Dune {
     }
 
     /** \brief Adds a field of vertex data to the VTK file */
-    void addVertexData (const typename VTKWriter<GridView>::VTKFunctionPtr &p)
+    void addVertexData (const typename VTKWriter<GridView>::VTKFunctionPtr &p,
+                        VTK::Precision precision = VTK::Precision::float32)
     {
-      vtkWriter_->addVertexData(p);
+      vtkWriter_->addVertexData(p, precision);
     }
 
     /** \brief Adds a field of vertex data to the VTK file
      * \param v The container with the values of the grid function for each vertex
      * \param name A name to identify the grid function
      * \param ncomps Number of components (default is 1)
+     * \param precision Precision of the values in the file
      */
     template<class V >
-    void addVertexData (const V &v, const std::string &name, int ncomps=1)
+    void addVertexData (const V &v, const std::string &name, int ncomps=1,
+                        VTK::Precision precision = VTK::Precision::float32)
     {
-      vtkWriter_->addVertexData(v, name, ncomps);
+      vtkWriter_->addVertexData(v, name, ncomps, precision);
     }
 
 
@@ -117,45 +195,102 @@ namespace Dune {
       timesteps_.push_back(time);
 
       /* write VTK file */
-      if(size_==1)
+      if(backgroundWriter_)
+        submit(count, ot);
+      else if(size_==1)
         vtkWriter_->write(concatPaths(path_,seqName(count)),ot);
       else
         vtkWriter_->pwrite(seqName(count), path_,extendpath_,ot);
 
       /* write pvd file ... only on rank 0 */
       if (rank_==0) {
-        std::ofstream pvdFile;
-        pvdFile.exceptions(std::ios_base::badbit | std::ios_base::failbit |
-                           std::ios_base::eofbit);
         std::string pvdname = name_ + ".pvd";
-        pvdFile.open(pvdname.c_str());
-        pvdFile << "<?xml version=\"1.0\"?> \n"
-                << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\"> \n"
-                << "<Collection> \n";
-        for (unsigned int i=0; i<=count; i++)
-        {
-          // filename
-          std::string piecepath;
-          std::string fullname;
-          if(size_==1) {
-            piecepath = path_;
-            fullname = vtkWriter_->getSerialPieceName(seqName(i), piecepath);
-          }
-          else {
-            piecepath = concatPaths(path_, extendpath_);
-            fullname = vtkWriter_->getParallelHeaderName(seqName(i), piecepath, size_);
-          }
-          pvdFile << "<DataSet timestep=\"" << timesteps_[i]
-                  << "\" group=\"\" part=\"0\" name=\"\" file=\""
-                  << fullname << "\"/> \n";
+        if(backgroundWriter_) {
+          std::ostringstream pvd;
+          writePvd(pvd, count);
+          backgroundWriter_->submit(VTK::BackgroundWriter::writeFile(
+                                      pvdname, std::make_shared<std::string>(pvd.str())));
+        }
+        else {
+          std::ofstream pvdFile;
+          pvdFile.exceptions(std::ios_base::badbit | std::ios_base::failbit |
+                             std::ios_base::eofbit);
+          pvdFile.open(pvdname.c_str());
+          writePvd(pvdFile, count);
+          pvdFile.close();
         }
-        pvdFile << "</Collection> \n"
-                << "</VTKFile> \n" << std::flush;
-        pvdFile.close();
       }
     }
   private:
 
+    // write the pvd file listing the time steps up to count
+    void writePvd(std::ostream& pvdFile, unsigned int count) const
+    {
+      pvdFile << "<?xml version=\"1.0\"?> \n"
+              << "<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"LittleEndian\"> \n"
+              << "<Collection> \n";
+      for (unsigned int i=0; i<=count; i++)
+      {
+        // filename
+        std::string piecepath;
+        std::string fullname;
+        if(size_==1) {
+          piecepath = path_;
+          fullname = vtkWriter_->getSerialPieceName(seqName(i), piecepath);
+        }
+        else {
+          piecepath = concatPaths(path_, extendpath_);
+          fullname = vtkWriter_->getParallelHeaderName(seqName(i), piecepath, size_);
+        }
+        pvdFile << "<DataSet timestep=\"" << timesteps_[i]
+                << "\" group=\"\" part=\"0\" name=\"\" file=\""
+                << fullname << "\"/> \n";
+      }
+      pvdFile << "</Collection> \n"
+              << "</VTKFile> \n" << std::flush;
+    }
+
+    // record the data of a time step and queue it for the background thread
+    void submit(unsigned int count, VTK::OutputType ot)
+    {
+      if(vtkWriter_->aggregationSize() > 1)
+        DUNE_THROW(NotImplemented, "VTKSequenceWriterBase: output aggregation "
+                   "is not supported in asynchronous mode");
+
+      VTK::FileType fileType =
+        (GridView::dimension == 1) ? VTK::polyData : VTK::unstructuredGrid;
+      std::shared_ptr<VTK::VTUSnapshot> snapshot(new VTK::VTUSnapshot(fileType));
+      vtkWriter_->recordSnapshot(*snapshot);
+
+      std::string piecename;
+      if(size_==1)
+        piecename = vtkWriter_->getSerialPieceName(seqName(count), path_);
+      else
+        piecename = vtkWriter_->getParallelPieceName(seqName(count),
+                                                     concatPaths(path_, extendpath_),
+                                                     rank_, size_);
+      backgroundWriter_->submit([piecename, snapshot, ot] {
+                                  std::ofstream file(piecename.c_str(), std::ios::binary);
+                                  if(!file.is_open())
+                                    DUNE_THROW(IOError, "Could not write to piece file " << piecename);
+                                  snapshot->write(file, ot);
+                                  if(!file)
+                                    DUNE_THROW(IOError, "Failed writing to piece file " << piecename);
+                                });
+
+      // the parallel header only depends on the names of the fields
+      if(size_ > 1 && rank_ == 0)
+      {
+        std::string piecepath = concatPaths(path_, extendpath_);
+        std::ostringstream header;
+        vtkWriter_->writeParallelHeader(header, seqName(count),
+                                        relativePath(path_, piecepath), size_);
+        backgroundWriter_->submit(VTK::BackgroundWriter::writeFile(
+                                    vtkWriter_->getParallelHeaderName(seqName(count), path_, size_),
+                                    std::make_shared<std::string>(header.str())));
+      }
+    }
+
     // create sequence name
     std::string seqName(unsigned int count) const
     {
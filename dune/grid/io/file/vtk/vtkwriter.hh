@@ -4,7 +4,9 @@
 #ifndef DUNE_VTKWRITER_HH
 #define DUNE_VTKWRITER_HH
 
+#include <cstdint>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <fstream>
@@ -13,6 +15,8 @@
 
 #include <vector>
 #include <list>
+#include <memory>
+#include <exception>
 
 #include <dune/common/deprecated.hh>
 #include <dune/common/typetraits.hh>
@@ -25,6 +29,7 @@
 #include <dune/geometry/referenceelements.hh>
 #include <dune/grid/common/mcmgmapper.hh>
 #include <dune/grid/common/gridenums.hh>
+#include <dune/grid/io/file/vtk/aggregation.hh>
 #include <dune/grid/io/file/vtk/common.hh>
 #include <dune/grid/io/file/vtk/dataarraywriter.hh>
 #include <dune/grid/io/file/vtk/function.hh>
@@ -62,8 +67,8 @@ namespace Dune
   template< class GridView >
   class VTKWriter {
 
-    // VTKSequenceWriterBase needs getSerialPieceName
-    // and getParallelHeaderName
+    // VTKSequenceWriterBase needs getSerialPieceName,
+    // getParallelHeaderName and the snapshot methods
     friend class VTKSequenceWriterBase<GridView>;
 
     // extract types
@@ -124,8 +129,6 @@ namespace Dune
 
     public:
 
-      typedef VTK::DataArrayWriter<float> Writer;
-
       //! Base class for polymorphic container of underlying data set
       struct FunctionWrapperBase
       {
@@ -136,11 +139,11 @@ namespace Dune
         //! Unbind data set from current grid entity - mostly here for performance and symmetry reasons
         virtual void unbind() const = 0;
 
-        //! Evaluate data set at local position pos inside the current entity and write result to w.
+        //! Evaluate data set at local position pos inside the current entity and store the result in values.
         /**
-         * The function must write count scalar values as determined by the VTK::FieldInfo.
+         * The function must store count scalar values as determined by the VTK::FieldInfo.
          */
-        virtual void write(const Coordinate& pos, Writer& w, std::size_t count) const = 0;
+        virtual void evaluate(const Coordinate& pos, double* values, std::size_t count) const = 0;
 
         virtual ~FunctionWrapperBase()
         {}
@@ -168,27 +171,27 @@ namespace Dune
           _f.unbind();
         }
 
-        virtual void write(const Coordinate& pos, Writer& w, std::size_t count) const
+        virtual void evaluate(const Coordinate& pos, double* values, std::size_t count) const
         {
           auto r = _f(pos);
           // we need to do different things here depending on whether r supports indexing into it or not.
-          do_write(w,r,count,is_indexable<decltype(r)>());
+          do_evaluate(values,r,count,is_indexable<decltype(r)>());
         }
 
       private:
 
         template<typename R>
-        void do_write(Writer& w, const R& r, std::size_t count, std::true_type) const
+        void do_evaluate(double* values, const R& r, std::size_t count, std::true_type) const
         {
           for (std::size_t i = 0; i < count; ++i)
-            w.write(r[i]);
+            values[i] = r[i];
         }
 
         template<typename R>
-        void do_write(Writer& w, const R& r, std::size_t count, std::false_type) const
+        void do_evaluate(double* values, const R& r, std::size_t count, std::false_type) const
         {
           assert(count == 1);
-          w.write(r);
+          values[0] = r;
         }
 
         F _f;
@@ -213,10 +216,10 @@ namespace Dune
           _entity = nullptr;
         }
 
-        virtual void write(const Coordinate& pos, Writer& w, std::size_t count) const
+        virtual void evaluate(const Coordinate& pos, double* values, std::size_t count) const
         {
           for (std::size_t i = 0; i < count; ++i)
-            w.write(_f->evaluate(i,*_entity,pos));
+            values[i] = _f->evaluate(i,*_entity,pos);
         }
 
       private:
@@ -231,16 +234,20 @@ namespace Dune
       VTKLocalFunction(F&& f, VTK::FieldInfo fieldInfo)
         : _f(Dune::Std::make_unique<FunctionWrapper<F> >(std::forward<F>(f)))
         , _fieldInfo(fieldInfo)
+        , _values(fieldInfo.size())
       {}
 
       //! Construct a VTKLocalFunction for a legacy VTKFunction
-      explicit VTKLocalFunction (const VTKFunctionPtr& vtkFunctionPtr)
+      explicit VTKLocalFunction (const VTKFunctionPtr& vtkFunctionPtr,
+                                 VTK::Precision precision = VTK::Precision::float32)
         : _f(Dune::Std::make_unique<VTKFunctionWrapper>(vtkFunctionPtr))
         , _fieldInfo(
           vtkFunctionPtr->name(),
           vtkFunctionPtr->ncomps() > 1 ? VTK::FieldInfo::Type::vector : VTK::FieldInfo::Type::scalar,
-          vtkFunctionPtr->ncomps()
+          vtkFunctionPtr->ncomps(),
+          precision
           )
+        , _values(vtkFunctionPtr->ncomps())
       {}
 
       //! Returns the name of the data set
@@ -268,13 +275,46 @@ namespace Dune
       }
 
       //! Write the value of the data set at local coordinate pos to the writer w.
-      void write(const Coordinate& pos, Writer& w) const
+      /**
+       * The components are evaluated in double precision and then converted
+       * to the value type of the writer in a single loop.
+       */
+      template<typename T>
+      void write(const Coordinate& pos, VTK::DataArrayWriter<T>& w) const
+      {
+        const std::size_t count = fieldInfo().size();
+        _f->evaluate(pos,_values.data(),count);
+        for (std::size_t i = 0; i < count; ++i)
+          w.write(static_cast<T>(_values[i]));
+      }
+
+      //! Write the values of the data set at several local coordinates to the writer w.
+      /**
+       * All positions are evaluated before the values are converted and
+       * written.  Each value is padded with zeros up to writecomps
+       * components.
+       */
+      template<typename T>
+      void write(const std::vector<Coordinate>& positions, VTK::DataArrayWriter<T>& w, std::size_t writecomps) const
       {
-        _f->write(pos,w,fieldInfo().size());
+        const std::size_t count = fieldInfo().size();
+        if (_values.size() < positions.size()*count)
+          _values.resize(positions.size()*count);
+        for (std::size_t k = 0; k < positions.size(); ++k)
+          _f->evaluate(positions[k],_values.data()+k*count,count);
+        for (std::size_t k = 0; k < positions.size(); ++k)
+        {
+          for (std::size_t i = 0; i < count; ++i)
+            w.write(static_cast<T>(_values[k*count+i]));
+          for (std::size_t i = count; i < writecomps; ++i)
+            w.write(T(0));
+        }
       }
 
       std::shared_ptr<FunctionWrapperBase> _f;
       VTK::FieldInfo _fieldInfo;
+      // buffer for the values at the evaluated positions
+      mutable std::vector<double> _values;
 
     };
 
@@ -337,7 +377,7 @@ namespace Dune
       std::vector<bool> visited;
       // in conforming mode, for each vertex id (as obtained by vertexmapper)
       // hold its number in the iteration order (VertexIterator)
-      int offset;
+      std::int64_t offset;
 
       // hide operator ->
       void operator->();
@@ -452,10 +492,10 @@ namespace Dune
       // in conforming mode, for each vertex id (as obtained by vertexmapper)
       // hold its number in the iteration order of VertexIterator (*not*
       // CornerIterator)
-      const std::vector<int> & number;
+      const std::vector<std::int64_t> & number;
       // holds the number of corners of all the elements we have seen so far,
       // excluding the current element
-      int offset;
+      std::int64_t offset;
 
       // hide operator ->
       void operator->();
@@ -464,7 +504,7 @@ namespace Dune
                      const GridCellIterator & end,
                      const VTK::DataMode & dm,
                      const VertexMapper & vm,
-                     const std::vector<int> & num) :
+                     const std::vector<std::int64_t> & num) :
         git(x), gend(end), datamode(dm), cornerIndexVTK(0),
         vertexmapper(vm),
         number(num), offset(0) {}
@@ -499,7 +539,7 @@ namespace Dune
        * This method returns the number of this corners associated vertex, in
        * the numbering given by the iteration order of VertexIterator.
        */
-      int id () const
+      std::int64_t id () const
       {
         switch (datamode)
         {
@@ -540,16 +580,104 @@ namespace Dune
     explicit VTKWriter ( const GridView &gridView,
                          VTK::DataMode dm = VTK::conforming )
       : gridView_( gridView ),
-        datamode( dm )
+        datamode( dm ),
+        aggregationSize_( 1 ),
+        coordinatePrecision_( VTK::Precision::float32 ),
+        indexPrecision_( VTK::Precision::int32 ),
+        cacheGrid_( false ),
+        gridGeneration_( 0 )
     { }
 
+    /**
+     * @brief Combine the pieces of groups of ranks into one file per group
+     *
+     * In parallel output, groups of ranksPerFile consecutive ranks send their
+     * pieces to the first rank of the group, which writes them into a single
+     * multi-piece .vtu/.vtp file.  The .pvtu/.pvtp file then references only
+     * these aggregated files.  A value of 1 (the default) writes one file per
+     * rank.
+     *
+     * @note Appended data cannot be combined from several pieces, so with
+     *       aggregation the appended output types are written as inline
+     *       base64 data.
+     */
+    void setAggregationSize ( int ranksPerFile )
+    {
+      if( ranksPerFile < 1 )
+        DUNE_THROW(IOError, "VTKWriter: Invalid aggregation size " << ranksPerFile);
+      aggregationSize_ = ranksPerFile;
+    }
+
+    //! return the number of ranks writing into one file in parallel output
+    int aggregationSize () const { return aggregationSize_; }
+
+    /**
+     * @brief Set the precision of the point coordinates in the file
+     *
+     * @param precision Either VTK::Precision::float32 (the default) or
+     *                  VTK::Precision::float64.
+     */
+    void setCoordinatePrecision ( VTK::Precision precision )
+    {
+      if( precision != VTK::Precision::float32 && precision != VTK::Precision::float64 )
+        DUNE_THROW(IOError, "VTKWriter: Coordinates must be written as floating point values");
+      coordinatePrecision_ = precision;
+    }
+
+    //! return the precision of the point coordinates in the file
+    VTK::Precision coordinatePrecision () const { return coordinatePrecision_; }
+
+    /**
+     * @brief Set the precision of the connectivity and offsets arrays
+     *
+     * @param precision Either VTK::Precision::int32 (the default) or
+     *                  VTK::Precision::int64, which is required once a
+     *                  piece has more than 2^31 corners.
+     */
+    void setIndexPrecision ( VTK::Precision precision )
+    {
+      if( precision != VTK::Precision::int32 && precision != VTK::Precision::int64 )
+        DUNE_THROW(IOError, "VTKWriter: Connectivity must be written as integer values");
+      indexPrecision_ = precision;
+    }
+
+    //! return the precision of the connectivity and offsets arrays
+    VTK::Precision indexPrecision () const { return indexPrecision_; }
+
+    /**
+     * @brief Reuse the points and cells while the grid does not change
+     *
+     * After the first call to this method, the point coordinates and the
+     * connectivity are recorded when writing and reused by later writes, so
+     * that only the data fields are evaluated again.  The caller increments
+     * the generation whenever the grid changes, e.g. after each adapt() or
+     * load balancing step; a new value makes the next write record them
+     * again.
+     *
+     * @param generation Counter identifying the current state of the grid.
+     */
+    void setGridGeneration ( unsigned long generation )
+    {
+      cacheGrid_ = true;
+      gridGeneration_ = generation;
+    }
+
+    //! stop reusing points and cells and free the recorded ones
+    void clearGridCache ()
+    {
+      cacheGrid_ = false;
+      gridCache_.reset();
+    }
+
     /**
      * @brief Add a grid function that lives on the cells of the grid to the visualization.
      * @param p Dune::shared_ptr to the function to visualize
+     * @param precision Precision of the values in the file.
      */
-    void addCellData (const VTKFunctionPtr & p)
+    void addCellData (const VTKFunctionPtr & p,
+                      VTK::Precision precision = VTK::Precision::float32)
     {
-      celldata.push_back(VTKLocalFunction(p));
+      celldata.push_back(VTKLocalFunction(p,precision));
     }
 
     template<typename F>
@@ -582,9 +710,11 @@ namespace Dune
      * @param v The container with the values of the grid function for each cell.
      * @param name A name to identify the grid function.
      * @param ncomps Number of components (default is 1).
+     * @param precision Precision of the values in the file.
      */
     template<class V>
-    void addCellData (const V& v, const std::string &name, int ncomps = 1)
+    void addCellData (const V& v, const std::string &name, int ncomps = 1,
+                      VTK::Precision precision = VTK::Precision::float32)
     {
       typedef P0VTKFunction<GridView, V> Function;
       for (int c=0; c<ncomps; ++c) {
@@ -593,7 +723,7 @@ namespace Dune
         if (ncomps>1)
           compName << "[" << c << "]";
         VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c);
-        addCellData(VTKFunctionPtr(p));
+        addCellData(VTKFunctionPtr(p), precision);
       }
     }
 
@@ -610,10 +740,12 @@ namespace Dune
     /**
      * @brief Add a grid function that lives on the vertices of the grid to the visualization.
      * @param p Dune::shared_ptr to the function to visualize
+     * @param precision Precision of the values in the file.
      */
-    void addVertexData (const VTKFunctionPtr & p)
+    void addVertexData (const VTKFunctionPtr & p,
+                        VTK::Precision precision = VTK::Precision::float32)
     {
-      vertexdata.push_back(VTKLocalFunction(p));
+      vertexdata.push_back(VTKLocalFunction(p,precision));
     }
 
     template<typename F>
@@ -637,9 +769,11 @@ namespace Dune
      * @param v The container with the values of the grid function for each vertex.
      * @param name A name to identify the grid function.
      * @param ncomps Number of components (default is 1).
+     * @param precision Precision of the values in the file.
      */
     template<class V>
-    void addVertexData (const V& v, const std::string &name, int ncomps=1)
+    void addVertexData (const V& v, const std::string &name, int ncomps=1,
+                        VTK::Precision precision = VTK::Precision::float32)
     {
       typedef P1VTKFunction<GridView, V> Function;
       for (int c=0; c<ncomps; ++c) {
@@ -648,7 +782,7 @@ namespace Dune
         if (ncomps>1)
           compName << "[" << c << "]";
         VTKFunction* p = new Function(gridView_, v, compName.str(), ncomps, c);
-        addVertexData(VTKFunctionPtr(p));
+        addVertexData(VTKFunctionPtr(p), precision);
       }
     }
 
@@ -747,6 +881,35 @@ namespace Dune
       return s.str();
     }
 
+    //! return name of a file holding the pieces of a group of ranks
+    /**
+     * \param name     Base name of the VTK output.  This should be without
+     *                 any directory parts and without a filename extension.
+     * \param path     Directory part of the resulting piece name, see
+     *                 getParallelPieceName().
+     * \param group    Number of the group of ranks (rank / aggregation size).
+     * \param commSize Number of processes writing a parallel vtk output.
+     */
+    std::string getAggregatedPieceName(const std::string& name,
+                                       const std::string& path,
+                                       int group, int commSize) const
+    {
+      std::ostringstream s;
+      if(path.size() > 0) {
+        s << path;
+        if(path[path.size()-1] != '/')
+          s << '/';
+      }
+      s << 's' << std::setw(4) << std::setfill('0') << commSize << '-';
+      s << 'a' << std::setw(4) << std::setfill('0') << group << '-';
+      s << name;
+      if(GridView::dimension > 1)
+        s << ".vtu";
+      else
+        s << ".vtp";
+      return s.str();
+    }
+
     //! return name of a parallel header file
     /**
      * \param name     Base name of the VTK output.  This should be without
@@ -879,6 +1042,9 @@ namespace Dune
                        VTK::OutputType ot, const int commRank,
                        const int commSize )
     {
+      if( aggregationSize_ > 1 )
+        return pwriteAggregated(name, path, extendpath, ot, commRank, commSize);
+
       // make data mode visible to private functions
       outputtype=ot;
 
@@ -920,6 +1086,101 @@ namespace Dune
       return fullname;
     }
 
+    //! write output with the pieces of groups of ranks combined into one file
+    /**
+     * Same as pwrite(), but the pieces of aggregationSize() consecutive ranks
+     * are written into one file by the first rank of each group.
+     */
+    std::string pwriteAggregated(const std::string& name, const std::string& path,
+                                 const std::string& extendpath,
+                                 VTK::OutputType ot, const int commRank,
+                                 const int commSize )
+    {
+      // appended data sections of several pieces cannot be combined
+      outputtype = (ot == VTK::appendedraw || ot == VTK::appendedbase64) ? VTK::base64 : ot;
+
+      std::string piecepath = concatPaths(path, extendpath);
+      std::string relpiecepath = relativePath(path, piecepath);
+
+      // write this processes piece into memory
+      std::ostringstream piece;
+      writeDataFile(piece, true);
+
+      // the first rank of each group writes the pieces of the group
+      std::string fullname = getAggregatedPieceName(name, piecepath,
+                                                    commRank / aggregationSize_,
+                                                    commSize);
+      const bool aggregator = (commRank == VTK::aggregatorRank(commRank, aggregationSize_));
+      std::ofstream file;
+      if( aggregator )
+        file.open(fullname.c_str(), std::ios::binary);
+
+      // all ranks have to know whether an aggregator failed before any
+      // piece is sent, otherwise the other ranks of its group would block
+      if( gridView_.comm().max( int( aggregator && !file.is_open() ) ) )
+        DUNE_THROW(IOError, "Could not write to the aggregated piece files of "
+                   << name << " on at least one rank");
+      // an aggregator failing while writing keeps receiving the pieces of its
+      // group; the error is made collective once all pieces are sent
+      std::string error;
+      try
+      {
+        VTK::FileType fileType =
+          (n == 1) ? VTK::polyData : VTK::unstructuredGrid;
+        std::unique_ptr<VTK::VTUWriter> writer;
+        if( file.is_open() )
+        {
+          writer.reset(new VTK::VTUWriter(file, outputtype, fileType));
+          writer->beginPieces();
+        }
+        VTK::aggregatePieces(gridView_.comm(), aggregationSize_, piece.str(),
+                             [&writer, &file, &fullname] ( const std::string& p )
+                             {
+                               writer->addPiece(p);
+                               if( !file )
+                                 DUNE_THROW(IOError, "Failed writing to file " << fullname);
+                             });
+        if( writer )
+          writer->endPieces();
+      }
+      catch( const Dune::Exception &e )
+      {
+        error = e.what();
+      }
+      catch( const std::exception &e )
+      {
+        error = e.what();
+      }
+      if( file.is_open() )
+      {
+        file.close();
+        if( !file && error.empty() )
+          error = "Failed writing to file " + fullname;
+      }
+      if( gridView_.comm().max( int( !error.empty() ) ) )
+        DUNE_THROW(IOError, "Could not write the aggregated piece files of "
+                   << name << " on at least one rank"
+                   << (error.empty() ? std::string() : ": " + error));
+
+      // if we are rank 0, write .pvtu/.pvtp parallel header
+      fullname = getParallelHeaderName(name, path, commSize);
+      int opened = 1;
+      if( commRank  ==0 )
+      {
+        file.open(fullname.c_str());
+        opened = file.is_open();
+        if( opened )
+        {
+          writeParallelHeader(file,name,relpiecepath, commSize );
+          file.close();
+        }
+      }
+      gridView_.comm().broadcast(&opened, 1, 0);
+      if( !opened )
+        DUNE_THROW(IOError, "Could not write to parallel file " << fullname);
+      return fullname;
+    }
+
   private:
     //! write header file in parallel case to stream
     /**
@@ -962,7 +1223,7 @@ namespace Dune
       {
         unsigned writecomps = it->fieldInfo().size();
         if(writecomps == 2) writecomps = 3;
-        writer.addArray<float>(it->name(), writecomps);
+        writer.addArray(it->name(), writecomps, it->fieldInfo().precision());
       }
       writer.endPointData();
 
@@ -979,68 +1240,137 @@ namespace Dune
       {
         unsigned writecomps = it->fieldInfo().size();
         if(writecomps == 2) writecomps = 3;
-        writer.addArray<float>(it->name(), writecomps);
+        writer.addArray(it->name(), writecomps, it->fieldInfo().precision());
       }
       writer.endCellData();
 
       // PPoints
       writer.beginPoints();
-      writer.addArray<float>("Coordinates", 3);
+      writer.addArray("Coordinates", 3, coordinatePrecision_);
       writer.endPoints();
 
-      // Pieces
-      for( int i = 0; i < commSize; ++i )
+      // Pieces, one per group of ranks if aggregated
+      if( aggregationSize_ > 1 )
       {
-        const std::string& fullname = getParallelPieceName(piecename,
-                                                           piecepath, i,
-                                                           commSize);
-        writer.addPiece(fullname);
+        const int groups = (commSize + aggregationSize_ - 1) / aggregationSize_;
+        for( int i = 0; i < groups; ++i )
+          writer.addPiece(getAggregatedPieceName(piecename, piecepath, i,
+                                                 commSize));
+      }
+      else
+      {
+        for( int i = 0; i < commSize; ++i )
+        {
+          const std::string& fullname = getParallelPieceName(piecename,
+                                                             piecepath, i,
+                                                             commSize);
+          writer.addPiece(fullname);
+        }
       }
 
       writer.endMain();
     }
 
     //! write data file to stream
-    void writeDataFile (std::ostream& s)
+    /**
+     * \param s         Stream to write the file contents to.
+     * \param pieceOnly Write only the Piece element, see VTK::VTUWriter.
+     */
+    void writeDataFile (std::ostream& s, bool pieceOnly = false)
     {
       VTK::FileType fileType =
         (n == 1) ? VTK::polyData : VTK::unstructuredGrid;
 
-      VTK::VTUWriter writer(s, outputtype, fileType);
+      VTK::VTUWriter writer(s, outputtype, fileType, pieceOnly);
+      writePiece(writer);
+    }
 
+    //! record the piece of this process into a snapshot
+    /**
+     * The snapshot holds the grid and all cell and vertex data as they are
+     * now and can be encoded by VTK::VTUSnapshot::write() later on.
+     */
+    void recordSnapshot (VTK::VTUSnapshot& snapshot)
+    {
+      VTK::VTUWriter writer(snapshot);
+      writePiece(writer);
+    }
+
+    void writePiece (VTK::VTUWriter& writer)
+    {
       // Grid characteristics
       vertexmapper = new VertexMapper( gridView_ );
       if (datamode == VTK::conforming)
       {
         number.resize(vertexmapper->size());
-        for (std::vector<int>::size_type i=0; i<number.size(); i++) number[i] = -1;
+        std::fill(number.begin(), number.end(), -1);
       }
       countEntities(nvertices, ncells, ncorners);
+      const VTK::VTUSnapshot* grid = cachedGrid();
 
       writer.beginMain(ncells, nvertices);
-      writeAllData(writer);
+      writeAllData(writer, grid);
       writer.endMain();
 
       // write appended binary data section
       if(writer.beginAppended())
-        writeAllData(writer);
+        writeAllData(writer, grid);
       writer.endAppended();
 
       delete vertexmapper; number.clear();
     }
 
-    void writeAllData(VTK::VTUWriter& writer) {
+    void writeAllData(VTK::VTUWriter& writer, const VTK::VTUSnapshot* grid) {
       // PointData
       writeVertexData(writer);
 
       // CellData
       writeCellData(writer);
 
-      // Points
-      writeGridPoints(writer);
+      if(grid)
+        grid->replay(writer);
+      else
+      {
+        // Points
+        writeGridPoints(writer);
+
+        // Cells
+        writeGridCells(writer);
+      }
+    }
 
-      // Cells
-      writeGridCells(writer);
+    //! return the recorded points and cells, if they may be reused
+    /**
+     * The cache is rebuilt when the grid generation or one of the entity
+     * counts changed since it was recorded.  Returns a null pointer if
+     * caching is disabled.
+     */
+    const VTK::VTUSnapshot* cachedGrid()
+    {
+      if(!cacheGrid_)
+        return nullptr;
+
+      const bool valid = gridCache_
+                         && gridCacheKey_.generation == gridGeneration_
+                         && gridCacheKey_.ncells == ncells
+                         && gridCacheKey_.nvertices == nvertices
+                         && gridCacheKey_.ncorners == ncorners
+                         && gridCacheKey_.coordinatePrecision == coordinatePrecision_
+                         && gridCacheKey_.indexPrecision == indexPrecision_;
+      if(!valid)
+      {
+        VTK::FileType fileType =
+          (n == 1) ? VTK::polyData : VTK::unstructuredGrid;
+        gridCache_ = std::make_shared<VTK::VTUSnapshot>(fileType);
+        VTK::VTUWriter recorder(*gridCache_);
+        writeGridPoints(recorder);
+        writeGridCells(recorder);
+
+        GridCacheKey key = { gridGeneration_, ncells, nvertices, ncorners,
+                             coordinatePrecision_, indexPrecision_ };
+        gridCacheKey_ = key;
+      }
+      return gridCache_.get();
     }
 
   protected:
@@ -1066,7 +1396,7 @@ namespace Dune
     }
 
     //! count the vertices, cells and corners
-    virtual void countEntities(int &nvertices, int &ncells, int &ncorners)
+    virtual void countEntities(std::int64_t &nvertices, std::int64_t &ncells, std::int64_t &ncorners)
     {
       nvertices = 0;
       ncells = 0;
@@ -1122,7 +1452,7 @@ namespace Dune
     }
 
     template<typename Data, typename Iterator>
-    void writeData(VTK::VTUWriter& writer, const Data& data, const Iterator begin, const Iterator end, int nentries)
+    void writeData(VTK::VTUWriter& writer, const Data& data, const Iterator begin, const Iterator end, std::int64_t nentries)
     {
       for (auto it = data.begin(),
              iend = data.end();
@@ -1130,39 +1460,66 @@ namespace Dune
            ++it)
       {
         const auto& f = *it;
-        VTK::FieldInfo fieldInfo = f.fieldInfo();
-        std::size_t writecomps = fieldInfo.size();
-        switch (fieldInfo.type())
+        std::size_t writecomps = writeComponents(f.fieldInfo());
+        switch (f.fieldInfo().precision())
           {
-          case VTK::FieldInfo::Type::scalar:
+          case VTK::Precision::int32:
+            writeFunction<int>(writer, f, writecomps, begin, end, nentries);
             break;
-          case VTK::FieldInfo::Type::vector:
-            // vtk file format: a vector data always should have 3 comps (with
-            // 3rd comp = 0 in 2D case)
-            if (writecomps > 3)
-              DUNE_THROW(IOError,"Cannot write VTK vectors with more than 3 components (components was " << writecomps << ")");
-            writecomps = 3;
+          case VTK::Precision::int64:
+            writeFunction<std::int64_t>(writer, f, writecomps, begin, end, nentries);
+            break;
+          case VTK::Precision::float32:
+            writeFunction<float>(writer, f, writecomps, begin, end, nentries);
+            break;
+          case VTK::Precision::float64:
+            writeFunction<double>(writer, f, writecomps, begin, end, nentries);
             break;
-          case VTK::FieldInfo::Type::tensor:
-            DUNE_THROW(NotImplemented,"VTK output for tensors not implemented yet");
-          }
-        shared_ptr<VTK::DataArrayWriter<float> > p
-          (writer.makeArrayWriter<float>(f.name(), writecomps, nentries));
-        if(!p->writeIsNoop())
-          for (Iterator eit = begin; eit!=end; ++eit)
-          {
-            const Entity & e = *eit;
-            f.bind(e);
-            f.write(eit.position(),*p);
-            f.unbind();
-            // vtk file format: a vector data always should have 3 comps
-            // (with 3rd comp = 0 in 2D case)
-            for (std::size_t j=fieldInfo.size(); j < writecomps; ++j)
-              p->write(0.0);
           }
       }
     }
 
+    //! return the number of components to write for a field
+    static std::size_t writeComponents(const VTK::FieldInfo& fieldInfo)
+    {
+      std::size_t writecomps = fieldInfo.size();
+      switch (fieldInfo.type())
+        {
+        case VTK::FieldInfo::Type::scalar:
+          break;
+        case VTK::FieldInfo::Type::vector:
+          // vtk file format: a vector data always should have 3 comps (with
+          // 3rd comp = 0 in 2D case)
+          if (writecomps > 3)
+            DUNE_THROW(IOError,"Cannot write VTK vectors with more than 3 components (components was " << writecomps << ")");
+          writecomps = 3;
+          break;
+        case VTK::FieldInfo::Type::tensor:
+          DUNE_THROW(NotImplemented,"VTK output for tensors not implemented yet");
+        }
+      return writecomps;
+    }
+
+    template<typename T, typename Iterator>
+    void writeFunction(VTK::VTUWriter& writer, const VTKLocalFunction& f, std::size_t writecomps,
+                       const Iterator begin, const Iterator end, std::int64_t nentries)
+    {
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>(f.name(), writecomps, nentries));
+      if(!p->writeIsNoop())
+        for (Iterator eit = begin; eit!=end; ++eit)
+        {
+          const Entity & e = *eit;
+          f.bind(e);
+          f.write(eit.position(),*p);
+          f.unbind();
+          // vtk file format: a vector data always should have 3 comps
+          // (with 3rd comp = 0 in 2D case)
+          for (std::size_t j=f.fieldInfo().size(); j < writecomps; ++j)
+            p->write(T(0));
+        }
+    }
+
     //! write cell data
     virtual void writeCellData(VTK::VTUWriter& writer)
     {
@@ -1195,9 +1552,19 @@ namespace Dune
     virtual void writeGridPoints(VTK::VTUWriter& writer)
     {
       writer.beginPoints();
+      if (coordinatePrecision_ == VTK::Precision::float64)
+        writeCoordinates<double>(writer);
+      else
+        writeCoordinates<float>(writer);
+      writer.endPoints();
+    }
 
-      shared_ptr<VTK::DataArrayWriter<float> > p
-        (writer.makeArrayWriter<float>("Coordinates", 3, nvertices));
+    //! write the positions of vertices with coordinate type T
+    template<typename T>
+    void writeCoordinates(VTK::VTUWriter& writer)
+    {
+      shared_ptr<VTK::DataArrayWriter<T> > p
+        (writer.makeArrayWriter<T>("Coordinates", 3, nvertices));
       if(!p->writeIsNoop()) {
         VertexIterator vEnd = vertexEnd();
         for (VertexIterator vit=vertexBegin(); vit!=vEnd; ++vit)
@@ -1206,35 +1573,55 @@ namespace Dune
           for (int j=0; j<std::min(dimw,3); j++)
             p->write((*vit).geometry().corner(vit.localindex())[j]);
           for (int j=std::min(dimw,3); j<3; j++)
-            p->write(0.0);
+            p->write(T(0));
         }
       }
-      // free the VTK::DataArrayWriter before touching the stream
-      p.reset();
-
-      writer.endPoints();
     }
 
     //! write the connectivity array
     virtual void writeGridCells(VTK::VTUWriter& writer)
     {
       writer.beginCells();
+      if (indexPrecision_ == VTK::Precision::int64)
+        writeConnectivity<std::int64_t>(writer);
+      else
+        writeConnectivity<int>(writer);
 
+      // types
+      if (n>1)
+      {
+        shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
+          (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
+        if(!p3->writeIsNoop())
+          for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
+          {
+            int vtktype = VTK::geometryType(it->type());
+            p3->write(vtktype);
+          }
+      }
+
+      writer.endCells();
+    }
+
+    //! write the connectivity and offsets arrays with index type T
+    template<typename T>
+    void writeConnectivity(VTK::VTUWriter& writer)
+    {
       // connectivity
       {
-        shared_ptr<VTK::DataArrayWriter<int> > p1
-          (writer.makeArrayWriter<int>("connectivity", 1, ncorners));
+        shared_ptr<VTK::DataArrayWriter<T> > p1
+          (writer.makeArrayWriter<T>("connectivity", 1, ncorners));
         if(!p1->writeIsNoop())
           for (CornerIterator it=cornerBegin(); it!=cornerEnd(); ++it)
-            p1->write(it.id());
+            p1->write(T(it.id()));
       }
 
       // offsets
       {
-        shared_ptr<VTK::DataArrayWriter<int> > p2
-          (writer.makeArrayWriter<int>("offsets", 1, ncells));
+        shared_ptr<VTK::DataArrayWriter<T> > p2
+          (writer.makeArrayWriter<T>("offsets", 1, ncells));
         if(!p2->writeIsNoop()) {
-          int offset = 0;
+          T offset = 0;
           for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
           {
             offset += it->subEntities(n);
@@ -1242,21 +1629,6 @@ namespace Dune
           }
         }
       }
-
-      // types
-      if (n>1)
-      {
-        shared_ptr<VTK::DataArrayWriter<unsigned char> > p3
-          (writer.makeArrayWriter<unsigned char>("types", 1, ncells));
-        if(!p3->writeIsNoop())
-          for (CellIterator it=cellBegin(); it!=cellEnd(); ++it)
-          {
-            int vtktype = VTK::geometryType(it->type());
-            p3->write(vtktype);
-          }
-      }
-
-      writer.endCells();
     }
 
   protected:
@@ -1268,15 +1640,31 @@ namespace Dune
     GridView gridView_;
 
     // temporary grid information
-    int ncells;
-    int nvertices;
-    int ncorners;
+    std::int64_t ncells;
+    std::int64_t nvertices;
+    std::int64_t ncorners;
   private:
     VertexMapper* vertexmapper;
     // in conforming mode, for each vertex id (as obtained by vertexmapper)
     // hold its number in the iteration order (VertexIterator)
-    std::vector<int> number;
+    std::vector<std::int64_t> number;
     VTK::DataMode datamode;
+    // number of ranks writing into one file
+    int aggregationSize_;
+    VTK::Precision coordinatePrecision_;
+    VTK::Precision indexPrecision_;
+
+    // recorded points and cells, see setGridGeneration()
+    struct GridCacheKey
+    {
+      unsigned long generation;
+      std::int64_t ncells, nvertices, ncorners;
+      VTK::Precision coordinatePrecision, indexPrecision;
+    };
+    bool cacheGrid_;
+    unsigned long gridGeneration_;
+    std::shared_ptr<VTK::VTUSnapshot> gridCache_;
+    GridCacheKey gridCacheKey_;
   protected:
     VTK::OutputType outputtype;
   };
@@ -4,8 +4,11 @@
 #ifndef DUNE_GRID_IO_FILE_VTK_VTUWRITER_HH
 #define DUNE_GRID_IO_FILE_VTK_VTUWRITER_HH
 
+#include <cstddef>
+#include <memory>
 #include <ostream>
 #include <string>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/indent.hh>
@@ -20,6 +23,100 @@ namespace Dune {
 
   namespace VTK {
 
+    class VTUWriter;
+
+    //! recorded contents of a single piece, to be encoded later
+    /**
+     * A VTUWriter constructed on a VTUSnapshot does not encode anything.
+     * Instead it records the sections written between beginMain() and
+     * endMain() together with the values of all data arrays.  The snapshot
+     * does not refer to the grid or to the written functions anymore, so
+     * write() may encode it at any later time, e.g. on a different thread.
+     */
+    class VTUSnapshot {
+      friend class VTUWriter;
+
+      enum Event {
+        openPointData, closePointData, openCellData, closeCellData,
+        openPoints, closePoints, openCells, closeCells, dataArray
+      };
+
+      struct Step {
+        Event event;
+        std::string scalars;
+        std::string vectors;
+      };
+
+      struct ArrayBase {
+        virtual void write(VTUWriter& writer) const = 0;
+        virtual std::size_t bytes() const = 0;
+        virtual ~ArrayBase() {}
+      };
+
+      // defined after VTUWriter
+      template<class T>
+      struct Array;
+
+      template<class T>
+      class Recorder : public DataArrayWriter<T> {
+        std::vector<T>& values;
+      public:
+        explicit Recorder(std::vector<T>& values_) : values(values_) {}
+        void write(T data) { values.push_back(data); }
+      };
+
+      FileType fileType;
+      std::size_t ncells, npoints;
+      std::vector<Step> steps;
+      std::vector<std::shared_ptr<const ArrayBase> > arrays;
+
+    public:
+      //! create an empty snapshot for a file of the given type
+      explicit VTUSnapshot(FileType fileType_)
+        : fileType(fileType_), ncells(0), npoints(0)
+      { }
+
+      //! number of bytes taken by the recorded data arrays
+      std::size_t bytes() const {
+        std::size_t result = 0;
+        for(std::size_t i = 0; i < arrays.size(); ++i)
+          result += arrays[i]->bytes();
+        return result;
+      }
+
+      //! encode the recorded piece into a complete .vtu/.vtp file
+      inline void write(std::ostream& s, OutputType outputType) const;
+
+      //! write the recorded sections and data arrays to writer
+      /**
+       * This replaces the calls recorded between beginMain() and endMain()
+       * and has to be repeated for the appended section.  If writer records
+       * into another snapshot, the data arrays are shared instead of copied.
+       */
+      inline void replay(VTUWriter& writer) const;
+
+    private:
+      void record(Event event, const std::string& scalars = "",
+                  const std::string& vectors = "") {
+        Step step = { event, scalars, vectors };
+        steps.push_back(step);
+      }
+
+      template<class T>
+      DataArrayWriter<T>* makeArrayWriter(const std::string& name,
+                                          unsigned ncomps, std::size_t nitems) {
+        std::shared_ptr<Array<T> > array(new Array<T>(name, ncomps, nitems));
+        arrays.push_back(array);
+        record(dataArray);
+        return new Recorder<T>(array->values);
+      }
+
+      static std::ostream& nullStream() {
+        static std::ostream s(0);
+        return s;
+      }
+    };
+
     //! Dump a .vtu/.vtp files contents to a stream
     /**
      * This will help generating a .vtu/.vtp file.  Typical use is like this:
@@ -106,6 +203,10 @@ namespace Dune {
       std::string cellName;
 
       bool doAppended;
+      bool pieceOnly;
+      VTUSnapshot* snapshot;
+
+      friend class VTUSnapshot;
 
     public:
       //! create a VTUWriter object
@@ -114,12 +215,19 @@ namespace Dune {
        * \param outputType How to encode data.
        * \param fileType_  Whether to write PolyData (1D) or UnstructuredGrid
        *                   (nD) format.
+       * \param pieceOnly_ Write only the Piece element, without file header
+       *                   and without the enclosing PolyData/UnstructuredGrid
+       *                   element.  The result can be combined with other
+       *                   pieces using beginPieces()/addPiece()/endPieces().
+       *                   Appended output types are not supported in this
+       *                   case, since their offsets refer to the whole file.
        *
        * Create object and write header.
        */
       inline VTUWriter(std::ostream& stream_, OutputType outputType,
-                       FileType fileType_)
-        : stream(stream_), factory(outputType, stream)
+                       FileType fileType_, bool pieceOnly_ = false)
+        : stream(stream_), factory(outputType, stream), pieceOnly(pieceOnly_),
+          snapshot(0)
       {
         switch(fileType_) {
         case polyData :
@@ -133,6 +241,16 @@ namespace Dune {
         default :
           DUNE_THROW(IOError, "VTUWriter: Unknown fileType: " << fileType_);
         }
+        if(pieceOnly) {
+          if(outputType == appendedraw || outputType == appendedbase64)
+            DUNE_THROW(NotImplemented, "VTUWriter: Cannot write appended "
+                       "data into a single piece");
+          // the piece is nested in VTKFile and PolyData/UnstructuredGrid
+          ++indent;
+          ++indent;
+          return;
+        }
+
         const std::string& byteOrder = getEndiannessString();
 
         stream << indent << "<?xml version=\"1.0\"?>\n";
@@ -143,8 +261,21 @@ namespace Dune {
         ++indent;
       }
 
+      //! create a VTUWriter recording into a snapshot
+      /**
+       * Nothing is written to any stream.  Instead the sections and data
+       * arrays of the piece are recorded into snapshot_, see VTUSnapshot.
+       * beginAppended() always returns false.
+       */
+      inline explicit VTUWriter(VTUSnapshot& snapshot_)
+        : stream(VTUSnapshot::nullStream()), factory(ascii, stream),
+          doAppended(false), pieceOnly(true), snapshot(&snapshot_)
+      { }
+
       //! write footer
       inline ~VTUWriter() {
+        if(pieceOnly)
+          return;
         --indent;
         stream << indent << "</VTKFile>\n"
                << std::flush;
@@ -164,6 +295,10 @@ namespace Dune {
        */
       inline void beginPointData(const std::string& scalars = "",
                                  const std::string& vectors = "") {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::openPointData, scalars, vectors);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<PointData";
@@ -178,6 +313,10 @@ namespace Dune {
       }
       //! finish PointData section
       inline void endPointData() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::closePointData);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -202,6 +341,10 @@ namespace Dune {
        */
       inline void beginCellData(const std::string& scalars = "",
                                 const std::string& vectors = "") {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::openCellData, scalars, vectors);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<CellData";
@@ -216,6 +359,10 @@ namespace Dune {
       }
       //! finish CellData section
       inline void endCellData() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::closeCellData);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -234,6 +381,10 @@ namespace Dune {
        * must be the number of points.
        */
       inline void beginPoints() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::openPoints);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<Points>\n";
@@ -245,6 +396,10 @@ namespace Dune {
       }
       //! finish section for the point coordinates
       inline void endPoints() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::closePoints);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -270,6 +425,10 @@ namespace Dune {
        * </ul>
        */
       inline void beginCells() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::openCells);
+          return;
+        }
         switch(phase) {
         case main :
           stream << indent << "<" << cellName << ">\n";
@@ -281,6 +440,10 @@ namespace Dune {
       }
       //! start section for the grid cells/PolyData lines
       inline void endCells() {
+        if(snapshot) {
+          snapshot->record(VTUSnapshot::closeCells);
+          return;
+        }
         switch(phase) {
         case main :
           --indent;
@@ -305,9 +468,17 @@ namespace Dune {
        * <li> beginCells()/endCells(),
        * </ul>
        */
-      inline void beginMain(unsigned ncells, unsigned npoints) {
-        stream << indent << "<" << fileType << ">\n";
-        ++indent;
+      inline void beginMain(std::size_t ncells, std::size_t npoints) {
+        if(snapshot) {
+          snapshot->ncells = ncells;
+          snapshot->npoints = npoints;
+          phase = main;
+          return;
+        }
+        if(!pieceOnly) {
+          stream << indent << "<" << fileType << ">\n";
+          ++indent;
+        }
         stream << indent << "<Piece"
                << " NumberOf" << cellName << "=\"" << ncells << "\""
                << " NumberOfPoints=\"" << npoints << "\">\n";
@@ -316,8 +487,32 @@ namespace Dune {
       }
       //! finish the main PolyData/UnstructuredGrid section
       inline void endMain() {
+        if(snapshot)
+          return;
         --indent;
         stream << indent << "</Piece>\n";
+        if(!pieceOnly) {
+          --indent;
+          stream << indent << "</" << fileType << ">\n";
+        }
+      }
+
+      //! start a PolyData/UnstructuredGrid section made of separate pieces
+      /**
+       * Inbetween the call to this method and to endPieces(), there should
+       * be calls to addPiece() only.  This replaces the
+       * beginMain()/endMain() and beginAppended()/endAppended() calls.
+       */
+      inline void beginPieces() {
+        stream << indent << "<" << fileType << ">\n";
+        ++indent;
+      }
+      //! add a piece written by a VTUWriter in piece-only mode
+      inline void addPiece(const std::string& piece) {
+        stream << piece;
+      }
+      //! finish a PolyData/UnstructuredGrid section made of separate pieces
+      inline void endPieces() {
         --indent;
         stream << indent << "</" << fileType << ">\n";
       }
@@ -341,6 +536,10 @@ namespace Dune {
        * function.
        */
       inline bool beginAppended() {
+        if(snapshot) {
+          phase = appended;
+          return false;
+        }
         doAppended = factory.beginAppended();
         if(doAppended) {
           const std::string& encoding = factory.appendedEncoding();
@@ -377,11 +576,75 @@ namespace Dune {
        */
       template<typename T>
       DataArrayWriter<T>* makeArrayWriter(const std::string& name,
-                                          unsigned ncomps, unsigned nitems) {
+                                          unsigned ncomps, std::size_t nitems) {
+        if(snapshot)
+          return snapshot->makeArrayWriter<T>(name, ncomps, nitems);
         return factory.make<T>(name, ncomps, nitems, indent);
       }
     };
 
+    template<class T>
+    struct VTUSnapshot::Array : public VTUSnapshot::ArrayBase {
+      std::string name;
+      unsigned ncomps;
+      std::size_t nitems;
+      std::vector<T> values;
+
+      Array(const std::string& name_, unsigned ncomps_, std::size_t nitems_)
+        : name(name_), ncomps(ncomps_), nitems(nitems_)
+      {
+        values.reserve(std::size_t(ncomps)*nitems);
+      }
+
+      void write(VTUWriter& writer) const {
+        std::shared_ptr<DataArrayWriter<T> > p
+          (writer.makeArrayWriter<T>(name, ncomps, nitems));
+        if(!p->writeIsNoop())
+          for(std::size_t i = 0; i < values.size(); ++i)
+            p->write(values[i]);
+      }
+
+      std::size_t bytes() const { return values.size()*sizeof(T); }
+    };
+
+    inline void VTUSnapshot::write(std::ostream& s,
+                                   OutputType outputType) const {
+      VTUWriter writer(s, outputType, fileType);
+      writer.beginMain(ncells, npoints);
+      replay(writer);
+      writer.endMain();
+      if(writer.beginAppended())
+        replay(writer);
+      writer.endAppended();
+    }
+
+    inline void VTUSnapshot::replay(VTUWriter& writer) const {
+      if(writer.snapshot) {
+        writer.snapshot->steps.insert(writer.snapshot->steps.end(),
+                                      steps.begin(), steps.end());
+        writer.snapshot->arrays.insert(writer.snapshot->arrays.end(),
+                                       arrays.begin(), arrays.end());
+        return;
+      }
+      std::size_t array = 0;
+      for(std::size_t i = 0; i < steps.size(); ++i) {
+        const Step& step = steps[i];
+        switch(step.event) {
+        case openPointData :
+          writer.beginPointData(step.scalars, step.vectors); break;
+        case closePointData : writer.endPointData(); break;
+        case openCellData :
+          writer.beginCellData(step.scalars, step.vectors); break;
+        case closeCellData : writer.endCellData(); break;
+        case openPoints : writer.beginPoints(); break;
+        case closePoints : writer.endPoints(); break;
+        case openCells : writer.beginCells(); break;
+        case closeCells : writer.endCells(); break;
+        case dataArray : arrays[array++]->write(writer); break;
+        }
+      }
+    }
+
   } // namespace VTK
 
   //! \} group VTK
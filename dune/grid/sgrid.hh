@@ -822,25 +822,9 @@ namespace Dune {
 
   //************************************************************************
 
-  /** \brief a stack of pointers with auto destruction if the stack is
-      destructed
-   */
-  template <class T>
-  class AutoPtrStack : public std::stack<T*>
-  {
-  public:
-    ~AutoPtrStack()
-    {
-      while(! this->empty())
-      {
-        T* e = this->top();
-        delete e;
-        this->pop();
-      }
-    }
-  };
-
   /*! Acts as a pointer to an  entities of a given codimension.
+
+     The entity is stored by value and only built on dereferencing.
    */
   template<int codim, class GridImp>
   class SEntityPointer
@@ -863,26 +847,24 @@ namespace Dune {
     //! constructor
     SEntityPointer (GridImp * _grid, int _l, int _index) :
       grid(_grid), l(_l), index(_index),
-      e(0)
+      built(false)
     {}
 
     //! constructor
     SEntityPointer (const SEntity<codim,dim,GridImp> & _e) :
       grid(_e.grid), l(_e.l), index(_e.index),
-      e(0)
+      built(false)
     {}
 
     //! constructor
     SEntityPointer (const SEntityPointer<codim,GridImp>& other) :
       grid(other.grid), l(other.l), index(other.index),
-      e( 0 )
+      built(false)
     {}
 
     //! destructor pointer
     ~SEntityPointer()
     {
-      if( e )
-        enStack().push( e );
 #ifndef NDEBUG
       index = -1;
 #endif
@@ -894,12 +876,7 @@ namespace Dune {
       grid = other.grid;
       l = other.l;
       index = other.index;
-
-      // free current entity
-      if( e )
-        enStack().push( e );
-      e = 0;
-
+      built = false;
       return *this;
     }
 
@@ -911,42 +888,25 @@ namespace Dune {
 
     inline Entity& entity() const
     {
-      if( ! e )
+      if( ! built )
       {
-        e = getEntity( grid, l, index );
+        grid->getRealImplementation(e).make(grid, l, index);
+        built = true;
       }
-      return *e;
+      return e;
     }
 
-    typedef AutoPtrStack< Entity > EntityStackType;
-    static inline EntityStackType& enStack()
+    //! rebuild the entity on the next dereference, call after changing l or index
+    void invalidate ()
     {
-      static EntityStackType eStack;
-      return eStack;
-    }
-
-    inline Entity* getEntity(GridImp* _grid, int _l, int _id ) const
-    {
-      // get stack reference
-      EntityStackType& enSt = enStack();
-
-      if( enSt.empty() )
-      {
-        return (new Entity(SEntity<codim,dim,GridImp>(_grid, _l, _id)));
-      }
-      else
-      {
-        Entity* e = enSt.top();
-        enSt.pop();
-        grid->getRealImplementation(*e).make(_grid, _l,_id);
-        return e;
-      }
+      built = false;
     }
 
     GridImp* grid;               //!< my grid
     int l;                       //!< level where element is on
     mutable int index;           //!< my consecutive index
-    mutable Entity* e;           //!< virtual entity
+    mutable Entity e;            //!< the entity, valid if built is true
+    mutable bool built;          //!< true if e refers to (l,index)
   };
 
   /*! describes the minimal information necessary to create a fully functional SEntity
@@ -1665,6 +1625,9 @@ namespace Dune {
     // boundary segement index set
     array<CubeMapper<dim-1>, dim> boundarymapper; // a mapper for each coarse grid face
     int boundarysize;
+
+    // offsets of subentities in expanded coordinates, per codim and subentity
+    std::vector<array<int,dim> > subzoffset[dim+1];
   };
 
   namespace Capabilities
@@ -131,26 +131,21 @@ namespace Dune {
       lex[b].init(t);           // set up lex ordering of tupels
       nb[b] = lex[b].tupels();
       cb[b] = ones(b);
+
+      // partitions of one codimension are numbered consecutively
+      offset[b] = ne[cb[b]];
       ne[cb[b]] += nb[b];
+
+      stride[b][0] = 1;
+      for (int i=1; i<=dim; i++)
+        stride[b][i] = stride[b][i-1]*t[i-1];
     }
 
-    // preprocess lex ordering for each codimension
+    // collect the binary partitions of each codimension
     for (int c=0; c<=dim; c++)
-    {
-      array<int,1<<dim> t;
-      for (int b=0; b<power2(dim); b++)           // loop over all binary partitions
-        if (ones(b)==c)
-        {
-          // partition b is part of codim c
-          t[b] = nb[b];
-        }
-        else
-        {
-          // partition does not contribute to codim c
-          t[b] = 0;
-        }
-      join[c].init(t);           // set join mapper
-    }
+      np[c] = 0;
+    for (int b=0; b<power2(dim); b++)
+      pc[cb[b]][np[cb[b]]++] = b;
   }
 
   template<int dim>
@@ -187,18 +182,13 @@ namespace Dune {
   template<int dim>
   inline int CubeMapper<dim>::n (const array<int,dim>& z) const
   {
-    int p = partition(z);            // get partition
-    array<int,dim> r=compress(z);     // get compressd coordinate
+    const int p = partition(z);            // get partition
 
-    // treat easy cases first
-    if (p==0 || p==power2(dim)-1)
-    {
-      // all components are either odd or even
-      return lex[p].n(r);
-    }
-
-    // general case
-    return join[ones(p)].n(p,lex[p].n(r));
+    // z[i]>>1 is the compressed coordinate for even and odd components
+    int r = offset[p];
+    for (int i=0; i<dim; i++)
+      r += (z[i]>>1)*stride[p][i];
+    return r;
   }
 
   template<int dim>
@@ -218,10 +208,11 @@ namespace Dune {
       return expand(r,power2(dim)-1);
     }
 
-    // general case
-    int p = join[codim].subset(i);
-    int n = join[codim].index(i);
-    r = lex[p].z(n);
+    // general case: find the partition containing i
+    int p = pc[codim][0];
+    for (int k=1; k<np[codim] && i>=offset[pc[codim][k]]; k++)
+      p = pc[codim][k];
+    r = lex[p].z(i-offset[p]);
     return expand(r,p);
   }
 
@@ -242,12 +233,8 @@ namespace Dune {
   inline int CubeMapper<dim>::partition (const array<int,dim>& z) const
   {
     int r = 0;
-    int mask = 1;
     for (int i=0; i<dim; i++)
-    {
-      if (z[i]%2==0) r += mask;
-      mask *=2 ;
-    }
+      r |= (~z[i] & 1) << i;           // bit i is set for even components
     return r;
   }
 
@@ -96,7 +96,7 @@ namespace Dune {
     int codim (const array<int,dim>& z) const;
 
     /*! compute number from coordinate 0 <= n < elements(codim(z))
-         general implementation is O(2^dim)
+         uses precomputed strides and is O(dim)
      */
     int n (const array<int,dim>& z) const;
 
@@ -121,7 +121,10 @@ namespace Dune {
     int nb[1<<dim];       // number of elements per binary partition
     int cb[1<<dim];       // codimension of binary partition
     LexOrder<dim> lex[1<<dim];         // lex ordering within binary partition
-    JoinOrder<1<<dim> join[dim+1];     // join subsets of codimension
+    int offset[1<<dim];                // number of the first element of a binary partition within its codimension
+    int stride[1<<dim][dim+1];         // stride[b][i] = Prod_{k<i} size of partition b in direction k
+    int np[dim+1];                     // number of binary partitions per codimension
+    int pc[dim+1][1<<dim];             // binary partitions of a codimension in ascending order
 
     inline int power2 (int i) const {return 1<<i;}
     inline int ones (int b) const;     // count number of bits set in binary rep of b
@@ -270,7 +270,7 @@ namespace Dune {
     stack.pop();
     l = newe.l;
     index = newe.index;
-    realEntity().make(l,index);     // here is our new element
+    this->invalidate();     // here is our new element
 
     // push all sons of this element if it is not the original element
     if (newe.l!=orig_l || newe.index!=orig_index)
@@ -486,7 +486,7 @@ namespace Dune {
   inline void SLevelIterator<codim,pitype,GridImp>::increment ()
   {
     ++index;
-    realEntity().make(l,index);
+    this->invalidate();
   }
 
   //************************************************************************
@@ -569,6 +569,23 @@ namespace Dune {
       boundarymapper[d].make(fsize);
       boundarysize += 2 * boundarymapper[d].elements(0);
     }
+
+    // tabulate the offsets of subentities in expanded coordinates
+    for (int codim=0; codim<=dim; codim++)
+    {
+      const int count = SUnitCubeMapper<dim>::mapper.elements(codim);
+      subzoffset[codim].resize(count);
+      for (int i=0; i<count; i++)
+      {
+        // map to old numbering
+        const int j = SGridInternal::CubeNumberingTable<dim>::generic2dune( i, codim );
+
+        // find expanded coordinates of entity in reference cube
+        // has components in {0,1,2}
+        const array<int,dim> zref = SUnitCubeMapper<dim>::mapper.z(j,codim);
+        for (int k=0; k<dim; k++) subzoffset[codim][i][k] = zref[k] - 1;
+      }
+    }
   }
 
   template<int dim, int dimworld, typename ctype>
@@ -734,16 +751,10 @@ namespace Dune {
   template<int dim, int dimworld, typename ctype>
   inline array<int,dim> SGrid<dim,dimworld,ctype>::subz (const array<int,dim> & z, int i, int codim) const
   {
-    // map to old numbering
-    const int j = SGridInternal::CubeNumberingTable<dim>::generic2dune( i, codim );
-
-    // find expanded coordinates of entity in reference cube
-    // has components in {0,1,2}
-    array<int,dim> zref = SUnitCubeMapper<dim>::mapper.z(j,codim);
-
     // compute expanded coordinates of entity in global coordinates
+    const array<int,dim>& zoffset = subzoffset[codim][i];
     array<int,dim> zentity;
-    for (int k=0; k<dim; k++) zentity[k] = z[k] + zref[k] - 1;
+    for (int k=0; k<dim; k++) zentity[k] = z[k] + zoffset[k];
 
     return zentity;
   }
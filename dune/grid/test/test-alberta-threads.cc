@@ -0,0 +1,265 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#include <config.h>
+
+/** \file
+ *  \brief compare the multithreaded traversals of AlbertaGrid's mesh with
+ *         the sequential ones and traverse the mesh from several threads
+ *         at the same time
+ */
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <dune/common/array.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/parallel/mpihelper.hh>
+
+#include <dune/grid/albertagrid.hh>
+#include <dune/grid/utility/structuredgridfactory.hh>
+
+// Visit
+// -----
+
+// one element visited by a traversal
+template< class ElementInfo >
+struct Visit
+{
+  explicit Visit ( const ElementInfo &info )
+    : element( info.el() ), level( info.level() ), type( info.type() )
+  {
+    for( int i = 0; i < Dune::Alberta::dimWorld; ++i )
+      corner[ i ] = info.coordinate( 0 )[ i ];
+  }
+
+  bool operator== ( const Visit &other ) const
+  {
+    return (element == other.element) && (level == other.level)
+           && (type == other.type) && (corner == other.corner);
+  }
+
+  const void *element;
+  int level, type;
+  Dune::FieldVector< Dune::Alberta::Real, Dune::Alberta::dimWorld > corner;
+};
+
+
+// Recorder
+// --------
+
+// record all visited elements in traversal order
+template< class ElementInfo >
+struct Recorder
+{
+  void operator() ( const ElementInfo &info ) { visits.push_back( Visit< ElementInfo >( info ) ); }
+
+  std::vector< Visit< ElementInfo > > visits;
+};
+
+
+// Counter
+// -------
+
+// count the visited elements and their levels, used with a reduction
+template< class ElementInfo >
+struct Counter
+{
+  Counter () : elements( 0 ), levels( 0 ) {}
+
+  void operator() ( const ElementInfo &info ) { ++elements; levels += info.level(); }
+
+  long elements, levels;
+};
+
+struct AddCounter
+{
+  template< class Counter >
+  void operator() ( Counter &sum, const Counter &part ) const
+  {
+    sum.elements += part.elements;
+    sum.levels += part.levels;
+  }
+};
+
+
+// concatenate the records of all ranges in range order
+template< class ElementInfo >
+std::vector< Visit< ElementInfo > > concatenate ( const std::vector< Recorder< ElementInfo > > &recorders )
+{
+  std::vector< Visit< ElementInfo > > visits;
+  for( std::size_t i = 0; i < recorders.size(); ++i )
+    visits.insert( visits.end(), recorders[ i ].visits.begin(), recorders[ i ].visits.end() );
+  return visits;
+}
+
+
+template< class MeshPointer >
+bool checkParallelTraversal ( const MeshPointer &mesh, unsigned int numThreads )
+{
+  typedef typename MeshPointer::MacroIterator::ElementInfo ElementInfo;
+  bool success = true;
+
+  Recorder< ElementInfo > leaf, hierarchic;
+  mesh.leafTraverse( leaf );
+  mesh.hierarchicTraverse( hierarchic );
+
+  // equal macro element ranges and weighted ranges visit the same elements
+  // in the same order as the sequential traversal
+  for( int weighted = 0; weighted < 2; ++weighted )
+  {
+    std::vector< Recorder< ElementInfo > > recorders( numThreads );
+    if( weighted )
+      mesh.parallelLeafTraverse( recorders, mesh.partition( numThreads, true ) );
+    else
+      mesh.parallelLeafTraverse( recorders );
+    if( !(concatenate( recorders ) == leaf.visits) )
+    {
+      std::cerr << "Error: parallel leaf traversal on " << numThreads << " threads"
+                << (weighted ? " (weighted)" : "") << " differs from leafTraverse." << std::endl;
+      success = false;
+    }
+
+    recorders.assign( numThreads, Recorder< ElementInfo >() );
+    if( weighted )
+      mesh.parallelHierarchicTraverse( recorders, mesh.partition( numThreads, false ) );
+    else
+      mesh.parallelHierarchicTraverse( recorders );
+    if( !(concatenate( recorders ) == hierarchic.visits) )
+    {
+      std::cerr << "Error: parallel hierarchic traversal on " << numThreads << " threads"
+                << (weighted ? " (weighted)" : "") << " differs from hierarchicTraverse." << std::endl;
+      success = false;
+    }
+  }
+
+  // the reduction adds to the state of the caller's functor exactly once
+  Counter< ElementInfo > counter, expected;
+  counter.elements = expected.elements = 7;
+  counter.levels = expected.levels = 11;
+  mesh.leafTraverse( expected );
+  mesh.parallelLeafTraverse( counter, numThreads, AddCounter() );
+  if( (counter.elements != expected.elements) || (counter.levels != expected.levels) )
+  {
+    std::cerr << "Error: reduced leaf traversal on " << numThreads << " threads counts "
+              << counter.elements << " elements instead of " << expected.elements << "." << std::endl;
+    success = false;
+  }
+
+  return success;
+}
+
+
+// traverse the whole mesh from several threads at the same time
+template< class MeshPointer >
+bool checkConcurrentTraversal ( const MeshPointer &mesh, unsigned int numThreads )
+{
+  typedef typename MeshPointer::MacroIterator MacroIterator;
+  typedef typename MacroIterator::ElementInfo ElementInfo;
+
+  Recorder< ElementInfo > leaf, hierarchic;
+  mesh.leafTraverse( leaf );
+  mesh.hierarchicTraverse( hierarchic );
+
+  // the macro element infos of each thread are created here and released
+  // by the thread, which puts their instances on its own stack
+  std::vector< std::vector< ElementInfo > > macroInfos( numThreads );
+  for( unsigned int t = 0; t < numThreads; ++t )
+  {
+    for( MacroIterator it = mesh.begin(); it != mesh.end(); ++it )
+      macroInfos[ t ].push_back( it.elementInfo() );
+  }
+
+  std::vector< Recorder< ElementInfo > > leafs( numThreads ), hierarchics( numThreads ), fromMacro( numThreads );
+  std::vector< std::thread > threads;
+  for( unsigned int t = 0; t < numThreads; ++t )
+  {
+    threads.push_back( std::thread( [ &mesh, &leafs, &hierarchics, &fromMacro, &macroInfos, t ] {
+        for( int r = 0; r < 3; ++r )
+        {
+          leafs[ t ] = Recorder< ElementInfo >();
+          hierarchics[ t ] = Recorder< ElementInfo >();
+          mesh.leafTraverse( leafs[ t ] );
+          mesh.hierarchicTraverse( hierarchics[ t ] );
+        }
+        for( std::size_t i = 0; i < macroInfos[ t ].size(); ++i )
+          macroInfos[ t ][ i ].leafTraverse( fromMacro[ t ] );
+        macroInfos[ t ].clear();
+      } ) );
+  }
+  for( unsigned int t = 0; t < numThreads; ++t )
+    threads[ t ].join();
+
+  bool success = true;
+  for( unsigned int t = 0; t < numThreads; ++t )
+  {
+    if( !(leafs[ t ].visits == leaf.visits) || !(fromMacro[ t ].visits == leaf.visits) )
+    {
+      std::cerr << "Error: concurrent leaf traversal on thread " << t << " of " << numThreads
+                << " differs from the serial one." << std::endl;
+      success = false;
+    }
+    if( !(hierarchics[ t ].visits == hierarchic.visits) )
+    {
+      std::cerr << "Error: concurrent hierarchic traversal on thread " << t << " of " << numThreads
+                << " differs from the serial one." << std::endl;
+      success = false;
+    }
+  }
+
+  // the instances released by the threads must not disturb this thread
+  Recorder< ElementInfo > again;
+  mesh.leafTraverse( again );
+  if( !(again.visits == leaf.visits) )
+  {
+    std::cerr << "Error: serial leaf traversal changed after the concurrent ones." << std::endl;
+    success = false;
+  }
+  return success;
+}
+
+
+int main ( int argc, char **argv )
+try
+{
+  Dune::MPIHelper::instance( argc, argv );
+
+  const int dim = ALBERTA_DIM;
+  typedef Dune::AlbertaGrid< dim, dim > Grid;
+  typedef Grid::Codim< 0 >::LeafIterator LeafIterator;
+
+  Dune::FieldVector< Grid::ctype, dim > lower( 0 ), upper( 1 );
+  Dune::array< unsigned int, dim > elements;
+  elements.fill( 4 );
+  Dune::shared_ptr< Grid > grid = Dune::StructuredGridFactory< Grid >::createSimplexGrid( lower, upper, elements );
+  grid->globalRefine( 1 );
+
+  // refine near the origin, so the macro elements carry different numbers of elements
+  for( int i = 0; i < 2*dim; ++i )
+  {
+    const LeafIterator end = grid->leafend< 0 >();
+    for( LeafIterator it = grid->leafbegin< 0 >(); it != end; ++it )
+    {
+      if( it->geometry().center().two_norm() < 0.3 )
+        grid->mark( 1, *it );
+    }
+    grid->preAdapt();
+    grid->adapt();
+    grid->postAdapt();
+  }
+
+  bool success = true;
+  const unsigned int threads[] = { 1, 2, 3, 5 };
+  for( int i = 0; i < 4; ++i )
+  {
+    success &= checkParallelTraversal( grid->meshPointer(), threads[ i ] );
+    success &= checkConcurrentTraversal( grid->meshPointer(), threads[ i ] );
+  }
+
+  return (success ? 0 : 1);
+}
+catch( const Dune::Exception &e )
+{
+  std::cerr << e << std::endl;
+  return 1;
+}
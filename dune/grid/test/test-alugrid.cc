@@ -7,9 +7,13 @@
 
 #define DISABLE_DEPRECATED_METHOD_CHECK 1
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include <dune/common/tupleutility.hh>
 #include <dune/common/tuples.hh>
@@ -17,6 +21,8 @@
 
 #include <dune/grid/io/file/dgfparser/dgfalu.hh>
 #include <dune/grid/io/file/dgfparser/dgfwriter.hh>
+#include <dune/grid/alugrid/common/backuprestore.hh>
+#include <dune/grid/io/file/checkpointfile.hh>
 
 #include "gridcheck.hh"
 
@@ -500,6 +506,332 @@ void checkALUSerial(GridType & grid, int mxl = 2, const bool display = false)
   std::cout << std::endl << std::endl;
 }
 
+// ALUGrid of the unit cube whose vertices are moved by a smooth distortion,
+// so the hexahedra are not affine unless amplitude is zero
+template <class GridType>
+GridType *createDistortedCubeGrid( int cells, double amplitude )
+{
+  GridFactory< GridType > factory;
+  for( int k = 0; k <= cells; ++k )
+    for( int j = 0; j <= cells; ++j )
+      for( int i = 0; i <= cells; ++i )
+      {
+        FieldVector< double, 3 > x;
+        x[ 0 ] = double( i ) / cells;
+        x[ 1 ] = double( j ) / cells;
+        x[ 2 ] = double( k ) / cells;
+        FieldVector< double, 3 > y( x );
+        y[ 0 ] += amplitude * std::sin( M_PI * x[ 1 ] + 2.0 * x[ 2 ] );
+        y[ 1 ] += amplitude * std::sin( M_PI * x[ 2 ] + x[ 0 ] );
+        y[ 2 ] += amplitude * std::sin( M_PI * x[ 0 ] + 3.0 * x[ 1 ] );
+        factory.insertVertex( y );
+      }
+
+  std::vector< unsigned int > vertices( 8 );
+  for( int k = 0; k < cells; ++k )
+    for( int j = 0; j < cells; ++j )
+      for( int i = 0; i < cells; ++i )
+      {
+        for( int c = 0; c < 8; ++c )
+          vertices[ c ] = (i + (c & 1)) + (cells+1) * ((j + ((c >> 1) & 1)) + (cells+1) * (k + ((c >> 2) & 1)));
+        factory.insertElement( GeometryType( GeometryType::cube, 3 ), vertices );
+      }
+  return factory.createGrid();
+}
+
+// count a difference between a batched and a pointwise result
+int compareBatched( const char *what, const int point, const double batched, const double expected,
+                    const double tolerance = 1e-10 )
+{
+  if( std::abs( batched - expected ) <= tolerance * std::max( 1.0, std::abs( expected ) ) )
+    return 0;
+  std::cerr << "Error: batched " << what << " in point " << point << " is " << batched
+            << " instead of " << expected << std::endl;
+  return 1;
+}
+
+// compare the batched evaluation of the trilinear element and bilinear face
+// mappings with their evaluation point by point and with the geometries
+template <class GridType>
+void checkALU3dMappings( const GridType &grid )
+{
+  typedef typename GridType :: LeafGridView GridView;
+  typedef typename GridView :: template Codim< 0 > :: Iterator Iterator;
+  typedef typename GridView :: IntersectionIterator IntersectionIterator;
+  typedef typename Iterator :: Entity :: Geometry Geometry;
+  typedef typename IntersectionIterator :: Intersection :: Geometry FaceGeometry;
+
+  typedef TrilinearMapping :: coord_t Coordinate;
+  typedef FieldVector< alu3d_ctype, 2 > FaceCoordinate;
+
+  // local points in [0,1]^3, their number is no multiple of a vector width
+  const int n = 13;
+  std::vector< alu3d_ctype > x( n ), y( n ), z( n );
+  for( int p = 0; p < n; ++p )
+  {
+    x[ p ] = std::fmod( 0.1 + 0.618 * p, 1.0 );
+    y[ p ] = std::fmod( 0.3 + 0.414 * p, 1.0 );
+    z[ p ] = std::fmod( 0.7 + 0.732 * p, 1.0 );
+  }
+
+  std::vector< alu3d_ctype > wx( n ), wy( n ), wz( n ), lx( n ), ly( n ), lz( n );
+  std::vector< alu3d_ctype > jit( 9*n ), det( n ), nx( n ), ny( n ), nz( n );
+
+  int errors = 0;
+  const GridView gridView = grid.leafGridView();
+  const Iterator end = gridView.template end< 0 >();
+  for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
+  {
+    const Geometry geometry = it->geometry();
+    const TrilinearMapping mapping( geometry.corner( 0 ), geometry.corner( 1 ), geometry.corner( 2 ), geometry.corner( 3 ),
+                                    geometry.corner( 4 ), geometry.corner( 5 ), geometry.corner( 6 ), geometry.corner( 7 ) );
+    mapping.map2world( n, &x[ 0 ], &y[ 0 ], &z[ 0 ], &wx[ 0 ], &wy[ 0 ], &wz[ 0 ] );
+    mapping.jacobianInverseTransposed( n, &x[ 0 ], &y[ 0 ], &z[ 0 ], &jit[ 0 ], &det[ 0 ] );
+    mapping.world2map( n, &wx[ 0 ], &wy[ 0 ], &wz[ 0 ], &lx[ 0 ], &ly[ 0 ], &lz[ 0 ] );
+
+    TrilinearMapping pointMapping( mapping );
+    for( int p = 0; p < n; ++p )
+    {
+      Coordinate local;
+      local[ 0 ] = x[ p ]; local[ 1 ] = y[ p ]; local[ 2 ] = z[ p ];
+
+      Coordinate global;
+      pointMapping.map2world( local, global );
+      const Coordinate geoGlobal = geometry.global( local );
+      const double batchedGlobal[ 3 ] = { wx[ p ], wy[ p ], wz[ p ] };
+      for( int i = 0; i < 3; ++i )
+      {
+        errors += compareBatched( "map2world", p, batchedGlobal[ i ], global[ i ] );
+        errors += compareBatched( "map2world (geometry)", p, batchedGlobal[ i ], geoGlobal[ i ] );
+      }
+
+      const TrilinearMapping :: mat_t jacobian = pointMapping.jacobianInverseTransposed( local );
+      const typename Geometry :: JacobianInverseTransposed &geoJacobian = geometry.jacobianInverseTransposed( local );
+      for( int r = 0; r < 3; ++r )
+        for( int c = 0; c < 3; ++c )
+        {
+          errors += compareBatched( "jacobianInverseTransposed", p, jit[ (3*r+c)*n + p ], jacobian[ r ][ c ] );
+          errors += compareBatched( "jacobianInverseTransposed (geometry)", p, jit[ (3*r+c)*n + p ], geoJacobian[ r ][ c ] );
+        }
+      errors += compareBatched( "det", p, det[ p ], pointMapping.det( local ) );
+      errors += compareBatched( "det (geometry)", p, det[ p ], geometry.integrationElement( local ) );
+
+      // world2map iterates for non-affine elements
+      const double batchedLocal[ 3 ] = { lx[ p ], ly[ p ], lz[ p ] };
+      for( int i = 0; i < 3; ++i )
+        errors += compareBatched( "world2map", p, batchedLocal[ i ], local[ i ], 1e-8 );
+    }
+
+    const IntersectionIterator iend = gridView.iend( *it );
+    for( IntersectionIterator iit = gridView.ibegin( *it ); iit != iend; ++iit )
+    {
+      const FaceGeometry faceGeometry = iit->geometry();
+      const BilinearSurfaceMapping face( faceGeometry.corner( 0 ), faceGeometry.corner( 1 ),
+                                         faceGeometry.corner( 2 ), faceGeometry.corner( 3 ) );
+      face.map2world( n, &x[ 0 ], &y[ 0 ], &wx[ 0 ], &wy[ 0 ], &wz[ 0 ] );
+      face.det( n, &x[ 0 ], &y[ 0 ], &det[ 0 ] );
+      face.normal( n, &x[ 0 ], &y[ 0 ], &nx[ 0 ], &ny[ 0 ], &nz[ 0 ] );
+
+      for( int p = 0; p < n; ++p )
+      {
+        FaceCoordinate local;
+        local[ 0 ] = x[ p ]; local[ 1 ] = y[ p ];
+
+        Coordinate global, normal;
+        face.map2world( local, global );
+        face.normal( local, normal );
+        const Coordinate geoGlobal = faceGeometry.global( local );
+        const double batchedGlobal[ 3 ] = { wx[ p ], wy[ p ], wz[ p ] };
+        const double batchedNormal[ 3 ] = { nx[ p ], ny[ p ], nz[ p ] };
+        for( int i = 0; i < 3; ++i )
+        {
+          errors += compareBatched( "face map2world", p, batchedGlobal[ i ], global[ i ] );
+          errors += compareBatched( "face map2world (geometry)", p, batchedGlobal[ i ], geoGlobal[ i ] );
+          errors += compareBatched( "face normal", p, batchedNormal[ i ], normal[ i ] );
+        }
+        errors += compareBatched( "face det", p, det[ p ], face.det( local ) );
+      }
+    }
+  }
+
+  if( errors > 0 )
+    DUNE_THROW( GridError, errors << " batched mapping evaluations differ from the pointwise ones" );
+}
+
+// compare the leaf vertex list kept up to date during adaptation with a
+// list built from scratch
+template <class GridType>
+void compareLeafVertexList( const GridType &grid, const std::string &step )
+{
+  typedef typename std::remove_reference< decltype( grid.getLeafVertexList() ) >::type LeafVertexListType;
+  typedef typename LeafVertexListType :: VertexListType VertexListType;
+  typedef typename LeafVertexListType :: ItemType ItemType;
+
+  const VertexListType &list = grid.getLeafVertexList().getItemList();
+
+  LeafVertexListType rebuilt;
+  rebuilt.setupVxList( grid );
+  const VertexListType &expected = rebuilt.getItemList();
+
+  // entries beyond the end of a list are empty
+  const ItemType empty( (typename ItemType :: first_type) 0, -1 );
+  int errors = 0;
+  for( size_t i = 0; i < std::max( list.size(), expected.size() ); ++i )
+  {
+    const ItemType &item = (i < list.size() ? list[ i ] : empty);
+    const ItemType &expectedItem = (i < expected.size() ? expected[ i ] : empty);
+    if( (item.first != expectedItem.first) || (item.second != expectedItem.second) )
+    {
+      std::cerr << "Error: leaf vertex list entry " << i << " after " << step << " has level " << item.second
+                << " instead of " << expectedItem.second << std::endl;
+      ++errors;
+    }
+  }
+
+  if( errors > 0 )
+    DUNE_THROW( GridError, errors << " entries of the leaf vertex list differ after " << step );
+}
+
+template <class GridType>
+void adaptLeafVertexList( GridType &grid, const int refineEvery, const int coarsenEvery )
+{
+  typedef typename GridType :: template Codim< 0 > :: LeafIterator LeafIterator;
+
+  int nr = 0;
+  const LeafIterator end = grid.template leafend< 0 >();
+  for( LeafIterator it = grid.template leafbegin< 0 >(); it != end; ++it, ++nr )
+  {
+    if( refineEvery > 0 && nr % refineEvery == 0 )
+      grid.mark( 1, *it );
+    else if( coarsenEvery > 0 && nr % coarsenEvery == 0 )
+      grid.mark( -1, *it );
+  }
+
+  grid.preAdapt();
+  grid.adapt();
+  grid.postAdapt();
+}
+
+// the leaf vertex list is updated incrementally during refinement and
+// rebuilt after coarsening; both have to match a list built from scratch
+template <class GridType>
+void checkLeafVertexList( GridType &grid )
+{
+  // make sure the list is up to date, so the next refinement is tracked
+  grid.getLeafVertexList();
+  const unsigned long rebuilds = grid.leafVertexListStatistics().rebuilds;
+
+  adaptLeafVertexList( grid, 3, 0 );
+  adaptLeafVertexList( grid, 5, 0 );
+  compareLeafVertexList( grid, "refinement" );
+  if( grid.leafVertexListStatistics().rebuilds != rebuilds )
+    DUNE_THROW( GridError, "Leaf vertex list has been rebuilt after refinement" );
+
+  adaptLeafVertexList( grid, 0, 1 );
+  compareLeafVertexList( grid, "coarsening" );
+
+  adaptLeafVertexList( grid, 4, 3 );
+  compareLeafVertexList( grid, "refinement and coarsening" );
+
+  adaptLeafVertexList( grid, 2, 0 );
+  compareLeafVertexList( grid, "refinement after coarsening" );
+}
+
+// write a binary checkpoint with attached user data and restore it
+template <class GridType>
+void checkCheckpointFile( const GridType &grid )
+{
+  typedef typename GridType :: CollectiveCommunication Comm;
+  typedef typename GridType :: template Codim< 0 > :: LeafIterator LeafIterator;
+
+  PersistentContainer< GridType, double > data( grid, 0 );
+  {
+    const LeafIterator end = grid.template leafend< 0 >();
+    for( LeafIterator it = grid.template leafbegin< 0 >(); it != end; ++it )
+      data[ *it ] = it->geometry().center()[ 0 ];
+  }
+
+  CheckpointFileWriter< Comm > writer( "alucheckpoint", grid.comm() );
+  BackupRestoreFacility< GridType > :: backup( grid, writer );
+  writer.writeRange( data );
+  writer.close();
+
+  CheckpointFileReader< Comm > reader( "alucheckpoint", grid.comm() );
+  GridType *restored = BackupRestoreFacility< GridType > :: restore( reader );
+  PersistentContainer< GridType, double > restoredData( *restored, 0 );
+  reader.readRange( restoredData );
+  if( !reader.eof() )
+    DUNE_THROW( GridError, "Checkpoint file contains unread data" );
+
+  if( restored->maxLevel() != grid.maxLevel() )
+    DUNE_THROW( GridError, "Restored grid has maximum level " << restored->maxLevel() << " instead of " << grid.maxLevel() );
+  for( int codim = 0; codim <= GridType :: dimension; ++codim )
+  {
+    if( restored->size( codim ) != grid.size( codim ) )
+      DUNE_THROW( GridError, "Restored grid has " << restored->size( codim ) << " leaf entities of codim " << codim
+                                                  << " instead of " << grid.size( codim ) );
+  }
+
+  const LeafIterator end = restored->template leafend< 0 >();
+  for( LeafIterator it = restored->template leafbegin< 0 >(); it != end; ++it )
+  {
+    if( std::abs( restoredData[ *it ] - it->geometry().center()[ 0 ] ) > 1e-12 )
+      DUNE_THROW( GridError, "Error in restoring user data from checkpoint file" );
+  }
+  delete restored;
+}
+
+// sorted indices of the leaf elements of a partition
+template <class GridType, PartitionIteratorType pitype>
+std::vector< int > leafElementIndices( const GridType &grid, const bool interiorOnly )
+{
+  typedef typename GridType :: LeafGridView GridView;
+  typedef typename GridView :: template Codim< 0 > :: template Partition< pitype > :: Iterator Iterator;
+
+  const GridView gridView = grid.leafGridView();
+  std::vector< int > indices;
+  const Iterator end = gridView.template end< 0, pitype >();
+  for( Iterator it = gridView.template begin< 0, pitype >(); it != end; ++it )
+  {
+    if( !interiorOnly || (it->partitionType() == InteriorEntity) )
+      indices.push_back( gridView.indexSet().index( *it ) );
+  }
+  std::sort( indices.begin(), indices.end() );
+  return indices;
+}
+
+template <class GridType>
+void compareInteriorLeafIterator( const GridType &grid, const std::string &step )
+{
+  const std::vector< int > interior = leafElementIndices< GridType, Interior_Partition >( grid, false );
+  if( interior != leafElementIndices< GridType, Interior_Partition >( grid, true ) )
+    DUNE_THROW( GridError, "Interior leaf iterator visits non-interior elements after " << step );
+  if( interior != leafElementIndices< GridType, InteriorBorder_Partition >( grid, true ) )
+    DUNE_THROW( GridError, "Interior leaf iterator differs from the filtered InteriorBorder iterator after " << step );
+  if( interior != leafElementIndices< GridType, All_Partition >( grid, true ) )
+    DUNE_THROW( GridError, "Interior leaf iterator differs from the filtered All iterator after " << step );
+}
+
+// the interior leaf iterator runs over a cached element list, which has to
+// follow adaptation and load balancing
+template <class GridType>
+void checkInteriorLeafIterator( GridType &grid )
+{
+  compareInteriorLeafIterator( grid, "construction" );
+
+  adaptLeafVertexList( grid, 3, 0 );
+  compareInteriorLeafIterator( grid, "refinement" );
+
+  adaptLeafVertexList( grid, 0, 2 );
+  compareInteriorLeafIterator( grid, "coarsening" );
+
+  grid.loadBalance();
+  compareInteriorLeafIterator( grid, "load balancing" );
+
+  adaptLeafVertexList( grid, 2, 0 );
+  compareInteriorLeafIterator( grid, "refinement after load balancing" );
+}
+
 template <class GridType>
 void checkALUParallel(GridType & grid, int gref, int mxl = 3)
 {
@@ -654,6 +986,9 @@ int main (int argc , char **argv) {
         checkCapabilities< false >( *gridPtr );
         checkALUSerial(*gridPtr, 2, display);
 
+        std::cout << "  CHECKING: checkpoint file" << std::endl;
+        checkCheckpointFile( *gridPtr );
+
         //CircleBoundaryProjection<2> bndPrj;
         //GridType grid("alu2d.triangle", &bndPrj );
         //checkALUSerial(grid,2);
@@ -715,6 +1050,32 @@ int main (int argc , char **argv) {
                          (mysize == 1) ? display : false);
         }
 
+        if (myrank == 0) std::cout << "Check checkpoint file" << std::endl;
+        checkCheckpointFile( grid );
+
+        if (myrank == 0) std::cout << "Check interior leaf iterator" << std::endl;
+        {
+          GridPtr< GridType > interiorGridPtr( filename );
+          checkInteriorLeafIterator( *interiorGridPtr );
+        }
+
+        // the batched mappings and the leaf vertex list on affine and
+        // distorted, locally refined grids
+        if( mysize == 1 )
+        {
+          std::cout << "  CHECKING: batched mappings" << std::endl;
+          const double amplitudes[ 2 ] = { 0.0, 0.04 };
+          for( int i = 0; i < 2; ++i )
+          {
+            GridType *distortedGrid = createDistortedCubeGrid< GridType >( 3, amplitudes[ i ] );
+            makeNonConfGrid( *distortedGrid, 1, 1 );
+            checkALU3dMappings( *distortedGrid );
+            std::cout << "  CHECKING: leaf vertex list" << std::endl;
+            checkLeafVertexList( *distortedGrid );
+            delete distortedGrid;
+          }
+        }
+
         // perform parallel check only when more then one proc
         if(mysize > 1)
         {
@@ -10,6 +10,12 @@
   #define GCCPOOL
 #endif
 
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
 #include <dune/common/timer.hh>
 
 #include <dune/common/poolallocator.hh>
@@ -114,6 +120,146 @@ void test(const std::string& gridfile)
 
 }
 
+
+// WarpedCoordFunction
+// -------------------
+
+// nonlinear analytical coordinate function counting its evaluations
+template< class ctype, unsigned int dim >
+class WarpedCoordFunction
+  : public Dune::AnalyticalCoordFunction< ctype, dim, dim, WarpedCoordFunction< ctype, dim > >
+{
+  typedef WarpedCoordFunction< ctype, dim > This;
+  typedef Dune::AnalyticalCoordFunction< ctype, dim, dim, This > Base;
+
+public:
+  typedef typename Base::DomainVector DomainVector;
+  typedef typename Base::RangeVector RangeVector;
+
+  WarpedCoordFunction () : evaluations_( 0 ) {}
+
+  void evaluate ( const DomainVector &x, RangeVector &y ) const
+  {
+    ++evaluations_;
+    y = x;
+    for( unsigned int i = 0; i < dim; ++i )
+      y[ i ] += 0.1 * std::sin( M_PI * x[ (i+1) % dim ] );
+  }
+
+  std::size_t evaluations () const { return evaluations_; }
+
+private:
+  mutable std::atomic< std::size_t > evaluations_;
+};
+
+
+// compare two cached coordinate functions on the corners of all levels
+template< class HostGrid, class CachedA, class CachedB >
+bool compareCachedCoordFunctions ( const HostGrid &hostGrid, const CachedA &a, const CachedB &b )
+{
+  typedef typename HostGrid::LevelGridView LevelView;
+  typedef typename LevelView::template Codim< 0 >::Iterator Iterator;
+
+  for( int level = 0; level <= hostGrid.maxLevel(); ++level )
+  {
+    const LevelView view = hostGrid.levelGridView( level );
+    const Iterator end = view.template end< 0 >();
+    for( Iterator it = view.template begin< 0 >(); it != end; ++it )
+    {
+      const int corners = it->geometry().corners();
+      for( int i = 0; i < corners; ++i )
+      {
+        typename CachedA::RangeVector ya;
+        typename CachedB::RangeVector yb;
+        a.evaluate( *it, i, ya );
+        b.evaluate( *it, i, yb );
+        if( (ya - yb).two_norm() > 1e-12 )
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+void checkCachedCoordFunction ( const std::string &gridfile )
+{
+  typedef WarpedCoordFunction< Grid::ctype, Grid::dimensionworld > Function;
+  typedef Dune::CachedCoordFunction< Grid, Function > CachedFunction;
+  typedef Dune::GeoGrid::CoordCacheBuilder< Function::Interface > CacheBuilder;
+  typedef Grid::LeafGridView::Codim< 0 >::Iterator LeafIterator;
+  typedef Grid::LeafGridView::Codim< Grid::dimension >::Iterator LeafVertexIterator;
+
+  Dune::GridPtr< Grid > pgrid( gridfile );
+  Grid &hostGrid = *pgrid;
+
+  // make sure each chunk is split between several threads
+  while( std::size_t( hostGrid.comm().min( hostGrid.size( Grid::dimension ) ) ) <= 2*CacheBuilder::chunkSize )
+    hostGrid.globalRefine( 1 );
+
+  // batched evaluation has to coincide with the pointwise one
+  std::vector< Function::DomainVector > x;
+  const LeafVertexIterator vend = hostGrid.leafGridView().end< Grid::dimension >();
+  for( LeafVertexIterator it = hostGrid.leafGridView().begin< Grid::dimension >(); it != vend; ++it )
+    x.push_back( it->geometry().corner( 0 ) );
+
+  Function function;
+  std::vector< Function::RangeVector > y;
+  function.evaluateBatch( x, y );
+  if( y.size() != x.size() )
+    DUNE_THROW( Dune::GridError, "evaluateBatch returned " << y.size() << " values for " << x.size() << " points." );
+  for( std::size_t i = 0; i < x.size(); ++i )
+  {
+    Function::RangeVector z;
+    function.evaluate( x[ i ], z );
+    if( (y[ i ] - z).two_norm() > 1e-12 )
+      DUNE_THROW( Dune::GridError, "evaluateBatch differs from evaluate in point " << x[ i ] << "." );
+  }
+
+  CachedFunction serial( hostGrid, function );
+  CachedFunction threaded( hostGrid, function, 3 );
+  if( !compareCachedCoordFunctions( hostGrid, serial, threaded ) )
+    DUNE_THROW( Dune::GridError, "CachedCoordFunction filled by 3 threads differs from the serial one." );
+
+  // refine locally and globally, updating the caches after each adaptation
+  const LeafIterator end = hostGrid.leafGridView().end< 0 >();
+  for( LeafIterator it = hostGrid.leafGridView().begin< 0 >(); it != end; ++it )
+  {
+    if( it->geometry().center()[ 0 ] < 0.5 )
+      hostGrid.mark( 1, *it );
+  }
+  hostGrid.preAdapt();
+  hostGrid.adapt();
+  hostGrid.postAdapt();
+  serial.adapt();
+  threaded.adapt();
+
+  hostGrid.globalRefine( 1 );
+  const std::size_t start = function.evaluations();
+  serial.adapt();
+  const std::size_t incremental = function.evaluations() - start;
+  threaded.adapt();
+
+  // the evaluation counts have to be taken before comparing, because the
+  // debug check in CachedCoordFunction::evaluate calls the function, too
+  const std::size_t freshStart = function.evaluations();
+  CachedFunction fresh( hostGrid, function );
+  const std::size_t full = function.evaluations() - freshStart;
+
+  const std::size_t rebuildStart = function.evaluations();
+  threaded.buildCache();
+  const std::size_t rebuild = function.evaluations() - rebuildStart;
+
+  if( incremental >= full )
+    DUNE_THROW( Dune::GridError, "CachedCoordFunction::adapt evaluated " << incremental << " corners, a fresh cache only needs " << full << "." );
+  if( rebuild != full )
+    DUNE_THROW( Dune::GridError, "CachedCoordFunction::buildCache evaluated " << rebuild << " corners instead of " << full << "." );
+  if( !compareCachedCoordFunctions( hostGrid, serial, fresh ) )
+    DUNE_THROW( Dune::GridError, "Incrementally updated CachedCoordFunction differs from a fresh one." );
+  if( !compareCachedCoordFunctions( hostGrid, threaded, fresh ) )
+    DUNE_THROW( Dune::GridError, "Rebuilt CachedCoordFunction differs from a fresh one." );
+}
+
 int main ( int argc, char **argv )
 try
 {
@@ -149,6 +295,9 @@ try
   test<GeometryGridWithDebugAllocator>(gridfile);
   std::cout << "=== GeometryGridWithDebugAllocator took " << watch.elapsed() << " seconds\n";
 
+  std::cerr << "Checking CachedCoordFunction..." << std::endl;
+  checkCachedCoordFunction( gridfile );
+
   return 0;
 }
 catch( const Dune::Exception &e )
@@ -5,6 +5,7 @@
 #include <array>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
@@ -27,11 +28,11 @@ class UnitCube< Dune::YaspGrid< dimension > >
 public:
   typedef Dune::YaspGrid< dimension > Grid;
 
-  static std::unique_ptr< Grid > create ()
+  static std::unique_ptr< Grid > create ( int macroCells = 1 )
   {
     Dune::FieldVector< double, dimension > domain( 1. );
     std::array< int, dimension > cells;
-    cells.fill( 1 );
+    cells.fill( macroCells );
     return Dune::Std::make_unique< Grid >( domain, cells );
   }
 };
@@ -53,12 +54,25 @@ void check ( GridView gridView )
   typedef typename GridView::template Codim< 0 >::Iterator Iterator;
   typedef typename Iterator::Entity Entity;
 
+  std::vector< typename Entity::Geometry::GlobalCoordinate > centers;
   const Iterator end = gridView.template end< 0 >();
   for( Iterator it = gridView.template begin< 0 >(); it != end; ++it )
   {
     const Entity &entity = *it;
     if( entity != hsearch.findEntity( entity.geometry().center() ) )
       DUNE_THROW( Dune::GridError, "Could not retrieve element in hierarchic search" );
+    centers.push_back( entity.geometry().center() );
+  }
+
+  // batched search has to return the elements in the order of the points
+  const std::vector< Entity > entities = hsearch.findEntities( centers );
+  if( entities.size() != centers.size() )
+    DUNE_THROW( Dune::GridError, "Batched hierarchic search returned wrong number of elements" );
+  std::size_t i = 0;
+  for( Iterator it = gridView.template begin< 0 >(); it != end; ++it, ++i )
+  {
+    if( *it != entities[ i ] )
+      DUNE_THROW( Dune::GridError, "Could not retrieve element in batched hierarchic search" );
   }
 }
 
@@ -85,6 +99,13 @@ try
     check( grid->levelGridView( level ) );
   check( grid->leafGridView() );
 
+  // check hierarchic search on a macro grid with several elements
+  auto macroGrid = UnitCube< Grid >::create( 5 );
+  macroGrid->globalRefine( 2 );
+  for( int level = 0; level < macroGrid->maxLevel(); ++level )
+    check( macroGrid->levelGridView( level ) );
+  check( macroGrid->leafGridView() );
+
   return 0;
 }
 catch( Dune::Exception &exception )
@@ -4,6 +4,9 @@
 #include <config.h>
 
 #include <iostream>
+#include <vector>
+
+#include <dune/common/array.hh>
 
 #include <dune/grid/sgrid.hh>
 
@@ -12,6 +15,53 @@
 #include "checkintersectionit.hh"
 #include "checkpartition.hh"
 
+// check that CubeMapper::n is a bijection from the expanded coordinates of each
+// codimension onto [0, elements(codim)) and that CubeMapper::z inverts it
+template<int d>
+void checkCubeMapper(const Dune::array<int,d>& N)
+{
+  std::cout << "CubeMapper<" << d << "> with N =";
+  for (int i=0; i<d; i++) std::cout << " " << N[i];
+  std::cout << std::endl;
+
+  Dune::CubeMapper<d> mapper;
+  mapper.make(N);
+
+  std::vector<std::vector<bool> > seen(d+1);
+  for (int c=0; c<=d; c++)
+    seen[c].resize(mapper.elements(c), false);
+
+  // walk all expanded coordinates z in [0,2N_0] x ... x [0,2N_{d-1}]
+  Dune::array<int,d> z;
+  z.fill(0);
+  while (true)
+  {
+    const int c = mapper.codim(z);
+    const int i = mapper.n(z);
+    if (i < 0 || i >= mapper.elements(c))
+      DUNE_THROW(Dune::GridError, "CubeMapper number " << i << " out of range for codim " << c);
+    if (seen[c][i])
+      DUNE_THROW(Dune::GridError, "CubeMapper number " << i << " of codim " << c << " assigned twice");
+    seen[c][i] = true;
+    if (mapper.z(i,c) != z)
+      DUNE_THROW(Dune::GridError, "CubeMapper::z does not invert CubeMapper::n for number " << i
+                 << " of codim " << c);
+
+    int k = 0;
+    for (; k<d; k++)
+    {
+      if (++z[k] <= 2*N[k]) break;
+      z[k] = 0;
+    }
+    if (k == d) break;
+  }
+
+  for (int c=0; c<=d; c++)
+    for (int i=0; i<mapper.elements(c); i++)
+      if (!seen[c][i])
+        DUNE_THROW(Dune::GridError, "CubeMapper number " << i << " of codim " << c << " not assigned");
+}
+
 template<int d, int w>
 void runtest()
 {
@@ -34,6 +84,15 @@ void runtest()
 
 int main () {
   try {
+    {
+      Dune::array<int,1> N1 = {{ 3 }};
+      checkCubeMapper<1>(N1);
+      Dune::array<int,2> N2 = {{ 3, 2 }};
+      checkCubeMapper<2>(N2);
+      Dune::array<int,3> N3 = {{ 3, 1, 4 }};
+      checkCubeMapper<3>(N3);
+    }
+
     runtest<1,1>();
     runtest<2,2>();
     runtest<3,3>();
@@ -3,6 +3,7 @@
 
 #include <config.h>
 
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -10,6 +11,7 @@
 #include <dune/common/parallel/mpihelper.hh>
 #include <dune/grid/yaspgrid.hh>
 #include <dune/grid/yaspgrid/backuprestore.hh>
+#include <dune/grid/utility/persistentcontainer.hh>
 #include <dune/grid/utility/tensorgridfactory.hh>
 
 #include "gridcheck.hh"
@@ -88,6 +90,230 @@ struct YaspFactory<dim, Dune::TensorProductCoordinates<double,dim> >
   }
 };
 
+template <int dim, class CC>
+void check_findentity(const Dune::YaspGrid<dim,CC>& grid)
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+  typedef typename Grid::template Codim<0>::Entity Entity;
+  typedef Dune::FieldVector<double,dim> Coordinate;
+
+  const GridView gv = grid.leafGridView();
+
+  std::vector<Coordinate> points;
+  const Iterator end = gv.template end<0>();
+  for (Iterator it = gv.template begin<0>(); it != end; ++it)
+  {
+    Coordinate local;
+    const Entity e = grid.findEntity(it->geometry().center(),local);
+    if (e != *it)
+      DUNE_THROW(Dune::GridError, "findEntity did not return the element containing its center");
+    Coordinate diff = local;
+    diff -= Coordinate(0.5);
+    if (diff.two_norm() > 1e-8)
+      DUNE_THROW(Dune::GridError, "findEntity returned wrong local coordinate " << local);
+    points.push_back(it->geometry().corner(0));
+  }
+
+  std::vector<Entity> entities;
+  std::vector<Coordinate> locals;
+  grid.findEntities(points,entities,locals);
+  for (std::size_t i=0; i<points.size(); i++)
+  {
+    Coordinate diff = entities[i].geometry().global(locals[i]);
+    diff -= points[i];
+    if (diff.two_norm() > 1e-8)
+      DUNE_THROW(Dune::GridError, "findEntities returned wrong element or local coordinate");
+  }
+}
+
+template <int dim, class CC>
+void check_subindices(const Dune::YaspGrid<dim,CC>& grid)
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  typedef typename Grid::LeafGridView GridView;
+  typedef typename GridView::template Codim<0>::Iterator Iterator;
+
+  const GridView gv = grid.leafGridView();
+  const typename GridView::IndexSet& indexSet = gv.indexSet();
+
+  std::vector<unsigned int> indices;
+  const Iterator end = gv.template end<0>();
+  for (Iterator it = gv.template begin<0>(); it != end; ++it)
+    for (int codim=0; codim<=dim; codim++)
+    {
+      indices.assign(it->subEntities(codim),0);
+      indexSet.subIndices(*it,codim,indices.begin());
+      for (std::size_t i=0; i<indices.size(); i++)
+        if (indices[i] != indexSet.subIndex(*it,i,codim))
+          DUNE_THROW(Dune::GridError, "subIndices and subIndex differ for subentity "
+                     << i << " of codim " << codim);
+    }
+}
+
+// advance a coordinate to the next entity of an index box in iteration order
+template <int dim>
+void next_in_box(const Dune::YaspIndexBox<dim>& box, Dune::array<int,dim>& coord)
+{
+  for (int i=0; i<dim; i++)
+  {
+    if (++coord[i] < box.origin[i] + box.size[i])
+      return;
+    coord[i] = box.origin[i];
+  }
+}
+
+// the entities are iterated box by box with direction 0 running fastest
+template <int dim, class CC, int codim, Dune::PartitionIteratorType pitype>
+void check_indexboxes_codim(const Dune::YaspGrid<dim,CC>& grid, int level)
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  typedef typename Grid::LevelGridView GridView;
+  typedef typename GridView::template Codim<codim>::template Partition<pitype>::Iterator Iterator;
+
+  const GridView gv = grid.levelGridView(level);
+  const std::vector<Dune::YaspIndexBox<dim> > boxes = grid.template indexBoxes<pitype>(level,codim);
+
+  Iterator it = gv.template begin<codim,pitype>();
+  const Iterator end = gv.template end<codim,pitype>();
+  for (std::size_t k=0; k<boxes.size(); k++)
+  {
+    Dune::array<int,dim> coord = boxes[k].origin;
+    for (int j=0; j<boxes[k].totalsize(); j++, ++it)
+    {
+      if (it == end)
+        DUNE_THROW(Dune::GridError, "index boxes of codim " << codim << " contain too many entities");
+      if (boxes[k].index(coord) != int(gv.indexSet().index(*it)))
+        DUNE_THROW(Dune::GridError, "index box of codim " << codim << " yields wrong index");
+      next_in_box(boxes[k],coord);
+    }
+  }
+  if (it != end)
+    DUNE_THROW(Dune::GridError, "index boxes do not cover all entities of codim " << codim);
+}
+
+template <int dim, class CC>
+void check_indexboxes(const Dune::YaspGrid<dim,CC>& grid)
+{
+  for (int level=0; level<=grid.maxLevel(); level++)
+  {
+    check_indexboxes_codim<dim,CC,0,Dune::All_Partition>(grid,level);
+    check_indexboxes_codim<dim,CC,0,Dune::Interior_Partition>(grid,level);
+    check_indexboxes_codim<dim,CC,dim,Dune::All_Partition>(grid,level);
+    check_indexboxes_codim<dim,CC,dim,Dune::Interior_Partition>(grid,level);
+
+    // the lower face of a cell in direction i has the coordinate of the cell
+    std::bitset<dim> cellshift;
+    cellshift.set();
+    const Dune::YaspIndexBox<dim> cells = grid.indexBox(level,cellshift);
+    const typename Dune::YaspGrid<dim,CC>::LevelGridView gv = grid.levelGridView(level);
+    Dune::array<int,dim> coord = cells.origin;
+    for (auto it = gv.template begin<0>(); it != gv.template end<0>(); ++it)
+    {
+      for (int i=0; i<dim; i++)
+      {
+        const Dune::YaspIndexBox<dim> faces = grid.indexBox(level,cellshift ^ std::bitset<dim>(1 << i));
+        const int lower = faces.index(coord);
+        if (lower != int(gv.indexSet().subIndex(*it,2*i,1))
+            || lower + faces.stride[i] != int(gv.indexSet().subIndex(*it,2*i+1,1)))
+          DUNE_THROW(Dune::GridError, "index box of faces yields wrong index");
+      }
+      next_in_box(cells,coord);
+    }
+  }
+}
+
+// data handle communicating one value per element
+class ElementDataHandle
+  : public Dune::CommDataHandleIF<ElementDataHandle,int>
+{
+public:
+  bool contains (int dim, int codim) const { return codim == 0; }
+  bool fixedsize (int dim, int codim) const { return true; }
+
+  template <class Entity>
+  std::size_t size (const Entity& e) const { return 1; }
+
+  template <class Buffer, class Entity>
+  void gather (Buffer& buf, const Entity& e) const { buf.write(1); }
+
+  template <class Buffer, class Entity>
+  void scatter (Buffer& buf, const Entity& e, std::size_t n) { int x; buf.read(x); }
+};
+
+// the communication lists are built on first use of a codimension and interface
+template <int dim, class CC>
+void check_commlists()
+{
+  typedef Dune::YaspGrid<dim,CC> Grid;
+  typedef Dune::YGridList<CC> List;
+
+  const Dune::InterfaceType iftypes[] = { Dune::InteriorBorder_InteriorBorder_Interface,
+                                          Dune::InteriorBorder_All_Interface,
+                                          Dune::Overlap_OverlapFront_Interface,
+                                          Dune::All_All_Interface };
+
+  Grid* grid = YaspFactory<dim,CC>::buildGrid();
+  Grid* reverse = YaspFactory<dim,CC>::buildGrid();
+  grid->globalRefine(1);
+  reverse->globalRefine(1);
+
+  for (int level=0; level<=grid->maxLevel(); level++)
+    for (int codim=0; codim<=dim; codim++)
+      if (grid->begin(level)->commListsBuilt[codim].any())
+        DUNE_THROW(Dune::GridError, "communication lists of codim " << codim << " built before their first use");
+
+  // communicating element data builds the lists of codim 0 for this interface only
+  const int maxLevel = grid->maxLevel();
+  const std::size_t before = grid->memoryUsage(maxLevel);
+  ElementDataHandle handle;
+  grid->communicate(handle,Dune::InteriorBorder_All_Interface,Dune::ForwardCommunication);
+  for (int codim=0; codim<=dim; codim++)
+    for (int i=0; i<4; i++)
+      if (grid->begin(maxLevel)->commListsBuilt[codim][i] != (codim == 0 && i == 1))
+        DUNE_THROW(Dune::GridError, "communicate built the wrong communication lists");
+
+  const List* send = 0;
+  const List* recv = 0;
+  grid->communicationLists(grid->begin(maxLevel),0,Dune::InteriorBorder_All_Interface,send,recv);
+  const std::size_t after = grid->memoryUsage(maxLevel);
+  if ((send->size() > 0 || recv->size() > 0) ? (after <= before) : (after != before))
+    DUNE_THROW(Dune::GridError, "memoryUsage does not account for the communication lists built");
+
+  // lists that have been built are not built again
+  const List* send2 = 0;
+  const List* recv2 = 0;
+  grid->communicationLists(grid->begin(maxLevel),0,Dune::InteriorBorder_All_Interface,send2,recv2);
+  if (send2 != send || recv2 != recv || grid->memoryUsage(maxLevel) != after)
+    DUNE_THROW(Dune::GridError, "communication lists have been built again");
+
+  // the lists do not depend on the order in which they are built
+  for (int level=0; level<=maxLevel; level++)
+  {
+    for (int codim=0; codim<=dim; codim++)
+      for (int i=0; i<4; i++)
+      {
+        grid->communicationLists(grid->begin(level),codim,iftypes[i],send,recv);
+        reverse->communicationLists(reverse->begin(level),dim-codim,iftypes[3-i],send2,recv2);
+      }
+
+    for (int codim=0; codim<=dim; codim++)
+      for (int i=0; i<4; i++)
+      {
+        grid->communicationLists(grid->begin(level),codim,iftypes[i],send,recv);
+        reverse->communicationLists(reverse->begin(level),codim,iftypes[i],send2,recv2);
+        if (send->size() != send2->size() || recv->size() != recv2->size())
+          DUNE_THROW(Dune::GridError, "communication lists of codim " << codim << " depend on the order of construction");
+      }
+    if (grid->memoryUsage(level) != reverse->memoryUsage(level))
+      DUNE_THROW(Dune::GridError, "memoryUsage of level " << level << " depends on the order of construction");
+  }
+
+  delete reverse;
+  delete grid;
+}
+
 template <int dim, class CC>
 void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   std::cout << std::endl << "YaspGrid<" << dim << ">";
@@ -95,6 +321,9 @@ void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   if (grid == NULL)
     grid = YaspFactory<dim,CC>::buildGrid();
 
+  // check the lazily built communication lists
+  check_commlists<dim,CC>();
+
   gridcheck(*grid);
   //grid->globalRefine(2);
 
@@ -117,6 +346,12 @@ void check_yasp(Dune::YaspGrid<dim,CC>* grid) {
   // check grid adaptation interface
   checkAdaptRefinement(*grid);
   checkPartitionType( grid->leafGridView() );
+  // check the analytic point location
+  check_findentity(*grid);
+  // check the bulk subentity index computation
+  check_subindices(*grid);
+  // check the index boxes of the structured entity blocks
+  check_indexboxes(*grid);
 
   std::ofstream file;
   std::ostringstream filename;
@@ -169,6 +404,32 @@ void check_backuprestore(Dune::YaspGrid<dim,CC>* grid)
      }
    }
 
+   // write a binary checkpoint with attached user data and restore it
+   typedef typename Grid::CollectiveCommunication Comm;
+   typedef typename Grid::LeafGridView::template Codim<0>::Iterator Iterator;
+   Dune::PersistentContainer<Grid,double> data(*grid, 0);
+   for (Iterator it = grid->leafGridView().template begin<0>(); it != grid->leafGridView().template end<0>(); ++it)
+     data[*it] = it->geometry().center()[0];
+
+   Dune::CheckpointFileWriter<Comm> writer("checkpoint", grid->comm());
+   Dune::BackupRestoreFacility<Grid>::backup(*grid, writer);
+   writer.writeRange(data);
+   writer.close();
+
+   Dune::CheckpointFileReader<Comm> reader("checkpoint", grid->comm());
+   Grid* checkpointed = Dune::BackupRestoreFacility<Grid>::restore(reader);
+   Dune::PersistentContainer<Grid,double> restoredData(*checkpointed, 0);
+   reader.readRange(restoredData);
+   if (!reader.eof())
+     DUNE_THROW(Dune::Exception, "Checkpoint file contains unread data");
+
+   if (checkpointed->size(0) != grid->size(0))
+     DUNE_THROW(Dune::Exception, "Error in binary BackupRestoreFacility");
+   for (Iterator it = checkpointed->leafGridView().template begin<0>(); it != checkpointed->leafGridView().template end<0>(); ++it)
+     if (std::abs(restoredData[*it] - it->geometry().center()[0]) > 1e-12)
+       DUNE_THROW(Dune::Exception, "Error in restoring user data from checkpoint file");
+   delete checkpointed;
+
    check_yasp(restored);
 
    delete grid;
@@ -114,6 +114,12 @@ DataHandle *Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::duneDataHandle_
 
 template <class DataHandle, int GridDim, int codim>
 int Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::level = -1;
+
+template <class DataHandle, int GridDim, int codim>
+std::size_t Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::gathered_ = 0;
+
+template <class DataHandle, int GridDim, int codim>
+std::size_t Dune::UGMessageBufferBase<DataHandle,GridDim,codim>::scattered_ = 0;
 #endif // ModelP
 
 namespace Dune {
@@ -711,15 +717,27 @@ namespace Dune {
       std::vector<typename UG_NS<dim>::DDD_IF> ugIfs;
       findDDDInterfaces_(ugIfs, iftype, codim);
 
+      // timings and message statistics, empty unless DUNE_GRID_COMM_PROFILING is set.
+      // DDD gathers, transfers and scatters in one call, so only the
+      // size computation is timed separately.
+      CommProfileScope profile("UGGrid",iftype,codim);
+
       unsigned bufSize = UGMsgBuf::ugBufferSize_(gv);
       if (!bufSize)
         return;     // we don't need to communicate if we don't have any data!
+
+      profile.phase(CommProfileData::exchangePhase);
       for (unsigned i=0; i < ugIfs.size(); ++i)
+      {
+        UGMsgBuf::gathered_ = UGMsgBuf::scattered_ = 0;
         UG_NS<dim>::DDD_IFOneway(ugIfs[i],
                                  ugIfDir,
                                  bufSize,
                                  &UGMsgBuf::ugGather_,
                                  &UGMsgBuf::ugScatter_);
+        profile.sent(UGMsgBuf::gathered_*bufSize);
+        profile.received(UGMsgBuf::scattered_*bufSize);
+      }
     }
 
     void findDDDInterfaces_(std::vector<typename UG_NS<dim>::DDD_IF > &dddIfaces,
@@ -7,6 +7,7 @@
 
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <dune/grid/common/commprofiler.hh>
 #include <dune/grid/common/gridenums.hh>
 
 namespace Dune {
@@ -73,6 +74,7 @@ namespace Dune {
         if (!duneDataHandle_->fixedsize(dim, codim))
           msgBuf.template writeRaw_<unsigned>(duneDataHandle_->size(entity));
         duneDataHandle_->gather(msgBuf, entity);
+        ++gathered_;
       }
 
       return 0;
@@ -103,6 +105,7 @@ namespace Dune {
           size = duneDataHandle_->template size<DuneMakeableEntity>(entity);
         if (size > 0)
           duneDataHandle_->template scatter<ThisType, DuneMakeableEntity>(msgBuf, entity, size);
+        ++scattered_;
 
       }
 
@@ -111,6 +114,10 @@ namespace Dune {
 
     static DataHandle *duneDataHandle_;
     static int level;
+    // number of entities packed and unpacked by the current DDD_IFOneway call;
+    // counted unconditionally so that the class does not depend on
+    // DUNE_GRID_COMM_PROFILING
+    static std::size_t gathered_, scattered_;
     char *ugData_;
   };
 
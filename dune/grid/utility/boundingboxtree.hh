@@ -0,0 +1,247 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_UTILITY_BOUNDINGBOXTREE_HH
+#define DUNE_GRID_UTILITY_BOUNDINGBOXTREE_HH
+
+/**
+   @file
+   @brief Axis-aligned bounding box tree for fast point queries
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+namespace Dune
+{
+
+  // BoundingBoxTree
+  // ---------------
+
+  /**
+   * \brief binary tree of axis-aligned bounding boxes
+   *
+   * The tree is built top-down from a list of bounding boxes by splitting the
+   * box centers at the median along the longest extent. Point queries visit
+   * all boxes containing the point in O(log n) expected time.
+   *
+   * \tparam  ct    coordinate field type
+   * \tparam  dimw  dimension of the coordinates
+   */
+  template< class ct, int dimw >
+  class BoundingBoxTree
+  {
+    typedef BoundingBoxTree< ct, dimw > This;
+
+  public:
+    //! type of coordinates
+    typedef FieldVector< ct, dimw > Coordinate;
+
+    //! type of bounding boxes (lower and upper corner)
+    typedef std::pair< Coordinate, Coordinate > BoundingBox;
+
+  private:
+    static const std::size_t invalid = std::numeric_limits< std::size_t >::max();
+    static const std::size_t leafSize = 4;
+    static const std::size_t maxDepth = 8*sizeof( std::size_t );
+
+    struct Node
+    {
+      BoundingBox box;
+      std::size_t begin, end;
+      std::size_t left, right;
+    };
+
+  public:
+    BoundingBoxTree () {}
+
+    explicit BoundingBoxTree ( std::vector< BoundingBox > boxes )
+    {
+      build( std::move( boxes ) );
+    }
+
+    /** \brief build the tree from a list of bounding boxes
+     *
+     *  The boxes are referenced by their position within the list.
+     */
+    void build ( std::vector< BoundingBox > boxes );
+
+    //! remove all boxes from the tree
+    void clear ()
+    {
+      nodes_.clear();
+      indices_.clear();
+      boxes_.clear();
+    }
+
+    //! return true if the tree contains no boxes
+    bool empty () const { return boxes_.empty(); }
+
+    //! return the number of boxes in the tree
+    std::size_t size () const { return boxes_.size(); }
+
+    //! return the i-th bounding box
+    const BoundingBox &box ( std::size_t i ) const { return boxes_[ i ]; }
+
+    //! return a bounding box containing all boxes of the tree
+    const BoundingBox &boundingBox () const
+    {
+      assert( !empty() );
+      return nodes_.front().box;
+    }
+
+    /** \brief visit all boxes containing a point
+     *
+     *  Calls f( i ) for the index i of each box containing x until f returns
+     *  true.
+     *
+     *  \returns true, if f returned true for some box
+     */
+    template< class F >
+    bool visit ( const Coordinate &x, F &&f ) const;
+
+    //! check whether a bounding box contains a point
+    static bool contains ( const BoundingBox &box, const Coordinate &x )
+    {
+      for( int k = 0; k < dimw; ++k )
+      {
+        if( (x[ k ] < box.first[ k ]) || (x[ k ] > box.second[ k ]) )
+          return false;
+      }
+      return true;
+    }
+
+  private:
+    std::size_t buildNode ( std::size_t begin, std::size_t end, const std::vector< Coordinate > &centers );
+
+    std::vector< Node > nodes_;
+    std::vector< std::size_t > indices_;
+    std::vector< BoundingBox > boxes_;
+  };
+
+
+
+  // Implementation of BoundingBoxTree
+  // ---------------------------------
+
+  template< class ct, int dimw >
+  inline void BoundingBoxTree< ct, dimw >::build ( std::vector< BoundingBox > boxes )
+  {
+    clear();
+    boxes_ = std::move( boxes );
+    if( boxes_.empty() )
+      return;
+
+    const std::size_t size = boxes_.size();
+    std::vector< Coordinate > centers( size );
+    indices_.resize( size );
+    for( std::size_t i = 0; i < size; ++i )
+    {
+      centers[ i ] = boxes_[ i ].first;
+      centers[ i ] += boxes_[ i ].second;
+      centers[ i ] *= ct( 1 ) / ct( 2 );
+      indices_[ i ] = i;
+    }
+
+    nodes_.reserve( 2*(size / leafSize) + 1 );
+    buildNode( 0, size, centers );
+  }
+
+
+  template< class ct, int dimw >
+  inline std::size_t BoundingBoxTree< ct, dimw >
+    ::buildNode ( std::size_t begin, std::size_t end, const std::vector< Coordinate > &centers )
+  {
+    assert( begin < end );
+
+    // compute the bounding box of the node and the extent of the centers
+    BoundingBox box = boxes_[ indices_[ begin ] ];
+    Coordinate lower = centers[ indices_[ begin ] ];
+    Coordinate upper = lower;
+    for( std::size_t i = begin+1; i < end; ++i )
+    {
+      const BoundingBox &other = boxes_[ indices_[ i ] ];
+      const Coordinate &center = centers[ indices_[ i ] ];
+      for( int k = 0; k < dimw; ++k )
+      {
+        box.first[ k ] = std::min( box.first[ k ], other.first[ k ] );
+        box.second[ k ] = std::max( box.second[ k ], other.second[ k ] );
+        lower[ k ] = std::min( lower[ k ], center[ k ] );
+        upper[ k ] = std::max( upper[ k ], center[ k ] );
+      }
+    }
+
+    const std::size_t node = nodes_.size();
+    nodes_.push_back( Node() );
+    nodes_[ node ].box = box;
+    nodes_[ node ].begin = begin;
+    nodes_[ node ].end = end;
+    nodes_[ node ].left = nodes_[ node ].right = invalid;
+
+    if( end - begin <= leafSize )
+      return node;
+
+    // split the centers at the median of the longest extent
+    int direction = 0;
+    for( int k = 1; k < dimw; ++k )
+    {
+      if( upper[ k ] - lower[ k ] > upper[ direction ] - lower[ direction ] )
+        direction = k;
+    }
+
+    const std::size_t middle = begin + (end - begin) / 2;
+    std::nth_element( indices_.begin() + begin, indices_.begin() + middle, indices_.begin() + end,
+                      [ &centers, direction ] ( std::size_t i, std::size_t j ) { return (centers[ i ][ direction ] < centers[ j ][ direction ]); } );
+
+    const std::size_t left = buildNode( begin, middle, centers );
+    const std::size_t right = buildNode( middle, end, centers );
+    nodes_[ node ].left = left;
+    nodes_[ node ].right = right;
+    return node;
+  }
+
+
+  template< class ct, int dimw >
+  template< class F >
+  inline bool BoundingBoxTree< ct, dimw >::visit ( const Coordinate &x, F &&f ) const
+  {
+    if( nodes_.empty() )
+      return false;
+
+    // the median split guarantees a depth below the number of bits in std::size_t
+    std::size_t stack[ maxDepth+1 ];
+    std::size_t top = 0;
+    stack[ top++ ] = 0;
+    while( top > 0 )
+    {
+      const Node &node = nodes_[ stack[ --top ] ];
+      if( !contains( node.box, x ) )
+        continue;
+
+      if( node.left == invalid )
+      {
+        for( std::size_t i = node.begin; i < node.end; ++i )
+        {
+          const std::size_t index = indices_[ i ];
+          if( contains( boxes_[ index ], x ) && f( index ) )
+            return true;
+        }
+      }
+      else
+      {
+        assert( top+2 <= maxDepth+1 );
+        stack[ top++ ] = node.right;
+        stack[ top++ ] = node.left;
+      }
+    }
+    return false;
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_GRID_UTILITY_BOUNDINGBOXTREE_HH
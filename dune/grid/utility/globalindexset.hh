@@ -357,6 +357,9 @@ namespace Dune
       for (int i=1; i<rank+1; i++)
         myoffset += offset[i-1];
 
+      firstOwnedIndex_ = myoffset;
+      nOwnedEntity_ = nLocalEntity;
+
       /*  compute globally unique index over all processes; the idea of the algorithm is as follows: if
        *  an entity is owned by the process, it is assigned an index that is the addition of the offset
        *  specific for this process and a consecutively incremented counter; if the entity is not owned
@@ -494,6 +497,28 @@ namespace Dune
       return (codim_==codim) ? nGlobalEntity_ : 0;
     }
 
+    /** \brief Return the smallest global index assigned by this process
+     *
+     * The entities owned by this process carry the consecutive global indices
+     * firstOwnedIndex(), ..., firstOwnedIndex()+ownedSize()-1.
+     */
+    Index firstOwnedIndex() const
+    {
+      return firstOwnedIndex_;
+    }
+
+    /** \brief Return the number of entities owned by this process */
+    unsigned int ownedSize() const
+    {
+      return nOwnedEntity_;
+    }
+
+    /** \brief Return whether a global index was assigned by this process */
+    bool owned(Index index) const
+    {
+      return (index >= firstOwnedIndex_) && (index < firstOwnedIndex_ + Index(nOwnedEntity_));
+    }
+
   protected:
     const GridView gridview_;
 
@@ -503,6 +528,12 @@ namespace Dune
     //! Global number of entities, i.e. number of entities without rendundant entities on interprocessor boundaries
     int nGlobalEntity_;
 
+    //! First global index of the entities owned by this process
+    Index firstOwnedIndex_;
+
+    //! Number of entities owned by this process
+    int nOwnedEntity_;
+
     IndexMap localGlobalMap_;
 
     /** \brief Stores global index of entities with entity's globally unique id as key
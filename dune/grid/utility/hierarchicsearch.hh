@@ -10,10 +10,13 @@
    containing a given point.
  */
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <dune/common/classname.hh>
 #include <dune/common/exceptions.hh>
@@ -21,12 +24,18 @@
 
 #include <dune/grid/common/grid.hh>
 #include <dune/grid/common/gridenums.hh>
+#include <dune/grid/utility/boundingboxtree.hh>
 
 namespace Dune
 {
 
   /**
      @brief Search an IndexSet for an Entity containing a given point.
+
+     The macro elements are located through a bounding box tree, which is
+     built by the constructor. As the tree is built from the macro grid, it
+     has to be rebuilt by calling update() whenever the macro grid changes,
+     e.g., after load balancing.
    */
   template<class Grid, class IS>
   class HierarchicSearch
@@ -46,9 +55,37 @@ namespace Dune
     //! type of EntityPointer
     typedef typename Grid::template Codim<0>::EntityPointer EntityPointer;
 
+    //! type of EntitySeed
+    typedef typename Grid::template Codim<0>::EntitySeed EntitySeed;
+
     //! type of HierarchicIterator
     typedef typename Grid::HierarchicIterator HierarchicIterator;
 
+    //! type of global coordinates
+    typedef FieldVector<ct,dimw> GlobalCoordinate;
+
+    //! type of the bounding box tree over the macro elements
+    typedef BoundingBoxTree<ct,dimw> MacroTree;
+
+    static bool inPartition ( PartitionIteratorType pitype, PartitionType ptype )
+    {
+      switch( pitype )
+      {
+      case Interior_Partition :
+        return (ptype == InteriorEntity);
+      case InteriorBorder_Partition :
+        return (ptype == InteriorEntity) || (ptype == BorderEntity);
+      case Overlap_Partition :
+        return (ptype == InteriorEntity) || (ptype == BorderEntity) || (ptype == OverlapEntity);
+      case OverlapFront_Partition :
+        return (ptype != GhostEntity);
+      case Ghost_Partition :
+        return (ptype == GhostEntity);
+      default :
+        return true;
+      }
+    }
+
     static std::string formatEntityInformation ( const Entity &e ) {
       const typename Entity::Geometry &geo = e.geometry();
       std::ostringstream info;
@@ -112,11 +149,187 @@ namespace Dune
                  "[" << children.str() << "].");
     }
 
+    /**
+       internal helper method
+
+       @param[in] entity Entity to check
+       @param[in] global Point you are searching for
+
+       Check whether the entity contains the point global.
+     */
+    static bool contains ( const Entity &entity, const GlobalCoordinate &global )
+    {
+      typedef typename Entity::Geometry Geometry;
+      typedef typename Geometry::LocalCoordinate LocalCoordinate;
+
+      const Geometry &geo = entity.geometry();
+
+      LocalCoordinate local = geo.local( global );
+      if( !ReferenceElements< double, dim >::general( geo.type() ).checkInside( local ) )
+        return false;
+
+      if( (int(dim) != int(dimw)) && ((geo.global( local ) - global).two_norm() > 1e-8) )
+        return false;
+
+      return true;
+    }
+
+    /**
+       internal helper method
+
+       @param[in] entity Entity containing point global
+       @param[in] global Point you are searching for
+
+       Return the entity itself, if it is part of the IndexSet, or search its
+       descendants otherwise.
+     */
+    Entity descend ( Entity entity, const GlobalCoordinate &global ) const
+    {
+      if( indexSet_.contains( entity ) )
+        return std::move( entity );
+      else
+        return hFindEntity( entity, global );
+    }
+
+    /**
+       internal helper method
+
+       Build the bounding box tree over all macro elements.
+     */
+    void buildMacroTree ()
+    {
+      typedef typename Grid::LevelGridView LevelGV;
+      typedef typename LevelGV::template Codim<0>::template Partition<All_Partition>::Iterator LevelIterator;
+      typedef typename Entity::Geometry Geometry;
+      typedef typename MacroTree::BoundingBox BoundingBox;
+
+      const LevelGV &gv = grid_.levelGridView(0);
+
+      std::vector< BoundingBox > boxes;
+      macroSeeds_.clear();
+      macroAffine_ = true;
+
+      const LevelIterator end = gv.template end<0, All_Partition>();
+      for (LevelIterator it = gv.template begin<0, All_Partition>(); it != end; ++it)
+      {
+        const Entity &entity = *it;
+        const Geometry &geo = entity.geometry();
+        macroAffine_ &= geo.affine();
+
+        BoundingBox box( geo.corner( 0 ), geo.corner( 0 ) );
+        for( int i = 1; i < geo.corners(); ++i )
+        {
+          const GlobalCoordinate corner = geo.corner( i );
+          for( int k = 0; k < dimw; ++k )
+          {
+            box.first[ k ] = std::min( box.first[ k ], corner[ k ] );
+            box.second[ k ] = std::max( box.second[ k ], corner[ k ] );
+          }
+        }
+
+        // enlarge the box slightly to account for the tolerance in checkInside
+        ct diameter = 0;
+        for( int k = 0; k < dimw; ++k )
+          diameter = std::max( diameter, box.second[ k ] - box.first[ k ] );
+        const ct eps = 1e-8 * diameter;
+        for( int k = 0; k < dimw; ++k )
+        {
+          box.first[ k ] -= eps;
+          box.second[ k ] += eps;
+        }
+
+        boxes.push_back( box );
+        macroSeeds_.push_back( entity.seed() );
+      }
+
+      macroTree_.build( std::move( boxes ) );
+    }
+
+    /**
+       internal helper method
+
+       @param[in]  global Point you are searching for
+       @param[out] entity Macro element containing point global
+
+       Search the macro element containing point global.
+     */
+    template<PartitionIteratorType partition>
+    bool findMacroEntity ( const GlobalCoordinate &global, Entity &entity ) const
+    {
+      const bool found = macroTree_.visit( global, [ this, &global, &entity ] ( std::size_t i ) -> bool {
+          Entity candidate = grid_.entity( macroSeeds_[ i ] );
+          if( !inPartition( partition, candidate.partitionType() ) || !contains( candidate, global ) )
+            return false;
+          entity = std::move( candidate );
+          return true;
+        } );
+      if( found || macroAffine_ )
+        return found;
+
+      // non-affine macro elements might not be contained in the bounding box of their corners
+      typedef typename Grid::LevelGridView LevelGV;
+      typedef typename LevelGV::template Codim<0>::template Partition<partition>::Iterator LevelIterator;
+
+      const LevelGV &gv = grid_.levelGridView(0);
+      const LevelIterator end = gv.template end<0, partition>();
+      for (LevelIterator it = gv.template begin<0, partition>(); it != end; ++it)
+      {
+        if( contains( *it, global ) )
+        {
+          entity = *it;
+          return true;
+        }
+      }
+      return false;
+    }
+
+    /**
+       internal helper method
+
+       Compute the position of a point on a Z-order (Morton) curve through the
+       bounding box of the macro grid.
+     */
+    std::uint64_t mortonKey ( const GlobalCoordinate &global ) const
+    {
+      const int bits = std::min( 63 / int(dimw), 21 );
+      const std::uint64_t cells = (std::uint64_t( 1 ) << bits);
+
+      const typename MacroTree::BoundingBox &box = macroTree_.boundingBox();
+      std::uint64_t q[ dimw ];
+      for( int k = 0; k < dimw; ++k )
+      {
+        const ct h = box.second[ k ] - box.first[ k ];
+        const ct t = (h > 0 ? (global[ k ] - box.first[ k ]) / h : ct( 0 ));
+        q[ k ] = std::uint64_t( std::min( std::max( t, ct( 0 ) ), ct( 1 ) ) * (cells - 1) );
+      }
+
+      std::uint64_t key = 0;
+      for( int b = bits-1; b >= 0; --b )
+        for( int k = 0; k < dimw; ++k )
+          key = (key << 1) | ((q[ k ] >> b) & 1u);
+      return key;
+    }
+
   public:
     /**
        @brief Construct a HierarchicSearch object from a Grid and an IndexSet
      */
-    HierarchicSearch(const Grid & g, const IS & is) : grid_(g), indexSet_(is) {}
+    HierarchicSearch(const Grid & g, const IS & is)
+      : grid_(g), indexSet_(is), macroAffine_(true)
+    {
+      buildMacroTree();
+    }
+
+    /**
+       @brief Rebuild the search structure over the macro elements
+
+       This method has to be called whenever the macro grid changes, e.g.,
+       after load balancing.
+     */
+    void update ()
+    {
+      buildMacroTree();
+    }
 
     /**
        @brief Search the IndexSet of this HierarchicSearch for an Entity
@@ -138,43 +351,84 @@ namespace Dune
     template<PartitionIteratorType partition>
     Entity findEntity(const FieldVector<ct,dimw>& global) const
     {
-      typedef typename Grid::LevelGridView LevelGV;
-      const LevelGV &gv = grid_.template levelGridView(0);
+      Entity entity;
+      if( !findMacroEntity<partition>( global, entity ) )
+        DUNE_THROW( GridError, "Coordinate " << global << " is outside the grid." );
+      return descend( std::move( entity ), global );
+    }
 
-      //! type of LevelIterator
-      typedef typename LevelGV::template Codim<0>::template Partition<partition>::Iterator LevelIterator;
+    /**
+       @brief Search the IndexSet of this HierarchicSearch for the Entities
+       containing a list of points.
 
-      // type of element geometry
-      typedef typename Entity::Geometry Geometry;
-      // type of local coordinate
-      typedef typename Geometry::LocalCoordinate LocalCoordinate;
+       \exception GridError No element of the coarse grid contains one of the
+                            given coordinates.
+     */
+    std::vector<Entity> findEntities(const std::vector<FieldVector<ct,dimw> >& global) const
+    { return findEntities<All_Partition>(global); }
 
-      // loop over macro level
-      const LevelIterator end = gv.template end<0, partition>();
-      for (LevelIterator it = gv.template begin<0, partition>(); it != end; ++it)
-      {
-        Entity entity = *it;
-        const Geometry &geo = entity.geometry();
+    /**
+       @brief Search the IndexSet of this HierarchicSearch for the Entities
+       containing a list of points.
+
+       The points are processed along a space filling curve, so that
+       consecutive points are likely to be found in the same (macro) element.
+       Before searching the bounding box tree, the element found for the
+       previous point is checked.
 
-        LocalCoordinate local = geo.local( global );
-        if( !ReferenceElements< double, dim >::general( geo.type() ).checkInside( local ) )
-          continue;
+       \returns a vector containing the element found for the i-th point at
+                position i
 
-        if( (int(dim) != int(dimw)) && ((geo.global( local ) - global).two_norm() > 1e-8) )
-          continue;
+       \exception GridError No element of the coarse grid contains one of the
+                            given coordinates.
+     */
+    template<PartitionIteratorType partition>
+    std::vector<Entity> findEntities(const std::vector<FieldVector<ct,dimw> >& global) const
+    {
+      const std::size_t size = global.size();
+      std::vector<Entity> entities( size );
+      if( size == 0 )
+        return entities;
+
+      if( macroTree_.empty() )
+        DUNE_THROW( GridError, "Coordinate " << global[ 0 ] << " is outside the grid." );
+
+      // sort the points along a Z-order curve
+      std::vector< std::pair< std::uint64_t, std::size_t > > order( size );
+      for( std::size_t i = 0; i < size; ++i )
+        order[ i ] = std::make_pair( mortonKey( global[ i ] ), i );
+      std::sort( order.begin(), order.end() );
+
+      Entity macro, leaf;
+      bool haveMacro = false, haveLeaf = false;
+      for( std::size_t j = 0; j < size; ++j )
+      {
+        const std::size_t i = order[ j ].second;
+        const GlobalCoordinate &x = global[ i ];
 
-        // return if we found the leaf, else search through the child entites
-        if( indexSet_.contains( entity ) )
-          return std::move( entity );
-        else
-          return hFindEntity( entity, global );
+        if( !haveLeaf || !contains( leaf, x ) )
+        {
+          if( !haveMacro || !contains( macro, x ) )
+          {
+            if( !findMacroEntity<partition>( x, macro ) )
+              DUNE_THROW( GridError, "Coordinate " << x << " is outside the grid." );
+            haveMacro = true;
+          }
+          leaf = descend( macro, x );
+          haveLeaf = true;
+        }
+        entities[ i ] = leaf;
       }
-      DUNE_THROW( GridError, "Coordinate " << global << " is outside the grid." );
+      return entities;
     }
 
   private:
     const Grid& grid_;
     const IS&   indexSet_;
+
+    MacroTree macroTree_;
+    std::vector< EntitySeed > macroSeeds_;
+    bool macroAffine_;
   };
 
 } // end namespace Dune
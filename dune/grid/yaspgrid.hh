@@ -4,6 +4,7 @@
 #define DUNE_GRID_YASPGRID_HH
 
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <algorithm>
 #include <stack>
@@ -29,6 +30,7 @@ typedef unsigned char uint8_t;
 #include <dune/geometry/axisalignedcubegeometry.hh>
 #include <dune/grid/common/indexidset.hh>
 #include <dune/grid/common/datahandleif.hh>
+#include <dune/grid/common/commprofiler.hh>
 
 
 #if HAVE_MPI
@@ -71,6 +73,7 @@ namespace Dune {
 #include <dune/grid/yaspgrid/coordinates.hh>
 #include <dune/grid/yaspgrid/torus.hh>
 #include <dune/grid/yaspgrid/ygrid.hh>
+#include <dune/grid/yaspgrid/indexbox.hh>
 #include <dune/grid/yaspgrid/yaspgridgeometry.hh>
 #include <dune/grid/yaspgrid/yaspgridentity.hh>
 #include <dune/grid/yaspgrid/yaspgridintersection.hh>
@@ -209,31 +212,42 @@ namespace Dune {
       std::array<YGrid, dim+1> interior;
       std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power> interior_data;
 
-      std::array<YGridList<Coordinates>,dim+1> send_overlapfront_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlapfront_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlapfront_data;
+      // The intersections with neighboring processes used for communication are
+      // built on first use of a given codimension and interface, see communicationLists.
+      mutable std::array<YGridList<Coordinates>,dim+1> send_overlapfront_overlapfront;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  send_overlapfront_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlapfront;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlapfront_data;
 
-      std::array<YGridList<Coordinates>,dim+1> send_overlap_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_overlap_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlap;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlap_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> send_overlap_overlapfront;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  send_overlap_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_overlap;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_overlap_data;
 
-      std::array<YGridList<Coordinates>,dim+1> send_interiorborder_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_interiorborder_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_interiorborder_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_interiorborder_interiorborder_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> send_interiorborder_interiorborder;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_interiorborder_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_interiorborder_interiorborder;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  recv_interiorborder_interiorborder_data;
 
-      std::array<YGridList<Coordinates>,dim+1> send_interiorborder_overlapfront;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_overlapfront_data;
-      std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_interiorborder;
-      std::array<std::deque<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_interiorborder_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> send_interiorborder_overlapfront;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  send_interiorborder_overlapfront_data;
+      mutable std::array<YGridList<Coordinates>,dim+1> recv_overlapfront_interiorborder;
+      mutable std::array<std::vector<Intersection>, StaticPower<2,dim>::power>  recv_overlapfront_interiorborder_data;
+
+      // which of the above lists have been built (per codim, indexed by commListIndex)
+      mutable std::array<std::bitset<4>,dim+1> commListsBuilt;
 
       // general
       YaspGrid<dim,Coordinates>* mg;  // each grid level knows its multigrid
       int overlapSize;           // in mesh cells on this level
       bool keepOverlap;
 
+      // face data used by the intersections, see makeFaceInfo
+      std::array<int,dim> lowerBoundary, upperBoundary; // face coordinates on the domain boundary
+      std::array<int,dim> neighborBegin, neighborEnd;   // faces in (begin,end] have a neighbor cell
+      std::array<int,2*dim> bSegmentOffset;             // boundary segment index ...
+      std::array<std::array<int,dim>,dim> bSegmentStride; // ... and its increment per macro cell
+
       /** \brief The level number within the YaspGrid level hierarchy */
       int level_;
     };
@@ -343,26 +357,6 @@ namespace Dune {
       typename std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power>::iterator interiorborder_it = g.interiorborder_data.begin();
       typename std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power>::iterator interior_it = g.interior_data.begin();
 
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_overlapfront_overlapfront_it = g.send_overlapfront_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_overlapfront_it = g.recv_overlapfront_overlapfront_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_overlap_overlapfront_it = g.send_overlap_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_overlap_it = g.recv_overlapfront_overlap_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_interiorborder_interiorborder_it = g.send_interiorborder_interiorborder_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_interiorborder_interiorborder_it = g.recv_interiorborder_interiorborder_data.begin();
-
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        send_interiorborder_overlapfront_it = g.send_interiorborder_overlapfront_data.begin();
-      typename std::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator
-        recv_overlapfront_interiorborder_it = g.recv_overlapfront_interiorborder_data.begin();
-
       // have a null array for constructor calls around
       std::array<int,dim> n;
       std::fill(n.begin(), n.end(), 0);
@@ -412,14 +406,9 @@ namespace Dune {
         g.overlap[codim].setBegin(overlap_it);
         g.interiorborder[codim].setBegin(interiorborder_it);
         g.interior[codim].setBegin(interior_it);
-        g.send_overlapfront_overlapfront[codim].setBegin(send_overlapfront_overlapfront_it);
-        g.recv_overlapfront_overlapfront[codim].setBegin(recv_overlapfront_overlapfront_it);
-        g.send_overlap_overlapfront[codim].setBegin(send_overlap_overlapfront_it);
-        g.recv_overlapfront_overlap[codim].setBegin(recv_overlapfront_overlap_it);
-        g.send_interiorborder_interiorborder[codim].setBegin(send_interiorborder_interiorborder_it);
-        g.recv_interiorborder_interiorborder[codim].setBegin(recv_interiorborder_interiorborder_it);
-        g.send_interiorborder_overlapfront[codim].setBegin(send_interiorborder_overlapfront_it);
-        g.recv_overlapfront_interiorborder[codim].setBegin(recv_overlapfront_interiorborder_it);
+
+        // the communication lists are built on first use
+        g.commListsBuilt[codim].reset();
 
         // find all combinations of unit vectors that span entities of the given codimension
         for (unsigned int index = 0; index < (1<<dim); index++)
@@ -494,24 +483,11 @@ namespace Dune {
           }
           *interior_it = YGridComponent<Coordinates>(origin, size, *overlapfront_it);
 
-          intersections(*overlapfront_it,*overlapfront_it,*send_overlapfront_overlapfront_it, *recv_overlapfront_overlapfront_it);
-          intersections(*overlap_it,*overlapfront_it,*send_overlap_overlapfront_it, *recv_overlapfront_overlap_it);
-          intersections(*interiorborder_it,*interiorborder_it,*send_interiorborder_interiorborder_it,*recv_interiorborder_interiorborder_it);
-          intersections(*interiorborder_it,*overlapfront_it,*send_interiorborder_overlapfront_it,*recv_overlapfront_interiorborder_it);
-
           // advance all iterators pointing to the next insertion point
           ++overlapfront_it;
           ++overlap_it;
           ++interiorborder_it;
           ++interior_it;
-          ++send_overlapfront_overlapfront_it;
-          ++recv_overlapfront_overlapfront_it;
-          ++send_overlap_overlapfront_it;
-          ++recv_overlapfront_overlap_it;
-          ++send_interiorborder_interiorborder_it;
-          ++recv_interiorborder_interiorborder_it;
-          ++send_interiorborder_overlapfront_it;
-          ++recv_overlapfront_interiorborder_it;
         }
 
         // set end iterators in the corresonding ygrids
@@ -519,17 +495,165 @@ namespace Dune {
         g.overlap[codim].finalize(overlap_it);
         g.interiorborder[codim].finalize(interiorborder_it);
         g.interior[codim].finalize(interior_it);
-        g.send_overlapfront_overlapfront[codim].finalize(send_overlapfront_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_overlapfront[codim].finalize(recv_overlapfront_overlapfront_it,g.overlapfront[codim]);
-        g.send_overlap_overlapfront[codim].finalize(send_overlap_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_overlap[codim].finalize(recv_overlapfront_overlap_it,g.overlapfront[codim]);
-        g.send_interiorborder_interiorborder[codim].finalize(send_interiorborder_interiorborder_it,g.overlapfront[codim]);
-        g.recv_interiorborder_interiorborder[codim].finalize(recv_interiorborder_interiorborder_it,g.overlapfront[codim]);
-        g.send_interiorborder_overlapfront[codim].finalize(send_interiorborder_overlapfront_it,g.overlapfront[codim]);
-        g.recv_overlapfront_interiorborder[codim].finalize(recv_overlapfront_interiorborder_it,g.overlapfront[codim]);
+      }
+
+      makeFaceInfo(g,periodic);
+    }
+
+    /** \brief precompute the face data of a grid level used by YaspIntersection
+     *
+     * The boundary segments are numbered on the macro grid: first all
+     * segments orthogonal to direction 0, lower side before upper side,
+     * then direction 1 and so on.  The index of a segment is stored as
+     * an offset per face of the reference cube and the increments per
+     * macro cell coordinate.
+     */
+    void makeFaceInfo (YGridLevel& g, std::bitset<dim> periodic)
+    {
+      const YGridComponent<Coordinates>& cells = *g.overlap[0].dataBegin();
+      for (int i=0; i<dim; i++)
+      {
+        // a periodic direction has no boundary
+        g.lowerBoundary[i] = periodic[i] ? std::numeric_limits<int>::min() : 0;
+        g.upperBoundary[i] = periodic[i] ? std::numeric_limits<int>::min() : levelSize(g.level(),i);
+        g.neighborBegin[i] = cells.min(i);
+        g.neighborEnd[i] = cells.max(i);
+      }
+
+      // the local part of the macro grid and the number of its sides on the boundary
+      const YGridComponent<Coordinates>& macro = *begin()->overlap[0].dataBegin();
+      std::array<int,dim> sides, fsize;
+      int vol = 1;
+      for (int k=0; k<dim; k++)
+      {
+        sides[k] = (macro.origin(k) == 0) + (macro.origin(k) + macro.size(k) == levelSize(0,k));
+        vol *= macro.size(k);
+      }
+      for (int k=0; k<dim; k++)
+        fsize[k] = vol / macro.size(k);
+
+      int offset = 0;
+      for (int d=0; d<dim; d++)
+      {
+        // index of the macro cell in the face, last direction running fastest
+        int localoffset = 1;
+        int originoffset = 0;
+        for (int k=dim-1; k>=0; k--)
+        {
+          g.bSegmentStride[d][k] = (k == d) ? 0 : localoffset;
+          if (k == d)
+            continue;
+          originoffset += macro.origin(k) * localoffset;
+          localoffset *= macro.size(k);
+        }
+
+        // the upper side follows the lower side if both are on the boundary
+        g.bSegmentOffset[2*d] = offset - originoffset;
+        g.bSegmentOffset[2*d+1] = offset + (sides[d] > 1) * fsize[d] - originoffset;
+        offset += sides[d] * fsize[d];
+      }
+    }
+
+    //! map an interface to the index of its pair of communication lists
+    static int commListIndex (InterfaceType iftype)
+    {
+      switch (iftype)
+      {
+      case InteriorBorder_InteriorBorder_Interface :
+        return 0;
+      case InteriorBorder_All_Interface :
+        return 1;
+      case Overlap_OverlapFront_Interface :
+      case Overlap_All_Interface :
+        return 2;
+      case All_All_Interface :
+        return 3;
+      default :
+        DUNE_THROW(GridError, "YaspGrid does not support interface type " << iftype);
       }
     }
 
+    /** \brief Build the intersections with neighboring processors for one codim and interface
+     *
+     * As most applications never communicate most of the combinations of codimension
+     * and interface, the intersections are computed on first use only. Computing the
+     * intersections requires communication, so this method is collective (as is the
+     * communication itself).
+     *
+     * \param g      the grid level
+     * \param codim  the codimension to build the lists for
+     * \param iftype the interface to build the lists for
+     */
+    void makeCommunicationLists (const YGridLevel& g, int codim, InterfaceType iftype) const
+    {
+      typedef std::array<YGridComponent<Coordinates>, StaticPower<2,dim>::power> ComponentArray;
+      typedef std::array<std::vector<Intersection>, StaticPower<2,dim>::power> IntersectionArray;
+
+      const ComponentArray* sendgrids = 0;
+      const ComponentArray* recvgrids = 0;
+      IntersectionArray* sendintersections = 0;
+      IntersectionArray* recvintersections = 0;
+      YGridList<Coordinates>* sendlist = 0;
+      YGridList<Coordinates>* recvlist = 0;
+
+      const int index = commListIndex(iftype);
+      switch (index)
+      {
+      case 0 :
+        sendgrids = &g.interiorborder_data;
+        recvgrids = &g.interiorborder_data;
+        sendintersections = &g.send_interiorborder_interiorborder_data;
+        recvintersections = &g.recv_interiorborder_interiorborder_data;
+        sendlist = &g.send_interiorborder_interiorborder[codim];
+        recvlist = &g.recv_interiorborder_interiorborder[codim];
+        break;
+      case 1 :
+        sendgrids = &g.interiorborder_data;
+        recvgrids = &g.overlapfront_data;
+        sendintersections = &g.send_interiorborder_overlapfront_data;
+        recvintersections = &g.recv_overlapfront_interiorborder_data;
+        sendlist = &g.send_interiorborder_overlapfront[codim];
+        recvlist = &g.recv_overlapfront_interiorborder[codim];
+        break;
+      case 2 :
+        sendgrids = &g.overlap_data;
+        recvgrids = &g.overlapfront_data;
+        sendintersections = &g.send_overlap_overlapfront_data;
+        recvintersections = &g.recv_overlapfront_overlap_data;
+        sendlist = &g.send_overlap_overlapfront[codim];
+        recvlist = &g.recv_overlapfront_overlap[codim];
+        break;
+      default :
+        sendgrids = &g.overlapfront_data;
+        recvgrids = &g.overlapfront_data;
+        sendintersections = &g.send_overlapfront_overlapfront_data;
+        recvintersections = &g.recv_overlapfront_overlapfront_data;
+        sendlist = &g.send_overlapfront_overlapfront[codim];
+        recvlist = &g.recv_overlapfront_overlapfront[codim];
+        break;
+      }
+
+      // the components of this codimension share their positions in all data arrays
+      const int first = g.overlapfront[codim].dataBegin() - g.overlapfront_data.data();
+      const int last = g.overlapfront[codim].dataEnd() - g.overlapfront_data.data();
+
+      for (int k=first; k<last; k++)
+      {
+        (*sendintersections)[k].clear();
+        (*recvintersections)[k].clear();
+        intersections((*sendgrids)[k],(*recvgrids)[k],(*sendintersections)[k],(*recvintersections)[k]);
+        (*sendintersections)[k].shrink_to_fit();
+        (*recvintersections)[k].shrink_to_fit();
+      }
+
+      sendlist->setBegin(sendintersections->begin()+first);
+      sendlist->finalize(sendintersections->begin()+last,g.overlapfront[codim]);
+      recvlist->setBegin(recvintersections->begin()+first);
+      recvlist->finalize(recvintersections->begin()+last,g.overlapfront[codim]);
+
+      g.commListsBuilt[codim][index] = true;
+    }
+
 #ifndef DOXYGEN
     /** \brief special data structure to communicate ygrids
      * Historically, this was needed because Ygrids had virtual functions and
@@ -557,12 +681,12 @@ namespace Dune {
      *
      * \param recvgrid the grid stored in this processor
      * \param sendgrid the subgrid to be sent to neighboring processors
-     * \param sendlist the deque to fill with send intersections
-     * \param recvlist the deque to fill with recv intersections
+     * \param sendlist the vector to fill with send intersections
+     * \param recvlist the vector to fill with recv intersections
      * \returns two lists: Intersections to be sent and Intersections to be received
      */
     void intersections(const YGridComponent<Coordinates>& sendgrid, const YGridComponent<Coordinates>& recvgrid,
-                        std::deque<Intersection>& sendlist, std::deque<Intersection>& recvlist)
+                        std::vector<Intersection>& sendlist, std::vector<Intersection>& recvlist) const
     {
       iTupel size = globalSize();
 
@@ -661,7 +785,7 @@ namespace Dune {
         send_intersection.grid = sendgrid.intersection(recv_recvgrid[i.index()]);
         send_intersection.rank = i.rank();
         send_intersection.distance = i.distance();
-        if (!send_intersection.grid.empty()) sendlist.push_front(send_intersection);
+        if (!send_intersection.grid.empty()) sendlist.push_back(send_intersection);
 
         Intersection recv_intersection;
         yg = mpifriendly_recv_sendgrid[i.index()];
@@ -671,6 +795,9 @@ namespace Dune {
         recv_intersection.distance = i.distance();
         if(!recv_intersection.grid.empty()) recvlist.push_back(recv_intersection);
       }
+
+      // the send list is traversed in reverse order of the neighbors
+      std::reverse(sendlist.begin(),sendlist.end());
     }
 
   protected:
@@ -679,9 +806,7 @@ namespace Dune {
 
     void init()
     {
-      Yasp::BinomialTable<dim>::init();
-      Yasp::EntityShiftTable<Yasp::calculate_entity_shift<dim>,dim>::init();
-      Yasp::EntityShiftTable<Yasp::calculate_entity_move<dim>,dim>::init();
+      Yasp::SubEntityTable<dim>::init();
       indexsets.push_back( std::make_shared< YaspIndexSet<const YaspGrid<dim, Coordinates>, false > >(*this,0) );
       boundarysegmentssize();
     }
@@ -1371,6 +1496,137 @@ namespace Dune {
       return Entity(EntityImp(g,YIterator(g->overlapfront[codim],this->getRealImplementation(seed).coord(),this->getRealImplementation(seed).offset())));
     }
 
+    /** \brief locate the element on a given level containing a point
+     *
+     *  As the grid is structured, the containing cell is computed directly
+     *  from the coordinate container, i.e., arithmetically for equidistant
+     *  coordinates and by a binary search per direction for tensor product
+     *  coordinates.
+     *
+     *  \param[in]  global  global coordinate of the point
+     *  \param[out] local   local coordinate of the point within the element
+     *  \param[in]  level   grid level to search the element on
+     *
+     *  \exception GridError The partition on this process does not contain
+     *                       the given point.
+     */
+    template<PartitionIteratorType pitype>
+    typename Traits::template Codim<0>::Entity
+    findEntity (const fTupel& global, fTupel& local, int level) const
+    {
+      YGridLevelIterator g = begin(level);
+      const YGridComponent<Coordinates>& cells = findComponent<pitype>(*g);
+
+      iTupel coord;
+      for (int i=0; i<dim; i++)
+        if (!locateCell(g->coords,cells,i,global[i],coord[i],local[i]))
+          DUNE_THROW(GridError, "Coordinate " << global << " is outside the grid.");
+
+      return makeElement(g,coord);
+    }
+
+    //! locate the leaf element containing a point (see above)
+    typename Traits::template Codim<0>::Entity
+    findEntity (const fTupel& global, fTupel& local) const
+    {
+      return findEntity<All_Partition>(global,local,maxLevel());
+    }
+
+    //! locate the leaf element containing a point (see above)
+    typename Traits::template Codim<0>::Entity
+    findEntity (const fTupel& global) const
+    {
+      fTupel local;
+      return findEntity<All_Partition>(global,local,maxLevel());
+    }
+
+    /** \brief locate the elements on a given level containing a list of points
+     *
+     *  The cells are located direction by direction for all points, so that
+     *  the arithmetic for equidistant coordinates can be vectorized.
+     *
+     *  \param[in]  global    global coordinates of the points
+     *  \param[out] entities  elements containing the points
+     *  \param[out] local     local coordinates of the points within the elements
+     *  \param[in]  level     grid level to search the elements on
+     *
+     *  \exception GridError The partition on this process does not contain
+     *                       one of the given points.
+     */
+    template<PartitionIteratorType pitype>
+    void findEntities (const std::vector<fTupel>& global,
+                       std::vector<typename Traits::template Codim<0>::Entity>& entities,
+                       std::vector<fTupel>& local, int level) const
+    {
+      YGridLevelIterator g = begin(level);
+      const YGridComponent<Coordinates>& cells = findComponent<pitype>(*g);
+
+      const std::size_t n = global.size();
+      std::vector<iTupel> coord(n);
+      local.resize(n);
+      for (int i=0; i<dim; i++)
+        for (std::size_t j=0; j<n; j++)
+          if (!locateCell(g->coords,cells,i,global[j][i],coord[j][i],local[j][i]))
+            DUNE_THROW(GridError, "Coordinate " << global[j] << " is outside the grid.");
+
+      entities.clear();
+      entities.reserve(n);
+      for (std::size_t j=0; j<n; j++)
+        entities.push_back(makeElement(g,coord[j]));
+    }
+
+    //! locate the leaf elements containing a list of points (see above)
+    void findEntities (const std::vector<fTupel>& global,
+                       std::vector<typename Traits::template Codim<0>::Entity>& entities,
+                       std::vector<fTupel>& local) const
+    {
+      findEntities<All_Partition>(global,entities,local,maxLevel());
+    }
+
+    /** \brief return the index boxes of the entities of a codimension in a partition on a level
+     *
+     *  There is one box per orientation of the entities, in the order of the
+     *  entity iteration.  The indices are those of the level index set.
+     */
+    template<PartitionIteratorType pitype>
+    std::vector<YaspIndexBox<dim> > indexBoxes (int level, int codim) const
+    {
+      YGridLevelIterator g = begin(level);
+      const YGrid& ygrid = findYGrid<pitype>(*g,codim);
+
+      std::vector<YaspIndexBox<dim> > boxes;
+      for (int which = 0; which < ygrid.dataEnd() - ygrid.dataBegin(); ++which)
+        boxes.push_back(makeIndexBox(*g,codim,which,*(ygrid.dataBegin()+which)));
+      return boxes;
+    }
+
+    //! return the index boxes of the entities of a codimension on a level
+    std::vector<YaspIndexBox<dim> > indexBoxes (int level, int codim) const
+    {
+      return indexBoxes<All_Partition>(level,codim);
+    }
+
+    /** \brief return the index box of the entities with given shift vector in a partition on a level
+     *
+     *  The cells have the shift vector with all bits set, the faces
+     *  orthogonal to direction i the one with all bits but bit i set.
+     */
+    template<PartitionIteratorType pitype>
+    YaspIndexBox<dim> indexBox (int level, const std::bitset<dim>& shift) const
+    {
+      YGridLevelIterator g = begin(level);
+      const int codim = dim - shift.count();
+      const YGrid& ygrid = findYGrid<pitype>(*g,codim);
+      const int which = ygrid.shiftmapping(shift);
+      return makeIndexBox(*g,codim,which,*(ygrid.dataBegin()+which));
+    }
+
+    //! return the index box of the entities with given shift vector on a level
+    YaspIndexBox<dim> indexBox (int level, const std::bitset<dim>& shift) const
+    {
+      return indexBox<All_Partition>(level,shift);
+    }
+
     //! return size (= distance in graph) of overlap region
     int overlapSize (int level, int codim) const
     {
@@ -1471,35 +1727,18 @@ namespace Dune {
       // access to grid level
       YGridLevelIterator g = begin(level);
 
-      // find send/recv lists or throw error
+      // find send/recv lists (built on first use) or throw error
       const YGridList<Coordinates>* sendlist = 0;
       const YGridList<Coordinates>* recvlist = 0;
-
-      if (iftype==InteriorBorder_InteriorBorder_Interface)
-      {
-        sendlist = &g->send_interiorborder_interiorborder[codim];
-        recvlist = &g->recv_interiorborder_interiorborder[codim];
-      }
-      if (iftype==InteriorBorder_All_Interface)
-      {
-        sendlist = &g->send_interiorborder_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_interiorborder[codim];
-      }
-      if (iftype==Overlap_OverlapFront_Interface || iftype==Overlap_All_Interface)
-      {
-        sendlist = &g->send_overlap_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_overlap[codim];
-      }
-      if (iftype==All_All_Interface)
-      {
-        sendlist = &g->send_overlapfront_overlapfront[codim];
-        recvlist = &g->recv_overlapfront_overlapfront[codim];
-      }
+      communicationLists(g,codim,iftype,sendlist,recvlist);
 
       // change communication direction?
       if (dir==BackwardCommunication)
         std::swap(sendlist,recvlist);
 
+      // timings and message statistics, empty unless DUNE_GRID_COMM_PROFILING is set
+      CommProfileScope profile("YaspGrid",iftype,codim);
+
       int cnt;
 
       // Size computation (requires communication if variable size)
@@ -1559,6 +1798,7 @@ namespace Dune {
 
           // hand over send request to torus class
           torus().send(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
+          profile.sent(is->grid.totalsize()*sizeof(size_t));
           cnt++;
         }
 
@@ -1572,6 +1812,7 @@ namespace Dune {
 
           // hand over recv request to torus class
           torus().recv(is->rank,buf,is->grid.totalsize()*sizeof(size_t));
+          profile.received(is->grid.totalsize()*sizeof(size_t));
           cnt++;
         }
 
@@ -1607,6 +1848,7 @@ namespace Dune {
 
 
       // allocate & fill the send buffers & store send request
+      profile.phase(CommProfileData::gatherPhase);
       std::vector<DataType*> sends(sendlist->size(), static_cast<DataType*>(0)); // store pointers to send buffers
       cnt=0;
       for (ListIt is=sendlist->begin(); is!=sendlist->end(); ++is)
@@ -1630,6 +1872,7 @@ namespace Dune {
 
         // hand over send request to torus class
         torus().send(is->rank,buf,send_size[cnt]*sizeof(DataType));
+        profile.sent(send_size[cnt]*sizeof(DataType));
         cnt++;
       }
 
@@ -1646,11 +1889,14 @@ namespace Dune {
 
         // hand over recv request to torus class
         torus().recv(is->rank,buf,recv_size[cnt]*sizeof(DataType));
+        profile.received(recv_size[cnt]*sizeof(DataType));
         cnt++;
       }
 
       // exchange all buffers now
+      profile.phase(CommProfileData::exchangePhase);
       torus().exchange();
+      profile.phase(CommProfileData::scatterPhase);
 
       // release send buffers
       cnt=0;
@@ -1701,6 +1947,74 @@ namespace Dune {
       }
     }
 
+    /** \brief return the send and receive lists for a codimension and interface
+     *
+     * The lists are built on first use, which requires communication. Hence,
+     * this method has to be called collectively.
+     */
+    void communicationLists (YGridLevelIterator g, int codim, InterfaceType iftype,
+                             const YGridList<Coordinates>*& sendlist, const YGridList<Coordinates>*& recvlist) const
+    {
+      const int index = commListIndex(iftype);
+      if (!g->commListsBuilt[codim][index])
+        makeCommunicationLists(*g,codim,iftype);
+
+      switch (index)
+      {
+      case 0 :
+        sendlist = &g->send_interiorborder_interiorborder[codim];
+        recvlist = &g->recv_interiorborder_interiorborder[codim];
+        break;
+      case 1 :
+        sendlist = &g->send_interiorborder_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_interiorborder[codim];
+        break;
+      case 2 :
+        sendlist = &g->send_overlap_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_overlap[codim];
+        break;
+      default :
+        sendlist = &g->send_overlapfront_overlapfront[codim];
+        recvlist = &g->recv_overlapfront_overlapfront[codim];
+        break;
+      }
+    }
+
+    /** \brief return the number of bytes used by the data structures of a grid level
+     *
+     * This includes the heap memory allocated for the communication lists
+     * built so far.
+     */
+    std::size_t memoryUsage (int level) const
+    {
+      YGridLevelIterator g = begin(level);
+
+      std::size_t usage = sizeof(YGridLevel);
+      for (int codim=0; codim<=dim; codim++)
+      {
+        usage += g->overlapfront[codim].memoryUsage() + g->overlap[codim].memoryUsage();
+        usage += g->interiorborder[codim].memoryUsage() + g->interior[codim].memoryUsage();
+      }
+
+      const std::array<std::vector<Intersection>, StaticPower<2,dim>::power>* lists[] = {
+        &g->send_overlapfront_overlapfront_data, &g->recv_overlapfront_overlapfront_data,
+        &g->send_overlap_overlapfront_data, &g->recv_overlapfront_overlap_data,
+        &g->send_interiorborder_interiorborder_data, &g->recv_interiorborder_interiorborder_data,
+        &g->send_interiorborder_overlapfront_data, &g->recv_overlapfront_interiorborder_data
+      };
+      for (int i=0; i<8; i++)
+      {
+        for (std::size_t k=0; k<lists[i]->size(); k++)
+        {
+          const std::vector<Intersection>& list = (*lists[i])[k];
+          usage += list.capacity() * sizeof(Intersection);
+          for (std::size_t j=0; j<list.size(); j++)
+            usage += list[j].yg.memoryUsage();
+        }
+      }
+      return usage;
+    }
+
     // The new index sets from DDM 11.07.2005
     const typename Traits::GlobalIdSet& globalIdSet() const
     {
@@ -1824,6 +2138,83 @@ namespace Dune {
       DUNE_THROW(GridError, "YaspLevelIterator with this codim or partition type not implemented");
     }
 
+    //! return the cells of a given partition on a grid level
+    template<PartitionIteratorType pitype>
+    const YGridComponent<Coordinates>& findComponent (const YGridLevel& g) const
+    {
+      if (pitype==Interior_Partition)
+        return *g.interior[0].dataBegin();
+      if (pitype==InteriorBorder_Partition)
+        return *g.interiorborder[0].dataBegin();
+      if (pitype==Overlap_Partition)
+        return *g.overlap[0].dataBegin();
+      if (pitype<=All_Partition)
+        return *g.overlapfront[0].dataBegin();
+
+      DUNE_THROW(GridError, "Point location with this partition type not implemented");
+    }
+
+    //! return the entities of a codimension and partition on a grid level
+    template<PartitionIteratorType pitype>
+    const YGrid& findYGrid (const YGridLevel& g, int codim) const
+    {
+      if (pitype==Interior_Partition)
+        return g.interior[codim];
+      if (pitype==InteriorBorder_Partition)
+        return g.interiorborder[codim];
+      if (pitype==Overlap_Partition)
+        return g.overlap[codim];
+      if (pitype<=All_Partition)
+        return g.overlapfront[codim];
+
+      DUNE_THROW(GridError, "Index boxes with this partition type not implemented");
+    }
+
+    //! describe a component of a grid level as index box, the component has index which in its ygrid
+    YaspIndexBox<dim> makeIndexBox (const YGridLevel& g, int codim, int which,
+                                    const YGridComponent<Coordinates>& component) const
+    {
+      YaspIndexBox<dim> box;
+      box.shift = component.shift();
+      box.origin = component.origin();
+      box.size = component.size();
+      for (int i=0; i<dim; i++)
+        box.stride[i] = component.superincrement(i);
+      // the components of all partitions are subsets of the overlapfront ones
+      box.offset = g.overlapfront[codim].superindex(component.origin(),which);
+      return box;
+    }
+
+    //! find the cell containing a coordinate in direction i and compute its local coordinate
+    static bool locateCell (const Coordinates& coords, const YGridComponent<Coordinates>& cells,
+                            int i, ctype x, int& c, ctype& local)
+    {
+      if (cells.size(i) == 0)
+        return false;
+
+      // allow for round-off errors on the boundary of the partition
+      const ctype lower = coords.coordinate(i,cells.min(i));
+      const ctype upper = coords.coordinate(i,cells.max(i)+1);
+      const ctype tolerance = 1e-8*(upper-lower);
+      if ((x < lower-tolerance) || (x > upper+tolerance))
+        return false;
+
+      c = std::min(std::max(coords.cellIndex(i,x),cells.min(i)),cells.max(i));
+      local = (x-coords.coordinate(i,c)) / coords.meshsize(i,c);
+      return true;
+    }
+
+    //! construct the element with given global cell coordinate on a grid level
+    typename Traits::template Codim<0>::Entity
+    makeElement (YGridLevelIterator g, const iTupel& coord) const
+    {
+      typedef typename Traits::template Codim<0>::Entity Entity;
+      typedef YaspEntity<0,dim,const YaspGrid> EntityImp;
+      typedef typename YGrid::Iterator YIterator;
+
+      return Entity(EntityImp(g,YIterator(g->overlapfront[0],coord)));
+    }
+
     CollectiveCommunicationType ccobj;
 
     Torus<CollectiveCommunicationType,dim> _torus;
@@ -1860,6 +2251,7 @@ namespace Dune {
       s << "[" << rank << "]:   " << std::endl;
       s << "[" << rank << "]:   " << "==========================================" << std::endl;
       s << "[" << rank << "]:   " << "level=" << g->level() << std::endl;
+      s << "[" << rank << "]:   " << "memory=" << grid.memoryUsage(g->level()) << " bytes" << std::endl;
 
       for (int codim = 0; codim < d + 1; ++codim)
       {
@@ -1868,46 +2260,59 @@ namespace Dune {
         s << "[" << rank << "]:   " << "interiorborder[" << codim << "]:    " << g->interiorborder[codim] << std::endl;
         s << "[" << rank << "]:   " << "interior[" << codim << "]:    " << g->interior[codim] << std::endl;
 
+        // only print the communication lists that have been built (building them is collective)
         typedef typename YGridList<CC>::Iterator I;
-        for (I i=g->send_overlapfront_overlapfront[codim].begin();
-                 i!=g->send_overlapfront_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_of_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_overlapfront[codim].begin();
-                 i!=g->recv_overlapfront_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " r_of_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_overlap_overlapfront[codim].begin();
-                 i!=g->send_overlap_overlapfront[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_o_of[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_overlap[codim].begin();
-                 i!=g->recv_overlapfront_overlap[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " r_of_o[" << codim << "] to rank "
-                   << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_interiorborder_interiorborder[codim].begin();
-                 i!=g->send_interiorborder_interiorborder[codim].end(); ++i)
-          s << "[" << rank << "]:    " << " s_ib_ib[" << codim << "] to rank "
-          << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_interiorborder_interiorborder[codim].begin();
-                 i!=g->recv_interiorborder_interiorborder[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " r_ib_ib[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->send_interiorborder_overlapfront[codim].begin();
-                 i!=g->send_interiorborder_overlapfront[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " s_ib_of[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
-
-        for (I i=g->recv_overlapfront_interiorborder[codim].begin();
-                 i!=g->recv_overlapfront_interiorborder[codim].end(); ++i)
-             s << "[" << rank << "]:    " << " r_of_ib[" << codim << "] to rank "
-             << i->rank << " " << i->grid << std::endl;
+        if (g->commListsBuilt[codim][3])
+        {
+          for (I i=g->send_overlapfront_overlapfront[codim].begin();
+                   i!=g->send_overlapfront_overlapfront[codim].end(); ++i)
+            s << "[" << rank << "]:    " << " s_of_of[" << codim << "] to rank "
+                     << i->rank << " " << i->grid << std::endl;
+
+          for (I i=g->recv_overlapfront_overlapfront[codim].begin();
+                   i!=g->recv_overlapfront_overlapfront[codim].end(); ++i)
+            s << "[" << rank << "]:    " << " r_of_of[" << codim << "] to rank "
+                     << i->rank << " " << i->grid << std::endl;
+        }
+
+        if (g->commListsBuilt[codim][2])
+        {
+          for (I i=g->send_overlap_overlapfront[codim].begin();
+                   i!=g->send_overlap_overlapfront[codim].end(); ++i)
+            s << "[" << rank << "]:    " << " s_o_of[" << codim << "] to rank "
+                     << i->rank << " " << i->grid << std::endl;
+
+          for (I i=g->recv_overlapfront_overlap[codim].begin();
+                   i!=g->recv_overlapfront_overlap[codim].end(); ++i)
+            s << "[" << rank << "]:    " << " r_of_o[" << codim << "] to rank "
+                     << i->rank << " " << i->grid << std::endl;
+        }
+
+        if (g->commListsBuilt[codim][0])
+        {
+          for (I i=g->send_interiorborder_interiorborder[codim].begin();
+                   i!=g->send_interiorborder_interiorborder[codim].end(); ++i)
+            s << "[" << rank << "]:    " << " s_ib_ib[" << codim << "] to rank "
+            << i->rank << " " << i->grid << std::endl;
+
+          for (I i=g->recv_interiorborder_interiorborder[codim].begin();
+                   i!=g->recv_interiorborder_interiorborder[codim].end(); ++i)
+               s << "[" << rank << "]:    " << " r_ib_ib[" << codim << "] to rank "
+               << i->rank << " " << i->grid << std::endl;
+        }
+
+        if (g->commListsBuilt[codim][1])
+        {
+          for (I i=g->send_interiorborder_overlapfront[codim].begin();
+                   i!=g->send_interiorborder_overlapfront[codim].end(); ++i)
+               s << "[" << rank << "]:    " << " s_ib_of[" << codim << "] to rank "
+               << i->rank << " " << i->grid << std::endl;
+
+          for (I i=g->recv_overlapfront_interiorborder[codim].begin();
+                   i!=g->recv_overlapfront_interiorborder[codim].end(); ++i)
+               s << "[" << rank << "]:    " << " r_of_ib[" << codim << "] to rank "
+               << i->rank << " " << i->grid << std::endl;
+        }
       }
     }
 
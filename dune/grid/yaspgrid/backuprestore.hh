@@ -10,6 +10,7 @@
 #include <dune/common/exceptions.hh>
 #include <dune/common/fvector.hh>
 #include <dune/grid/common/backuprestore.hh>
+#include <dune/grid/io/file/checkpointfile.hh>
 #include <dune/grid/yaspgrid.hh>
 
 // bump this version number up if you introduce any changes
@@ -73,6 +74,61 @@ namespace Dune
     }
   };
 
+  namespace Yasp
+  {
+    //! write the structure shared by all coordinate containers into a checkpoint file
+    template<class Grid, class Comm>
+    void backupStructure(const Grid& grid, CheckpointFileWriter<Comm>& writer)
+    {
+      writer.write(std::string("YaspGrid"));
+      writer.write(int(YASPGRID_BACKUPRESTORE_FORMAT_VERSION));
+      for (int i=0; i<Grid::dimension; i++)
+        writer.write(int(grid.torus().dims(i)));
+      writer.write(int(grid.maxLevel()));
+      for (int i=0; i<Grid::dimension; i++)
+        writer.write(char(grid.isPeriodic(i)));
+      writer.write(int(grid.overlapSize(0,0)));
+      for (typename Grid::YGridLevelIterator i=++grid.begin(); i != grid.end(); ++i)
+        writer.write(char(i->keepOverlap));
+      for (int i=0; i<Grid::dimension; i++)
+        writer.write(int(grid.levelSize(0,i)));
+    }
+
+    //! read the structure written by backupStructure
+    template<int dim, class Comm>
+    void restoreStructure(CheckpointFileReader<Comm>& reader, Dune::array<int,dim>& torus_dims,
+                          std::vector<bool>& physicalOverlapSize, std::bitset<dim>& periodic,
+                          int& overlap, Dune::array<int,dim>& coarseSize)
+    {
+      std::string tag;
+      int version;
+      reader.read(tag);
+      reader.read(version);
+      if ((tag != "YaspGrid") || (version != YASPGRID_BACKUPRESTORE_FORMAT_VERSION))
+        DUNE_THROW(Dune::IOError, "Checkpoint file does not contain a YaspGrid in the current format!");
+
+      for (int i=0; i<dim; i++)
+        reader.read(torus_dims[i]);
+      int refinement;
+      reader.read(refinement);
+      char b;
+      for (int i=0; i<dim; i++)
+      {
+        reader.read(b);
+        periodic[i] = b;
+      }
+      reader.read(overlap);
+      physicalOverlapSize.resize(refinement);
+      for (int i=0; i<refinement; ++i)
+      {
+        reader.read(b);
+        physicalOverlapSize[i] = b;
+      }
+      for (int i=0; i<dim; i++)
+        reader.read(coarseSize[i]);
+    }
+  } // namespace Yasp
+
   /** \copydoc Dune::BackupRestoreFacility */
   template<int dim, class Coordinates>
   struct BackupRestoreFacility<Dune::YaspGrid<dim, Coordinates> >
@@ -210,6 +266,58 @@ namespace Dune
 
       return grid;
     }
+
+    /** \brief write a binary backup of the grid into a checkpoint file
+     *
+     *  The grid is appended to the data of the writer, so user data, e.g.,
+     *  PersistentContainers, can be written after it. The file itself is
+     *  written collectively when the writer is closed.
+     */
+    static void backup ( const Grid &grid, CheckpointFileWriter<Comm> &writer )
+    {
+      Yasp::backupStructure(grid, writer);
+      for (int i=0; i<dim; i++)
+        writer.write(grid.begin()->coords.meshsize(i,0));
+      // the coordinate of the global index 0 is the origin of the grid
+      for (int i=0; i<dim; i++)
+        writer.write(grid.begin()->coords.coordinate(i,0));
+    }
+
+    /** \brief restore a grid from a checkpoint file
+     *
+     *  The grid is restored on the communicator of the reader, which must
+     *  have the same size as the one used for writing. User data written
+     *  after the grid can be read afterwards.
+     */
+    static Grid *restore ( CheckpointFileReader<Comm> &reader )
+    {
+      Dune::array<int,dim> torus_dims;
+      std::vector<bool> physicalOverlapSize;
+      std::bitset<dim> periodic;
+      int overlap;
+      Dune::array<int,dim> coarseSize;
+      Yasp::restoreStructure<dim>(reader, torus_dims, physicalOverlapSize, periodic, overlap, coarseSize);
+
+      Dune::FieldVector<ctype,dim> length, origin;
+      for (int i=0; i<dim; i++)
+      {
+        reader.read(length[i]);
+        length[i] *= coarseSize[i];
+      }
+      for (int i=0; i<dim; i++)
+        reader.read(origin[i]);
+
+      YaspFixedSizePartitioner<dim> lb(torus_dims);
+      Grid* grid = MaybeHaveOrigin<Coordinates>::createGrid(origin, length, coarseSize, periodic, overlap, reader.comm(), &lb);
+
+      for (std::size_t i=0; i<physicalOverlapSize.size(); ++i)
+      {
+        grid->refineOptions(physicalOverlapSize[i]);
+        grid->globalRefine(1);
+      }
+
+      return grid;
+    }
   };
 
   /** \copydoc Dune::BackupRestoreFacility */
@@ -351,6 +459,54 @@ namespace Dune
 
       return grid;
     }
+
+    /** \brief write a binary backup of the grid into a checkpoint file
+     *
+     *  Each process stores the coordinates of its part of the coarse grid.
+     *  User data, e.g., PersistentContainers, can be written after the grid.
+     */
+    static void backup ( const Grid &grid, CheckpointFileWriter<Comm> &writer )
+    {
+      Yasp::backupStructure(grid, writer);
+      const TensorProductCoordinates<ctype,dim>& cc = grid.begin()->coords;
+      for (int d=0; d<dim; d++)
+      {
+        std::vector<ctype> coords(cc.size(d)+1);
+        for (std::size_t i=0; i<coords.size(); i++)
+          coords[i] = cc.coordinate(d, cc.offset(d)+i);
+        writer.write(coords);
+      }
+    }
+
+    /** \brief restore a grid from a checkpoint file
+     *
+     *  The grid is restored on the communicator of the reader, which must
+     *  have the same size as the one used for writing.
+     */
+    static Grid *restore ( CheckpointFileReader<Comm> &reader )
+    {
+      Dune::array<int,dim> torus_dims;
+      std::vector<bool> physicalOverlapSize;
+      std::bitset<dim> periodic;
+      int overlap;
+      Dune::array<int,dim> coarseSize;
+      Yasp::restoreStructure<dim>(reader, torus_dims, physicalOverlapSize, periodic, overlap, coarseSize);
+
+      Dune::array<std::vector<ctype>,dim> coords;
+      for (int d=0; d<dim; d++)
+        reader.read(coords[d]);
+
+      YaspFixedSizePartitioner<dim> lb(torus_dims);
+      Grid* grid = new Grid(coords, periodic, overlap, reader.comm(), coarseSize, &lb);
+
+      for (std::size_t i=0; i<physicalOverlapSize.size(); ++i)
+      {
+        grid->refineOptions(physicalOverlapSize[i]);
+        grid->globalRefine(1);
+      }
+
+      return grid;
+    }
   };
 } // namespace Dune
 
@@ -3,7 +3,9 @@
 #ifndef DUNE_GRID_YASPGRID_COORDINATES_HH
 #define DUNE_GRID_YASPGRID_COORDINATES_HH
 
+#include <algorithm>
 #include <bitset>
+#include <cmath>
 #include <vector>
 
 #include <dune/common/array.hh>
@@ -61,6 +63,16 @@ namespace Dune
       return i*_h[d];
     }
 
+    /** \returns the global index of the cell containing a coordinate in a given direction
+     *  \param d the direction to be used
+     *  \param x the coordinate in direction d
+     *  \note The returned index might be out of the range covered by this container.
+     */
+    inline int cellIndex(int d, ct x) const
+    {
+      return int(std::floor(x / _h[d]));
+    }
+
     /** \returns the size in given direction
      *  \param d the direction to be used
      */
@@ -160,6 +172,16 @@ namespace Dune
        return _origin[d] + i*_h[d];
      }
 
+     /** \returns the global index of the cell containing a coordinate in a given direction
+      *  \param d the direction to be used
+      *  \param x the coordinate in direction d
+      *  \note The returned index might be out of the range covered by this container.
+      */
+     inline int cellIndex(int d, ct x) const
+     {
+       return int(std::floor((x - _origin[d]) / _h[d]));
+     }
+
      /** \returns the size in given direction
       *  \param d the direction to be used
       */
@@ -269,6 +291,17 @@ namespace Dune
       return _c[d][i-_offset[d]];
     }
 
+    /** \returns the global index of the cell containing a coordinate in a given direction
+     *  \param d the direction to be used
+     *  \param x the coordinate in direction d
+     *  \note The cell is found by a binary search. The returned index might
+     *        be out of the range covered by this container.
+     */
+    inline int cellIndex(int d, ct x) const
+    {
+      return int(std::upper_bound(_c[d].begin(), _c[d].end(), x) - _c[d].begin()) - 1 + _offset[d];
+    }
+
     /** \returns the size in given direction
      *  \param d the direction to be used
      */
@@ -277,6 +310,14 @@ namespace Dune
       return _c[d].size() - 1;
     }
 
+    /** \returns the global index of the first coordinate in given direction
+     *  \param d the direction to be used
+     */
+    inline int offset(int d) const
+    {
+      return _offset[d];
+    }
+
     /** \returns a container that represents the same grid after one step of uniform refinement
      *  \param ovlp_low whether we have an overlap area at the lower processor boundary
      *  \param ovlp_up whether we have an overlap area at the upper processor boundary
@@ -0,0 +1,80 @@
+// -*- tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi: set et ts=4 sw=2 sts=2:
+#ifndef DUNE_GRID_YASPGRID_INDEXBOX_HH
+#define DUNE_GRID_YASPGRID_INDEXBOX_HH
+
+#include <array>
+#include <bitset>
+
+/** \file
+ *  \brief the YaspIndexBox class describing the level indices of a block of structured entities
+ */
+
+namespace Dune {
+
+  /** \brief A box of entities of one orientation on a YaspGrid level and their level indices
+   *
+   *  YaspGrid stores the entities of a codimension as one structured block
+   *  per shift vector (the unit vectors spanning the entity).  Within such a
+   *  block the level index of the entity with global coordinate x is
+   *
+   *    offset + sum_i (x[i] - origin[i]) * stride[i],
+   *
+   *  with stride[0] == 1.  This allows loops over cells and faces that index
+   *  level-index-set-ordered data directly, without creating entities or
+   *  intersections:  along direction 0 the indices are consecutive, and the
+   *  neighbor of a cell in direction i has the index +/- stride[i] of the
+   *  cell box.  The face between the cells x-e_i and x has the global
+   *  coordinate x in the face box with shift ~e_i.
+   *
+   *  The boxes are obtained by YaspGrid::indexBoxes and YaspGrid::indexBox.
+   *  Boxes of a partition smaller than All_Partition cover a subset of the
+   *  entities of the corresponding All_Partition box and share its indices.
+   */
+  template<int dim>
+  struct YaspIndexBox
+  {
+    typedef std::array<int,dim> iTupel;
+
+    //! the unit vectors spanning the entities in the box
+    std::bitset<dim> shift;
+    //! global coordinate of the first entity
+    iTupel origin;
+    //! number of entities per direction
+    iTupel size;
+    //! level index of the entity at origin
+    int offset;
+    //! level index increment per direction
+    iTupel stride;
+
+    //! level index of the entity with global coordinate coord
+    int index (const iTupel& coord) const
+    {
+      int index = offset;
+      for (int i=0; i<dim; i++)
+        index += (coord[i] - origin[i]) * stride[i];
+      return index;
+    }
+
+    //! return true if the entity with global coordinate coord is in the box
+    bool contains (const iTupel& coord) const
+    {
+      for (int i=0; i<dim; i++)
+        if (coord[i] < origin[i] || coord[i] >= origin[i] + size[i])
+          return false;
+      return true;
+    }
+
+    //! number of entities in the box
+    int totalsize () const
+    {
+      int s = 1;
+      for (int i=0; i<dim; i++)
+        s *= size[i];
+      return s;
+    }
+  };
+
+} // namespace Dune
+
+#endif // DUNE_GRID_YASPGRID_INDEXBOX_HH
@@ -27,145 +27,126 @@ namespace Dune {
 
 #ifndef DOXYGEN
 
-    // table for quick evaluation of binomial coefficients
-    template<int n>
-    struct BinomialTable
+    //! binomial coefficient d choose c
+    constexpr int binomial(int d, int c)
     {
-      static void init()
-      {
-        if (_initialized)
-          return;
-        int offset = 0;
-        for (int d = 0; d <= n; ++d)
-          {
-            _offsets[d] = offset;
-            for (int c = 0; c <= d; ++c, ++offset)
-              _values[offset] = binomial(d,c);
-          }
-        _initialized = true;
-      }
-
-      // evaluation - note that in general d!=n, n is only the
-      // maximum value of d (in our case dimworld)
-      static int evaluate(int d, int c)
-      {
-        return _values[_offsets[d] + c];
-      }
-
-    private:
-      // prevent construction
-      BinomialTable();
-
-      static bool _initialized;
-      static std::array<int,(n+1)*(n+2)/2> _values;
-      static std::array<int,n+1> _offsets;
-
-    public:
-
-      // the actual implementation
-      static int binomial(int d, int c)
-      {
-        long binomial=1;
-        for (int i=d-c+1; i<=d; i++)
-          binomial *= i;
-        for (long i=2; i<=c; i++)
-          binomial /= i;
-        return binomial;
-      }
-    };
-
-    template<int n>
-    bool BinomialTable<n>::_initialized = false;
-    template<int n>
-    std::array<int,(n+1)*(n+2)/2> BinomialTable<n>::_values;
-    template<int n>
-    std::array<int,n+1> BinomialTable<n>::_offsets;
+      return (c < 0 || c > d) ? 0 : (c == 0 ? 1 : binomial(d-1,c-1) * d / c);
+    }
 
     /** \returns number of subentities of given codim in a cube of dimension dim
-     *  \tparam dimworld the maximum dimension the table holds entries for
      *  \param d the dimension of the cube
      *  \param c the codimension we are interested in
      *  That number is d choose c times 2^c.
      */
-    template<int dimworld>
-    int subEnt(int d, int c)
+    constexpr int subEnt(int d, int c)
+    {
+      return (d < c ? 0 : binomial(d,c) << c);
+    }
+
+    //! position of the first subentity of codim c in the table of all subentities of a d-cube
+    constexpr int subEntOffset(int d, int c)
+    {
+      return (c <= 0 ? 0 : subEntOffset(d,c-1) + subEnt(d,c-1));
+    }
+
+    // the actual shift calculation, only used to fill SubEntityTable
+    template<int dim>
+    unsigned char calculateEntityShift(int index, int cc)
     {
-      return (d < c ? 0 : BinomialTable<dimworld>::evaluate(d,c) << c);
+      unsigned char result = 0;
+      for (int d = dim; d>0; d--)
+        {
+          if (cc == d)
+            return result;
+          if (index < subEnt(d-1,cc))
+            result |= (1<<(d-1));
+          else
+            {
+              index = (index - subEnt(d-1, cc)) % subEnt(d-1,cc-1);
+              cc--;
+            }
+        }
+      return result;
     }
 
-    // Make a table mapping all subentities of a codim 0 entity to a value.
-    // F is the functor to be evaluated.
-    template<typename F, int dim>
-    struct EntityShiftTable
+    // the actual move calculation, only used to fill SubEntityTable
+    template<int dim>
+    unsigned char calculateEntityMove(int index, int cc)
     {
+      unsigned char result = 0;
+      for (int d = dim; d>0; d--)
+        {
+          if (d == cc)
+            {
+              if (index & (1<<(d-1)))
+                result |= (1<<(d-1));
+              index &= ~(1<<(d-1));
+            }
+          if (index >= subEnt(d-1,cc))
+            {
+              if ((index - subEnt(d-1,cc)) / subEnt(d-1,cc-1) == 1)
+                result |= (1<<(d-1));
+              index = (index - subEnt(d-1, cc)) % subEnt(d-1,cc-1);
+              cc--;
+            }
+        }
+      return result;
+    }
 
-      typedef std::bitset<dim> value_type;
+    /** table of shift and move vectors of all subentities of a dim-cube
+     *
+     *  The vectors are stored as bit masks in two flat arrays indexed by
+     *  subEntOffset(dim,cc) + i, so a lookup costs one load.  init() has
+     *  to be called before the first lookup; it also fills the tables of
+     *  all lower dimensions, which the subentities of codim>0 entities use.
+     */
+    template<int dim>
+    struct SubEntityTable
+    {
+      static const int size = StaticPower<3,dim>::power;
 
       static void init()
       {
         if (_initialized)
           return;
-        F f;
-        int offset = 0;
-        for (int codim = 0; codim <= dim; ++codim)
-          {
-            _offsets[codim] = offset;
-            for (int i = 0; i < subEnt<dim>(dim,codim); ++i, ++offset)
-              _values[offset] = static_cast<unsigned char>(f(i,codim).to_ulong());
-          }
+        if (dim > 1)
+          SubEntityTable<(dim > 1 ? dim-1 : 1)>::init();
+        for (int cc = 0; cc <= dim; ++cc)
+          for (int i = 0; i < subEnt(dim,cc); ++i)
+            {
+              _shift[subEntOffset(dim,cc) + i] = calculateEntityShift<dim>(i,cc);
+              _move[subEntOffset(dim,cc) + i] = calculateEntityMove<dim>(i,cc);
+            }
         _initialized = true;
       }
 
-      static value_type evaluate(int i, int codim)
+      //! shift vector of subentity i of codim cc as bit mask
+      static unsigned int shift(int i, int cc)
       {
-        return {_values[_offsets[codim] + i]};
+        return _shift[subEntOffset(dim,cc) + i];
       }
 
-    private:
+      //! move vector of subentity i of codim cc as bit mask
+      static unsigned int move(int i, int cc)
+      {
+        return _move[subEntOffset(dim,cc) + i];
+      }
 
+    private:
       // prevent construction
-      EntityShiftTable();
+      SubEntityTable();
 
       static bool _initialized;
-      static std::array<int,dim+1> _offsets;
-      static std::array<unsigned char,StaticPower<3,dim>::power> _values;
-
+      static std::array<unsigned char,size> _shift;
+      static std::array<unsigned char,size> _move;
     };
 
-    template<typename F, int dim>
-    bool EntityShiftTable<F,dim>::_initialized = false;
-    template<typename F, int dim>
-    std::array<int,dim+1> EntityShiftTable<F,dim>::_offsets;
-    template<typename F, int dim>
-    std::array<unsigned char,StaticPower<3,dim>::power> EntityShiftTable<F,dim>::_values;
-
-    // functor for doing the actual entity shift calculation
     template<int dim>
-    struct calculate_entity_shift
-    {
-      calculate_entity_shift()
-      {
-        BinomialTable<dim>::init();
-      }
-
-      std::bitset<dim> operator()(int index, int cc) const
-      {
-        std::bitset<dim> result(0ull);
-        for (int d = dim; d>0; d--)
-          {
-            if (cc == d)
-              return result;
-            if (index < subEnt<dim>(d-1,cc))
-              result[d-1]=true;
-            else
-              {
-                index = (index - subEnt<dim>(d-1, cc)) % subEnt<dim>(d-1,cc-1);
-                cc--;
-              }
-          }
-        return result;
-      }
-    };
+    bool SubEntityTable<dim>::_initialized = false;
+    template<int dim>
+    std::array<unsigned char,SubEntityTable<dim>::size> SubEntityTable<dim>::_shift;
+    template<int dim>
+    std::array<unsigned char,SubEntityTable<dim>::size> SubEntityTable<dim>::_move;
 
     /** \returns a shift vector as used by YGridComponent
      * \param index subentity index
@@ -178,44 +159,9 @@ namespace Dune {
     template<int dim>
     std::bitset<dim> entityShift(int index, int cc)
     {
-      return EntityShiftTable<calculate_entity_shift<dim>,dim>::evaluate(index,cc);
+      return std::bitset<dim>(SubEntityTable<dim>::shift(index,cc));
     }
 
-    // functor for doing the actual entity move calculation
-    template<int dim>
-    struct calculate_entity_move
-    {
-
-      calculate_entity_move()
-      {
-        BinomialTable<dim>::init();
-      }
-
-      std::bitset<dim> operator()(int index, int cc) const
-      {
-        std::bitset<dim> result(0ull);
-        for (int d = dim; d>0; d--)
-          {
-            if (d == cc)
-              {
-                result[d-1] = index & (1<<(d-1));
-                index &= ~(1<<(d-1));
-              }
-            if (index >= subEnt<dim>(d-1,cc))
-              {
-                if ((index - subEnt<dim>(d-1,cc)) / subEnt<dim>(d-1,cc-1) == 1)
-                  {
-                    result[d-1] = true;
-                  }
-                index = (index - subEnt<dim>(d-1, cc)) % subEnt<dim>(d-1,cc-1);
-                cc--;
-              }
-          }
-        return result;
-      }
-
-    };
-
     /** \returns a bitset telling in which direction to move a cell to get
      *    the cell a given entity is living on.
      *  \param index subentity index
@@ -226,7 +172,7 @@ namespace Dune {
     template<int dim>
     std::bitset<dim> entityMove(int index, int cc)
     {
-      return EntityShiftTable<calculate_entity_move<dim>,dim>::evaluate(index,cc);
+      return std::bitset<dim>(SubEntityTable<dim>::move(index,cc));
     }
 
 #endif //DOXYGEN
@@ -505,7 +451,7 @@ namespace Dune {
      */
     template<int cc> int count () const
     {
-      return Dune::Yasp::subEnt<dim>(dim,cc);
+      return Dune::Yasp::subEnt(dim,cc);
     }
 
     /*! Return number of subentities with codimension cc.
@@ -514,7 +460,7 @@ namespace Dune {
      */
     unsigned int subEntities (unsigned int codim) const
     {
-      return Dune::Yasp::subEnt<dim>(dim,codim);
+      return Dune::Yasp::subEnt(dim,codim);
     }
 
     /*! Intra-element access to subentities of codimension cc > codim.
@@ -742,20 +688,41 @@ namespace Dune {
     int subCompressedIndex (int i, int cc) const
     {
       // get shift and move of the subentity in question
-      std::bitset<dim> shift = Dune::Yasp::entityShift<dim>(i,cc);
-      std::bitset<dim> move = Dune::Yasp::entityMove<dim>(i,cc);
+      const unsigned int shift = Dune::Yasp::SubEntityTable<dim>::shift(i,cc);
+      const unsigned int move = Dune::Yasp::SubEntityTable<dim>::move(i,cc);
 
-      Dune::array<int,dim> size = _g->mg->levelSize(_g->level());
-      Dune::array<int, dim> coord = _it.coord();
-      for (int j=0; j<dim; j++)
-      {
+      const int which = _g->overlapfront[cc].shiftmapping(shift);
+      return _g->overlapfront[cc].superindex(_it.coord(),which) + moveOffset(move,which,cc);
+    }
+
+    //! compressed indices of all subentities of codim cc
+    template<class OutputIterator>
+    void subCompressedIndices (int cc, OutputIterator out) const
+    {
+      // the subentities with the same shift vector share the index of
+      // their component at the coordinate of this cell
+      const int components = _g->overlapfront[cc].dataEnd() - _g->overlapfront[cc].dataBegin();
+      int base[StaticPower<2,dim>::power];
+      for (int which = 0; which < components; ++which)
+        base[which] = _g->overlapfront[cc].superindex(_it.coord(),which);
 
-        size[j] += !shift[j];
-        coord[j] += move[j];
+      for (int i = 0; i < Dune::Yasp::subEnt(dim,cc); ++i, ++out)
+      {
+        const unsigned int shift = Dune::Yasp::SubEntityTable<dim>::shift(i,cc);
+        const unsigned int move = Dune::Yasp::SubEntityTable<dim>::move(i,cc);
+        const int which = _g->overlapfront[cc].shiftmapping(shift);
+        *out = base[which] + moveOffset(move,which,cc);
       }
+    }
 
-      int which = _g->overlapfront[cc].shiftmapping(shift);
-      return _g->overlapfront[cc].superindex(coord,which);
+    // index distance from this cell to the cell a subentity lives on
+    int moveOffset (unsigned int move, int which, int cc) const
+    {
+      int offset = 0;
+      for (int j=0; move; ++j, move >>= 1)
+        if (move & 1)
+          offset += (_g->overlapfront[cc].dataBegin()+which)->superincrement(j);
+      return offset;
     }
 
     I _it;         // position in the grid level
@@ -71,6 +71,20 @@ namespace Dune {
         return grid.getRealImplementation(e).subCompressedIndex(i,codim);
     }
 
+    /** \brief get the indices of all subentities of given codimension of an element
+     *
+     *  Writes e.subEntities(codim) indices to out, ordered like the
+     *  subentities of the reference element.  This is equivalent to calling
+     *  subIndex(e,i,codim) for all i, but shares the index computation
+     *  between subentities of the same orientation.
+     */
+    template<class OutputIterator>
+    void subIndices ( const typename remove_const< GridImp >::type::Traits::template Codim< 0 >::Entity &e,
+                      unsigned int codim, OutputIterator out ) const
+    {
+      grid.getRealImplementation(e).subCompressedIndices(codim,out);
+    }
+
     //! get number of entities of given type and level (the level is known to the object)
     int size (GeometryType type) const
     {
@@ -37,22 +37,9 @@ namespace Dune {
     typedef typename GridImp::template Codim<1>::LocalGeometry LocalGeometry;
 
     void update() {
-
-      // vector with per-direction movements
-      std::array<int,dim> dist{{0}};
-
-      // first move: back to center
-      dist[_dir] = 1 - 2*_face;
-
-      // update face info
+      // update face info, the outside entity is only built on request
       _dir = _count / 2;
       _face = _count % 2;
-
-      // second move: to new neighbor
-      dist[_dir] += -1 + 2*_face;
-
-      // move transforming iterator
-      _outside.transformingsubiterator().move(dist);
     }
 
     /*! return true if we are on the boundary of the domain
@@ -62,12 +49,8 @@ namespace Dune {
     {
       // Coordinate of intersection in its direction
       int coord = _inside.transformingsubiterator().coord(_dir) + _face;
-      if (_inside.gridlevel()->mg->isPeriodic(_dir))
-        return false;
-      else
-        return coord == 0
-               ||
-               coord == _inside.gridlevel()->mg->levelSize(_inside.gridlevel()->level(),_dir);
+      const typename GridImp::YGridLevel& g = *_inside.gridlevel();
+      return coord == g.lowerBoundary[_dir] || coord == g.upperBoundary[_dir];
     }
 
     //! return true if neighbor across intersection exists in this processor
@@ -75,9 +58,8 @@ namespace Dune {
     {
       // Coordinate of intersection in its direction
       int coord = _inside.transformingsubiterator().coord(_dir) + _face;
-      return coord > _inside.gridlevel()->overlap[0].dataBegin()->min(_dir)
-             &&
-             coord <= _inside.gridlevel()->overlap[0].dataBegin()->max(_dir);
+      const typename GridImp::YGridLevel& g = *_inside.gridlevel();
+      return coord > g.neighborBegin[_dir] && coord <= g.neighborEnd[_dir];
     }
 
     //! Yasp is always conform
@@ -96,7 +78,9 @@ namespace Dune {
     //! return EntityPointer to the Entity on the outside of this intersection
     Entity outside() const
     {
-      return Entity(_outside);
+      I it(_inside.transformingsubiterator());
+      it.move(_dir,2*_face-1);
+      return Entity(YaspEntity<0,GridImp::dimension,GridImp>(_inside.gridlevel(),std::move(it)));
     }
 
 #if DUNE_GRID_EXPERIMENTAL_GRID_EXTENSIONS
@@ -115,58 +99,14 @@ namespace Dune {
     {
       if(! boundary())
         DUNE_THROW(GridError, "called boundarySegmentIndex while boundary() == false");
-      // size of local macro grid
-      const Dune::array<int, dim> & size = _inside.gridlevel()->mg->begin()->overlap[0].dataBegin()->size();
-      const Dune::array<int, dim> & origin = _inside.gridlevel()->mg->begin()->overlap[0].dataBegin()->origin();
-      Dune::array<int, dim> sides;
-      {
-        for (int i=0; i<dim; i++)
-        {
-          sides[i] =
-            ((_inside.gridlevel()->mg->begin()->overlap[0].dataBegin()->origin(i)
-              == 0)+
-            (_inside.gridlevel()->mg->begin()->overlap[0].dataBegin()->origin(i) +
-                      _inside.gridlevel()->mg->begin()->overlap[0].dataBegin()->size(i)
-                      ==
-                      _inside.gridlevel()->mg->levelSize(0,i)));
-
-        }
-      }
-      // global position of the cell on macro grid
-      Dune::array<int, dim> pos = _inside.transformingsubiterator().coord();
-      for(int i=0; i<dim; i++)
-      {
-        pos[i] = pos[i] / (1<<_inside.level());
-        pos[i] = pos[i] - origin[i];
-      }
-      // compute unit-cube-face-sizes
-      Dune::array<int, dim> fsize;
-      {
-        int vol = 1;
-        for (int k=0; k<dim; k++)
-          vol *= size[k];
-        for (int k=0; k<dim; k++)
-          fsize[k] = vol/size[k];
-      }
-      // compute index in the unit-cube-face
-      int index = 0;
-      {
-        int localoffset = 1;
-        for (int k=dim-1; k>=0; k--)
-        {
-          if (k == _dir) continue;
-          index += (pos[k]) * localoffset;
-          localoffset *= size[k];
-        }
-      }
-      // add unit-cube-face-offsets
-      {
-        for (int k=0; k<_dir; k++)
-          index += sides[k] * fsize[k];
-        // add fsize if we are on the right face and there is a left-face-boundary on this processor
-        index += _face * (sides[_dir]>1) * fsize[_dir];
-      }
 
+      // position of the cell on the macro grid, weighted with the
+      // precomputed strides of the boundary segments on this face
+      const typename GridImp::YGridLevel& g = *_inside.gridlevel();
+      const int scale = 1 << g.level();
+      int index = g.bSegmentOffset[_count];
+      for (int k=0; k<dim; k++)
+        index += (_inside.transformingsubiterator().coord(k) / scale) * g.bSegmentStride[_dir][k];
       return index;
     }
 
@@ -194,7 +134,7 @@ namespace Dune {
     FieldVector<ctype, dimworld> integrationOuterNormal (const FieldVector<ctype, dim-1>& local) const
     {
       FieldVector<ctype, dimworld> n = _faceInfo[_count].normal;
-      n *= geometry().volume();
+      n *= volume();
       return n;
     }
 
@@ -240,6 +180,16 @@ namespace Dune {
       return Geometry( _is_global );
     }
 
+    //! volume of the intersection, computed from the mesh sizes without building the geometry
+    ctype volume () const
+    {
+      ctype volume = 1.0;
+      for (int i=0; i<dim; i++)
+        if (i != _dir)
+          volume *= _inside.transformingsubiterator().coordCont()->meshsize(i,_inside.transformingsubiterator().coord(i));
+      return volume;
+    }
+
     /** \brief obtain the type of reference element for this intersection */
     GeometryType type () const
     {
@@ -269,24 +219,11 @@ namespace Dune {
     YaspIntersection (const YaspEntity<0,dim,GridImp>& myself, bool toend) :
       _inside(myself.gridlevel(),
               myself.transformingsubiterator()),
-      _outside(myself.gridlevel(),
-               myself.transformingsubiterator()),
-      // initialize to first neighbor
-      _count(0),
+      // initialize to first neighbor or to the end
+      _count(toend ? 2*dim : 0),
       _dir(0),
       _face(0)
-    {
-      if (toend)
-      {
-        // initialize end iterator
-        _count = 2*dim;
-        return;
-      }
-      _count = 0;
-
-      // move transforming iterator
-      _outside.transformingsubiterator().move(_dir,-1);
-    }
+    {}
 
     //! copy constructor -- use default
 
@@ -303,9 +240,7 @@ namespace Dune {
     }
 
   private:
-    /* EntityPointers (get automatically updated) */
-    YaspEntity<0,GridImp::dimension,GridImp> _inside;  //!< entitypointer to myself
-    YaspEntity<0,GridImp::dimension,GridImp> _outside; //!< outside entitypointer
+    YaspEntity<0,GridImp::dimension,GridImp> _inside;  //!< the element where we started
     /* current position */
     uint8_t _count;                                //!< valid neighbor count in 0 .. 2*dim-1
     uint8_t _dir;                                  //!< count/2
@@ -5,7 +5,6 @@
 
 #include <vector>
 #include <bitset>
-#include <deque>
 
 #include <dune/common/array.hh>
 #include <dune/common/fvector.hh>
@@ -566,6 +565,12 @@ namespace Dune {
       return _shiftmapping[shift.to_ulong()];
     }
 
+    //! get which component belongs to a shift vector given as bit mask
+    int shiftmapping(unsigned int shift) const
+    {
+      return _shiftmapping[shift];
+    }
+
     //! get start iterator in the data array
     DAI dataBegin() const
     {
@@ -764,6 +769,13 @@ namespace Dune {
       return _indexOffset[which] + (dataBegin()+which)->superindex(coord);
     }
 
+    //! return the number of bytes allocated on the heap by this ygrid (the components are not owned)
+    std::size_t memoryUsage() const
+    {
+      return (_itbegins.capacity() + _itends.capacity()) * sizeof(typename YGridComponent<Coordinates>::Iterator)
+        + _indexOffset.capacity() * sizeof(int);
+    }
+
 
     // finalize the ygrid construction by storing component iterators
     void finalize(const DAI& end, int artificialOffset = 0)
@@ -809,10 +821,10 @@ namespace Dune {
     return s;
   }
 
-  /** \brief implements a collection of multiple std::deque<Intersection>
-   * Intersections with neighboring processors are stored as std::deque<Intersection>.
+  /** \brief implements a collection of multiple std::vector<Intersection>
+   * Intersections with neighboring processors are stored as std::vector<Intersection>.
    * Eachsuch intersection only holds one YGridComponent. To do all communication
-   * associated with one codimension, multiple such deques have to be concatenated.
+   * associated with one codimension, multiple such vectors have to be concatenated.
    * YGridList manges this concatenation. As for YGrids, YGridList doesnt hold any
    * data, but an iterator range into a data array owned by YGridLevel.
    */
@@ -836,9 +848,9 @@ namespace Dune {
     };
 
     // define data array iterator type
-    typedef typename Dune::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator DAI;
+    typedef typename Dune::array<std::vector<Intersection>, StaticPower<2,dim>::power>::iterator DAI;
 
-    // iterator that allows to iterate over a concatenation of deques. namely those
+    // iterator that allows to iterate over a concatenation of vectors. namely those
     // that belong to the same codimension.
     class Iterator
     {
@@ -850,7 +862,7 @@ namespace Dune {
         _it = _which->begin();
 
         // advance the iterator to the first element that exists.
-        // some deques might be empty and should be skipped
+        // some vectors might be empty and should be skipped
         while ((_which != _end) && (_it == _which->end()))
         {
           ++_which;
@@ -869,7 +881,7 @@ namespace Dune {
       {
         ++_it;
         // advance the iterator to the next element that exists.
-        // some deques might be empty and should be skipped
+        // some vectors might be empty and should be skipped
         while ((_which != _end) && (_it == _which->end()))
         {
           ++_which;
@@ -880,13 +892,13 @@ namespace Dune {
       }
 
       //! dereference iterator
-      typename std::deque<Intersection>::iterator  operator->() const
+      typename std::vector<Intersection>::iterator  operator->() const
       {
         return _it;
       }
 
       //! dereference iterator
-      typename std::deque<Intersection>::iterator  operator*() const
+      typename std::vector<Intersection>::iterator  operator*() const
       {
         return _it;
       }
@@ -912,7 +924,7 @@ namespace Dune {
       }
 
       private:
-      typename std::deque<Intersection>::iterator _it;
+      typename std::vector<Intersection>::iterator _it;
       DAI _end;
       DAI _which;
     };
@@ -930,7 +942,7 @@ namespace Dune {
     }
 
     //! set start iterator in the data array
-    void setBegin(typename Dune::array<std::deque<Intersection>, StaticPower<2,dim>::power>::iterator begin)
+    void setBegin(typename Dune::array<std::vector<Intersection>, StaticPower<2,dim>::power>::iterator begin)
     {
       _begin = begin;
     }
@@ -947,7 +959,7 @@ namespace Dune {
       return _end;
     }
 
-    //! return the size of the container, this is the sum of the sizes of all deques
+    //! return the size of the container, this is the sum of the sizes of all vectors
     int size() const
     {
       int count = 0;
@@ -959,9 +971,9 @@ namespace Dune {
     //! finalize the YGridLIst
     void finalize(DAI end, const YGrid<Coordinates>& ygrid)
     {
-      // Instead of directly iterating over the intersection deques, this code
+      // Instead of directly iterating over the intersection vectors, this code
       // iterates over the components of an associated ygrid and works its way
-      // through the list of intersection deques in parallel.
+      // through the list of intersection vectors in parallel.
       // The reason for this convoluted iteration technique is that there are not
       // necessarily intersections for all possible shifts, but we have to make
       // sure that we stop at each shift to update the the per-component index shift
@@ -976,7 +988,7 @@ namespace Dune {
 
       DAI i = _begin;
 
-      // make sure that we have a valid deque (i.e. a non-empty one)
+      // make sure that we have a valid vector (i.e. a non-empty one)
       while (i != _end && i->begin() == i->end())
         ++i;
 
@@ -987,14 +999,14 @@ namespace Dune {
         auto it = i->begin();
         if (it->grid.shift() == yit->shift())
         {
-          // iterate over the intersections in the deque and set the offset
+          // iterate over the intersections in the vector and set the offset
           for (; it != i->end(); ++it)
           {
             it->yg.setBegin(&(it->grid));
             it->yg.finalize(&(it->grid)+1, offset);
           }
 
-          // advance to next non-empty deque
+          // advance to next non-empty vector
           ++i;
           while (i != _end && i->begin() == i->end())
             ++i;
@@ -10,6 +10,10 @@ AC_DEFUN([DUNE_GRID_CHECKS],[
   AC_REQUIRE([DUNE_PATH_ALUGRID])
   AC_REQUIRE([DUNE_EXPERIMENTAL_GRID_EXTENSIONS])
 
+  # some installed headers use std::thread, so every user of dune-grid
+  # has to link with -pthread
+  DUNE_ADD_ALL_PKG([Threads], [], [-pthread], [])
+
   DUNE_DEFINE_GRIDTYPE([ONEDGRID],[(GRIDDIM == 1) && (WORLDDIM == 1)],[Dune::OneDGrid],[dune/grid/onedgrid.hh],[dune/grid/io/file/dgfparser/dgfoned.hh])
   DUNE_DEFINE_GRIDTYPE([SGRID],[],[Dune::SGrid< dimgrid, dimworld >],[dune/grid/sgrid.hh],[dune/grid/io/file/dgfparser/dgfs.hh])
   DUNE_DEFINE_GRIDTYPE([YASPGRID],[GRIDDIM == WORLDDIM],[Dune::YaspGrid< dimgrid >],[dune/grid/yaspgrid.hh],[dune/grid/io/file/dgfparser/dgfyasp.hh])